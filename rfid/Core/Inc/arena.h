@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    arena.h
+  * @brief   Subsystem RAM arenas.
+  * Every large buffer lives in the fixed RAM region of the subsystem that
+  * owns it (ARENA_* regions in the linker script). A subsystem that outgrows
+  * its budget fails the link with "region `ARENA_x' overflowed", and the
+  * --print-memory-usage table of each link is the budget report. Arena
+  * memory is zeroed at reset like .bss.
+  *
+  * RAMFUNC code is copied from flash to its own RAM region at reset. Flash
+  * runs with 2 wait states and the ART cache only hides them for code that
+  * stays resident; interrupt paths that run once per block miss it and
+  * their timing varies with what ran before. From SRAM they run at a fixed
+  * cost. Calls out to flash go through linker veneers.
+  ******************************************************************************
+  */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+// Place a static buffer in an arena: static uint16_t pool[N] ARENA_WAVE;
+#define ARENA_WAVE     __attribute__((section(".bss.arena_wave")))     // Emulation timelines
+#define ARENA_RF       __attribute__((section(".bss.arena_rf")))       // Capture, replay and writer DMA
+#define ARENA_STORAGE  __attribute__((section(".bss.arena_storage")))  // Uncommitted records
+#define ARENA_UI       __attribute__((section(".bss.arena_ui")))       // Signal list and search
+
+// Build with -DHOT_CODE_IN_RAM=0 to run the RAMFUNC paths from flash (timing comparison).
+//
+// Comparing: flash both builds, put the same EM4100 fob on the coil, open the
+// sniffer and let it read for 30 s (~15000 blocks). Save nothing in that time:
+// flash programming stalls every fetch from flash in both builds. Then read
+// the diagnostics page. "CY RF" and "DM" are the best cost plus the jitter
+// (max - min) of one capture block and of one decoded edge. "RF BLOCK MAX US"
+// is the worst block.
+//
+// Expected, from the code sizes rather than from a board. The RF block path
+// (DcBlock, Decimate, Slice, Track_Runs) is ~0.7 KB, or ~45 ART lines of 16 B.
+// It costs ~5-6k cycles steady. From flash, a block that follows a redraw
+// refills those lines at 2 wait states each: jitter up to ~150 cycles
+// (~2 us). From RAM that part of the jitter goes away. The best cost rises
+// 5-15%, because code and data then share the one SRAM port (no CCM on the
+// F401). The decoders are ~1.5 KB and cost a few hundred cycles per edge. The
+// UI evicts them between passes, so from flash their jitter is the same size
+// as their cost. Keep the default only while the RAM build's RF and DM worst
+// case stays at or below the flash build's. Otherwise set it to 0 and give
+// the RAMFUNC region back to RAM.
+#if !defined(HOT_CODE_IN_RAM)
+#define HOT_CODE_IN_RAM 1
+#endif
+
+// Run a function from RAM: RAMFUNC void RF_Frontend_IRQHandler(void) { ... }
+#if HOT_CODE_IN_RAM
+#define RAMFUNC        __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+// Keep a variable across resets (not zeroed at startup): static Record rec NOINIT;
+#define NOINIT         __attribute__((section(".noinit")))
+
+#endif // ARENA_H
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    clocks.h
+  * @brief   Header for the clock profile table.
+  * Names the clock trees the firmware runs in and derives everything that
+  * follows from one: bus frequencies, flash wait states and the SPI baud rate
+  * dividers that keep the LCD and touch links inside their limits, plus the
+  * tick bookkeeping for tickless sleep. No HAL dependencies: power.c applies
+  * the result to RCC, the SPI peripherals and the SysTick.
+  ******************************************************************************
+  */
+
+#ifndef CLOCKS_H
+#define CLOCKS_H
+
+#include <stdint.h>
+
+#define CLOCK_HSI_HZ          16000000u
+#define CLOCK_LCD_SPI_MAX_HZ  42000000u  // ILI9341 writes (the link has always run at 42 MHz)
+#define CLOCK_TOUCH_SPI_MAX_HZ  400000u  // XPT2046 conversions settle at low clocks
+
+typedef enum {
+    CLOCK_FULL,      // 84 MHz PLL: RF front end, replay, writer, decode, redraws
+    CLOCK_IDLE,      // 16 MHz HSI, PLL off, scale 3: static UI
+    CLOCK_PROFILE_COUNT
+} ClockProfileId;
+
+typedef struct {
+    const char *name;
+    uint8_t use_pll;          // 0: SYSCLK = HSI
+    uint8_t pll_m, pll_p, pll_q;
+    uint16_t pll_n;
+    uint16_t ahb_div;         // 1..512
+    uint8_t apb1_div;         // 1..16
+    uint8_t apb2_div;
+    uint8_t vos;              // Regulator scale (2 or 3)
+} ClockProfile;
+
+// Everything derived from a profile
+typedef struct {
+    uint32_t sysclk, hclk, pclk1, pclk2;
+    uint32_t tim1_clk, tim3_clk;  // APB timer clocks (x2 when the bus is divided)
+    uint16_t us_psc;              // APB1 timer prescaler for 1 MHz (TIM4 backlight)
+    uint8_t flash_ws;
+    uint8_t lcd_br;               // SPI1 CR1.BR: divider = 2 << br
+    uint8_t touch_br;             // SPI2 CR1.BR
+} ClockTree;
+
+// --- PROTOTYPES ---
+
+const ClockProfile* Clock_Profile(ClockProfileId id);
+
+/**
+ * @brief  Derives bus clocks, wait states and SPI dividers for a profile.
+ * @return 0 if the profile breaks a device limit (the tree is still filled in).
+ */
+uint8_t Clock_Derive(const ClockProfile *p, ClockTree *out);
+
+/**
+ * @brief  Smallest SPI baud rate divider (CR1.BR) keeping SCK <= max_hz.
+ */
+uint8_t Clock_SpiBr(uint32_t pclk, uint32_t max_hz);
+
+/**
+ * @brief  Nanoseconds in 'count' periods of a whole-MHz clock (up to ~4 s).
+ */
+uint32_t Clock_Ns(uint32_t count, uint32_t hz);
+
+/**
+ * @brief  Whole milliseconds to add to the HAL tick after a tickless sleep.
+ * @param  partial_ns: Time spent in the tick period that the sleep cut short.
+ * @param  slept_ns: Sleep duration measured by the wakeup timer.
+ * @param  carry_ns: Sub-millisecond remainder, carried from one sleep to the
+ *         next so the tick does not drift (starts at 0).
+ */
+uint32_t Clock_TickCatchUp(uint32_t partial_ns, uint32_t slept_ns, uint32_t *carry_ns);
+
+#endif // CLOCKS_H
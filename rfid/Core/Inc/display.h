@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file    display.h
+  * @brief   Header for the display power manager.
+  * Dims the backlight (TIM4 CH3 PWM on PB8, LCD_BL) after a while without
+  * touches, then turns the panel off with Sleep In. The ILI9341 keeps its
+  * GRAM while asleep, so a touch brings the last frame back in ~5 ms with
+  * no LCD_Init and no redraw; that touch only wakes the display.
+  ******************************************************************************
+  */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "main.h"
+
+#define DISPLAY_DIM_MS     15000   // Without touches before dimming
+#define DISPLAY_SLEEP_MS   30000   // Without touches before the panel sleeps
+#define DISPLAY_BL_FULL    100     // Backlight duty, percent
+#define DISPLAY_BL_DIM     20
+#define DISPLAY_PWM_PERIOD 1000    // 1 MHz timer ticks: 1 kHz PWM
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts the backlight PWM at full brightness. Call after LCD_Init().
+ */
+void Display_Init(void);
+
+/**
+ * @brief  Runs the dim/sleep timeline. Call every loop pass.
+ * @param  touched: Raw touch sample of this pass.
+ * @param  keep_on: 1 while the page shows live progress (no dimming).
+ * @return 1 while the touch that woke the display is held: the caller must
+ *         not treat it as input.
+ */
+uint8_t Display_Poll(uint32_t now_ms, uint8_t touched, uint8_t keep_on);
+
+uint8_t Display_IsAsleep(void);
+
+/**
+ * @brief  Backlight duty in percent (0 = off).
+ */
+void Display_SetBacklight(uint8_t percent);
+
+#endif // DISPLAY_H
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    dsp.h
+  * @brief   Header for the fixed-point sample processing chain.
+  * A pipeline is an array of stages; each stage rewrites a block of int16
+  * samples in place and returns how many it produced. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+
+// --- PIPELINE ---
+
+// Processes 'n' samples of 'buf' in place, returns the number of output samples
+typedef uint16_t (*DspProcessFn)(void *ctx, int16_t *buf, uint16_t n);
+
+typedef struct {
+    DspProcessFn process;
+    void *ctx;              // Stage state (one of the structs below)
+} DspStage;
+
+// --- STAGE STATE ---
+
+typedef struct {
+    int32_t dc;             // Running mean, Q16
+    uint8_t shift;          // Time constant: 2^shift sample pairs
+} DspDcBlock;
+
+typedef struct {
+    uint8_t log2_factor;    // Decimation factor 2^n (n >= 1)
+} DspDecimator;
+
+#define DSP_SLICE_HIGH  16384
+#define DSP_SLICE_LOW  (-16384)
+
+typedef struct {
+    int16_t hi, lo;         // Tracked envelope extremes
+    int16_t decay;          // Per-sample pull of hi/lo towards each other
+    int16_t min_span;       // Below this swing the slicer holds its level (noise)
+    int16_t level;          // Current output, DSP_SLICE_HIGH or DSP_SLICE_LOW
+} DspSlicer;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Runs 'buf' through every stage in order.
+ * @note   'buf' must be 32-bit aligned (stages read sample pairs as one word).
+ * @return Samples left after the last stage.
+ */
+uint16_t Dsp_Run(const DspStage *stages, uint8_t count, int16_t *buf, uint16_t n);
+
+/**
+ * @brief  DC removal: subtracts a slow running mean (leaky integrator).
+ */
+void Dsp_DcBlock_Init(DspDcBlock *s, uint8_t shift, int16_t initial);
+uint16_t Dsp_DcBlock(void *ctx, int16_t *buf, uint16_t n);
+
+/**
+ * @brief  Moving-average decimator (first-order CIC): one mean per 2^n inputs.
+ * @note   'n' must be a multiple of the factor.
+ */
+void Dsp_Decimator_Init(DspDecimator *s, uint8_t log2_factor);
+uint16_t Dsp_Decimate(void *ctx, int16_t *buf, uint16_t n);
+
+/**
+ * @brief  Adaptive threshold slicer: threshold at the middle of the tracked
+ *         envelope, hysteresis of 1/8 of its swing. Outputs DSP_SLICE_HIGH/LOW.
+ */
+void Dsp_Slicer_Init(DspSlicer *s, int16_t decay, int16_t min_span);
+uint16_t Dsp_Slice(void *ctx, int16_t *buf, uint16_t n);
+
+#endif // DSP_H
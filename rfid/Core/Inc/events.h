@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    events.h
+  * @brief   Header for the interrupt-to-main-loop event bus.
+  * A fixed ring of typed events: any context may post (interrupts of any
+  * priority, the main loop), only the main loop takes them out. Posting
+  * claims a slot with one compare-and-swap (LDREX/STREX on the M4, retried
+  * if another producer got in between) and publishes it through the slot's
+  * sequence number, so nothing is ever locked and nothing is allocated.
+  * A full ring drops the new event and counts it. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+
+#define EVENTS_QUEUE_LEN  32   // Power of two
+
+typedef enum {
+    EVT_TOUCH_IRQ,     // TOUCH_IRQ fell (EXTI1)
+    EVT_RF_BLOCK,      // Capture block processed, arg = edges queued
+    EVT_RF_OVERRUN,    // Edge ring full, arg = edges lost in this block
+    EVT_FLASH_DONE,    // Flash word programmed (EOP)
+    EVT_FLASH_ERROR,   // Flash operation failed
+    EVT_DEADLINE,      // Tickless sleep ended on its TIM5 deadline
+    EVT_TYPE_COUNT
+} EventType;
+
+typedef struct {
+    uint16_t type;     // EventType
+    uint16_t arg;
+} Event;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Queues an event. Safe from any interrupt or the main loop.
+ * @return 0 if the ring was full (the event is dropped and counted).
+ */
+uint8_t Events_Post(EventType type, uint16_t arg);
+
+/**
+ * @brief  Takes the oldest event. Main loop only.
+ * @return 0 if the ring is empty.
+ */
+uint8_t Events_Get(Event *out);
+
+/**
+ * @brief  Events posted per type, and events dropped on a full ring.
+ */
+uint32_t Events_Posted(EventType type);
+uint32_t Events_Dropped(void);
+
+#endif // EVENTS_H
@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    fmt.h
+  * @brief   Header for the allocation-free text formatter.
+  * Appends strings and numbers to a caller's fixed buffer. Every call keeps
+  * the buffer NUL-terminated, truncates at its capacity instead of
+  * overflowing, and returns the length so far (no strlen afterwards). A few
+  * dozen bytes of stack, no heap, no locale. No HAL dependencies.
+  *
+  * Field widths follow printf: 'width' > 0 pads on the left (right-aligned,
+  * like %5u), < 0 pads on the right (left-aligned, like %-5s).
+  ******************************************************************************
+  */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+typedef struct {
+    char *buf;
+    uint16_t cap;      // Including the terminator
+    uint16_t len;
+} Fmt;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts an empty string in 'buf' (cap >= 1).
+ */
+void Fmt_Init(Fmt *f, char *buf, uint16_t cap);
+
+uint16_t Fmt_Char(Fmt *f, char c);
+uint16_t Fmt_Str(Fmt *f, const char *s);
+uint16_t Fmt_StrW(Fmt *f, const char *s, int8_t width);
+
+/**
+ * @brief  Decimal, unsigned and signed (%u, %Nu, %-Nu, %d).
+ */
+uint16_t Fmt_Uint(Fmt *f, uint32_t v);
+uint16_t Fmt_UintW(Fmt *f, uint32_t v, int8_t width);
+uint16_t Fmt_Int(Fmt *f, int32_t v);
+
+/**
+ * @brief  Upper-case hex, zero-padded to 'digits' (%0NX, at most 8).
+ */
+uint16_t Fmt_Hex(Fmt *f, uint32_t v, uint8_t digits);
+
+#endif // FMT_H
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    gesture.h
+  * @brief   Header for the touch gesture recognizer.
+  * Turns timestamped touch samples into tap, long-press, swipe and drag events.
+  ******************************************************************************
+  */
+
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <stdint.h>
+
+// --- TIMING / DISTANCE THRESHOLDS ---
+#define GESTURE_DEBOUNCE_MS    20   // Contact must persist this long to count as a press
+#define GESTURE_RELEASE_MS     40   // Contact must be gone this long to count as a release
+#define GESTURE_LONG_PRESS_MS  600  // Stationary hold time for a long-press
+#define GESTURE_SLOP_PX        10   // Movement below this is still a "stationary" touch
+#define GESTURE_SWIPE_MIN_PX   40   // Minimum travel for a swipe
+#define GESTURE_SWIPE_MAX_MS   350  // Maximum duration for a swipe
+
+// --- EVENT TYPES ---
+typedef enum {
+    GESTURE_NONE,
+    GESTURE_DOWN,         // Press confirmed (after debounce)
+    GESTURE_TAP,          // Short stationary press, emitted on release
+    GESTURE_LONG_PRESS,   // Stationary hold, emitted once while still pressed
+    GESTURE_LONG_END,     // Release after a long-press
+    GESTURE_DRAG,         // Movement while pressed (dx/dy since the previous drag event)
+    GESTURE_DRAG_END,     // Release after a slow drag (dx/dy = total travel)
+    GESTURE_SWIPE_LEFT,   // Fast flick, emitted on release (dx/dy = total travel)
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN
+} GestureType;
+
+typedef struct {
+    GestureType type;
+    uint16_t x;       // Press-down position
+    uint16_t y;
+    int16_t dx;       // Movement (meaning depends on type)
+    int16_t dy;
+} GestureEvent;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Clears the recognizer state (e.g. after a blocking screen transition).
+ */
+void Gesture_Reset(void);
+
+/**
+ * @brief  Feeds one touch sample into the recognizer.
+ * @param  pressed: 1 if the panel reported a valid touch for this sample.
+ * @param  x, y: Pixel coordinates (ignored when not pressed).
+ * @param  now_ms: Sample timestamp in milliseconds.
+ * @param  ev: Filled with the recognized event when the return value is 1.
+ * @return 1 if an event was produced, 0 otherwise.
+ */
+uint8_t Gesture_Feed(uint8_t pressed, uint16_t x, uint16_t y, uint32_t now_ms, GestureEvent *ev);
+
+/**
+ * @brief  Checks whether an event ends a press (every press ends with exactly one).
+ */
+uint8_t Gesture_IsRelease(GestureType type);
+
+#endif // GESTURE_H
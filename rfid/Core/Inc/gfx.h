@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    gfx.h
+  * @brief   Header for the 2D drawing library.
+  * Lines, outlines, circles and 1-bpp icons on top of the ILI9341 window and
+  * burst path: every primitive is broken into windows filled with runs of
+  * one color (LCD_PushColor), never into single pixels where a run will do.
+  * Each call goes out as one CS transaction; wrap several calls in
+  * Gfx_Begin()/Gfx_End() to merge them. Coordinates are clipped to the
+  * screen.
+  ******************************************************************************
+  */
+
+#ifndef GFX_H
+#define GFX_H
+
+#include "main.h"
+
+/* Run-length 1-bpp icon, row-major. Each byte is one run: bit 7 set = ink,
+   bits 0-6 = run length - 1. Runs may cross row ends. */
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+    const uint8_t *runs;
+} GfxIcon;
+
+#define GFX_RUN(ink, len)  (uint8_t)(((ink) ? 0x80u : 0u) | ((len) - 1u))
+
+// --- PROTOTYPES ---
+
+void Gfx_Begin(void);
+void Gfx_End(void);
+
+void Gfx_HLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+void Gfx_VLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+void Gfx_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+/**
+ * @brief  1 px rectangle outline: four windows in one transaction.
+ */
+void Gfx_Rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+/**
+ * @brief  Outline and fill with quarter-circle corners of radius 'r'.
+ */
+void Gfx_RoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+void Gfx_FillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+
+/**
+ * @brief  Bresenham line. Each run of pixels along the major axis is one
+ *         window and one burst.
+ */
+void Gfx_Line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/**
+ * @brief  Midpoint circle outline / disc.
+ */
+void Gfx_Circle(int16_t cx, int16_t cy, int16_t r, uint16_t color);
+void Gfx_FillCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color);
+
+/**
+ * @brief  1-bpp bitmap, rows MSB first, padded to whole bytes. Drawn as one
+ *         window (fully on screen) with equal-color runs as bursts.
+ */
+void Gfx_Bitmap(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bits,
+                uint16_t fg, uint16_t bg);
+
+/**
+ * @brief  Run-length icon as one window (must be fully on screen).
+ */
+void Gfx_Icon(int16_t x, int16_t y, const GfxIcon *icon, uint16_t fg, uint16_t bg);
+
+#endif // GFX_H
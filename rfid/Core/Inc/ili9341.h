@@ -68,4 +68,44 @@ void LCD_SetAddress(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
  */
 void LCD_WriteData16(uint16_t data);
 
+/**
+ * @brief  Writes 'count' pixels of one color into the current window
+ *         (after LCD_SetAddress) as a single burst.
+ */
+void LCD_PushColor(uint16_t color, uint32_t count);
+
+/**
+ * @brief  Keeps CS asserted across the calls until the matching
+ *         LCD_Deselect(), so a sequence of windows goes out as one
+ *         transaction. Pairs nest.
+ */
+void LCD_Select(void);
+void LCD_Deselect(void);
+
+/**
+ * @brief  Defines the hardware vertical scrolling area (VSCRDEF, 0x33).
+ * @param  tfa: Top fixed area height in lines.
+ * @param  vsa: Scrolling area height in lines.
+ * @param  bfa: Bottom fixed area height in lines (tfa + vsa + bfa = ILI9341_HEIGHT).
+ */
+void LCD_SetScrollArea(uint16_t tfa, uint16_t vsa, uint16_t bfa);
+
+/**
+ * @brief  Sets which memory line is shown at the top of the scrolling area (VSCRSADD, 0x37).
+ * @param  line: Memory line in the range [tfa, tfa + vsa).
+ */
+void LCD_SetScrollStart(uint16_t line);
+
+/**
+ * @brief  Display Off + Sleep In (0x28, 0x10). The panel stops scanning but
+ *         keeps its GRAM, which can still be written.
+ */
+void LCD_Sleep(void);
+
+/**
+ * @brief  Sleep Out + Display On (0x11, 0x29): shows the retained frame.
+ * @note   Blocks ~5 ms; Sleep In must not follow within 120 ms.
+ */
+void LCD_Wake(void);
+
 #endif // ILI9341_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    layout.h
+  * @brief   Header for precompiled page layouts.
+  * The static part of a page (titles, rules, fixed labels, button frames
+  * with their centered labels) is a const command list resolved entirely by
+  * the compiler: the L_* macros turn a rectangle and a string literal into
+  * final coordinates, so the table lands in flash with no strlen or
+  * centering arithmetic left for run time. Layout_Draw() replays a list in
+  * one LCD transaction; the page code then draws only its dynamic fields.
+  ******************************************************************************
+  */
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "main.h"
+
+#define LAYOUT_CHAR_W  7   // Font_7x10
+#define LAYOUT_CHAR_H  10
+
+typedef enum {
+    LAYOUT_END,
+    LAYOUT_TEXT,     // 'text' at (x, y) in 'color'
+    LAYOUT_FILL,     // Solid rectangle
+    LAYOUT_FRAME,    // 1 px outline
+    LAYOUT_BUTTON    // Terminal button: outline, corner accents, label at (tx, ty)
+} LayoutOp;
+
+typedef struct {
+    uint8_t op;
+    uint8_t alert;          // LAYOUT_BUTTON: red frame and label
+    uint16_t x, y, w, h;
+    uint16_t tx, ty;
+    uint16_t color;
+    const char *text;
+} LayoutCmd;
+
+// Column where a literal is centered in a span of 'sw' pixels starting at 'sx'
+#define L_CENTER(sx, sw, str)  ((sx) + ((sw) - (sizeof(str) - 1) * LAYOUT_CHAR_W) / 2)
+
+// Macro arguments are prefixed so they cannot replace the .x/.y designators
+#define L_TEXT(ax, ay, acolor, str) \
+    { .op = LAYOUT_TEXT, .x = (ax), .y = (ay), .color = (acolor), .text = (str) }
+#define L_TEXT_CENTERED(ay, acolor, str)  L_TEXT(L_CENTER(0, 240, str), ay, acolor, str)
+#define L_FILL(ax, ay, aw, ah, acolor) \
+    { .op = LAYOUT_FILL, .x = (ax), .y = (ay), .w = (aw), .h = (ah), .color = (acolor) }
+#define L_FRAME(ax, ay, aw, ah, acolor) \
+    { .op = LAYOUT_FRAME, .x = (ax), .y = (ay), .w = (aw), .h = (ah), .color = (acolor) }
+#define L_RULE(acolor)  L_FILL(0, 25, 240, 1, acolor)
+#define L_END           { .op = LAYOUT_END }
+
+// 'rect' is a BTN_* geometry macro (x, y, w, h), shared with the ButtonDef used for hit tests
+#define L_BUTTON(rect, str, is_alert)  L_BUTTON_(rect, str, is_alert)
+#define L_BUTTON_(bx, by, bw, bh, str, is_alert) \
+    { .op = LAYOUT_BUTTON, .alert = (is_alert), .x = (bx), .y = (by), .w = (bw), .h = (bh), \
+      .tx = L_CENTER(bx, bw, str), .ty = (by) + ((bh) - LAYOUT_CHAR_H) / 2, .text = (str) }
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Replays a command list up to LAYOUT_END.
+ */
+void Layout_Draw(const LayoutCmd *cmds);
+
+/**
+ * @brief  Outline and corner accents of an idle terminal button.
+ */
+void Layout_ButtonFrame(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+#endif // LAYOUT_H
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    lf_classify.h
+  * @brief   Header for the modulation classifier in front of the LF decoder.
+  * Collects a short window of runs, builds a run-width histogram and decides
+  * the modulation (ASK with Manchester/biphase timing, FSK fc/8-fc/10, PSK)
+  * and the data rate in carrier cycles per bit. Only the matching decoders
+  * are then enabled, and the window is replayed into them so no runs are
+  * lost. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef LF_CLASSIFY_H
+#define LF_CLASSIFY_H
+
+#include <stdint.h>
+#include "lf_decoder.h"
+
+#define LF_CLASS_WINDOW   256  // Runs per decision (~100 ms of ASK, ~10 ms of FSK)
+#define LF_CLASS_MAX_RUN  512  // Longer runs are gaps: the window restarts
+
+typedef enum {
+    LF_CLASS_UNKNOWN,
+    LF_CLASS_ASK,   // Runs of one and two half-bits (Manchester or biphase)
+    LF_CLASS_FSK,   // Two subcarrier periods
+    LF_CLASS_PSK    // One subcarrier period with phase reversals
+} LfClass;
+
+typedef struct {
+    LfClass cls;
+    uint16_t bit_cycles;    // Estimated data rate (RF/n), 0 if unknown
+    uint8_t sub_a;          // FSK: fast subcarrier period; PSK: subcarrier period
+    uint8_t sub_b;          // FSK: slow subcarrier period
+    uint8_t fit;            // Percentage of runs explained by the decision
+} LfClassResult;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Drops the window and any previous decision.
+ */
+void LF_Classify_Reset(void);
+
+/**
+ * @brief  Adds one run of the sliced envelope.
+ * @return 1 when the window is full and a decision was made.
+ */
+uint8_t LF_Classify_Feed(uint8_t level, uint16_t cycles);
+
+uint8_t LF_Classify_IsDone(void);
+const LfClassResult* LF_Classify_Result(void);
+
+/**
+ * @brief  Enables only the decoders matching the decision (all of them if
+ *         the class is unknown).
+ * @return Number of protocols enabled.
+ */
+uint8_t LF_Classify_Apply(void);
+
+/**
+ * @brief  Feeds the classified window into the decoder.
+ * @return 1 if a frame validated (written to 'out').
+ */
+uint8_t LF_Classify_Replay(LfFrame *out);
+
+/**
+ * @brief  Short display form of the decision, e.g. "FSK RF/50".
+ */
+void LF_Classify_Describe(char *out, uint8_t cap);
+
+#endif // LF_CLASSIFY_H
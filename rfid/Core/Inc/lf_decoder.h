@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    lf_decoder.h
+  * @brief   Header for the multi-protocol LF tag decoder.
+  * Each protocol is a descriptor (modulation, bit rate, preamble, validator).
+  * Runs of the sliced envelope are fed to every enabled protocol at once and
+  * the first frame that passes its validator is reported. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef LF_DECODER_H
+#define LF_DECODER_H
+
+#include <stdint.h>
+
+#define LF_MAX_FRAME_BITS  128  // Longest raw frame (incl. preamble / repeat)
+#define LF_MAX_ID_BITS     128  // Longest decoded ID
+
+// --- MODULATION ---
+typedef enum {
+    LF_MOD_ASK_MANCHESTER,  // Amplitude, Manchester coded (EM4100)
+    LF_MOD_FSK,             // Two subcarrier periods, one per bit value (HID Prox)
+    LF_MOD_PSK1             // Subcarrier phase reversal = bit change (Indala)
+} LfModulation;
+
+// --- DESCRIPTOR FLAGS ---
+#define LF_FLAG_EITHER_POLARITY 0x01 // Demodulated bits may come out inverted
+#define LF_FLAG_REPEAT          0x02 // Frame must be seen twice back to back
+
+// --- DECODED FRAME ---
+typedef struct {
+    uint8_t protocol;       // LfProtocolId
+    uint8_t bit_len;        // Valid bits in 'data'
+    uint8_t data[LF_MAX_ID_BITS / 8]; // ID, MSB first
+    uint32_t cycles;        // Carrier cycles from LF_Decoder_Reset() to this frame
+} LfFrame;
+
+// Checks a raw frame (one bit per byte, preamble first) and extracts the ID
+typedef uint8_t (*LfValidateFn)(const uint8_t *bits, LfFrame *out);
+
+// Inverse of the validator: builds the raw frame for an ID, returns its length (0 = unsupported)
+typedef uint8_t (*LfEncodeFn)(const LfFrame *id, uint8_t *bits);
+
+typedef struct {
+    uint8_t id;             // LfProtocolId
+    const char *name;
+    LfModulation modulation;
+    uint16_t bit_cycles;    // Carrier cycles per bit (RF/n)
+    uint8_t sub_a;          // FSK: subcarrier period of a 0; PSK: subcarrier period
+    uint8_t sub_b;          // FSK: subcarrier period of a 1
+    uint64_t preamble;      // MSB first
+    uint8_t preamble_len;
+    uint8_t frame_len;      // Raw bits per frame, preamble included
+    uint8_t flags;          // LF_FLAG_*
+    LfValidateFn validate;
+    LfEncodeFn encode;      // Optional (NULL): needed to write the ID to a blank
+} LfProtocol;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Clears every protocol's state and the time-to-read counter.
+ */
+void LF_Decoder_Reset(void);
+
+/**
+ * @brief  Includes or excludes a protocol from decoding (all are enabled at boot).
+ */
+void LF_Decoder_Enable(uint8_t protocol, uint8_t enable);
+
+/**
+ * @brief  Feeds one run of constant sliced level.
+ * @param  level: 1 = high, 0 = low.
+ * @param  cycles: Run length in carrier cycles.
+ * @return 1 when a frame validated (written to 'out'); further runs are
+ *         ignored until the next reset or LF_Decoder_Rearm().
+ */
+uint8_t LF_Decoder_Feed(uint8_t level, uint16_t cycles, LfFrame *out);
+
+/**
+ * @brief  Resumes decoding after a reported frame, keeping every channel's
+ *         bit history (the next repetition of the frame validates on its own).
+ */
+void LF_Decoder_Rearm(void);
+
+/**
+ * @brief  Decodes with an ad-hoc descriptor in addition to the table (e.g. a
+ *         known block read back from a card being written).
+ * @param  p: Descriptor to run, or NULL to remove it. Must stay valid while set.
+ */
+void LF_Decoder_SetProbe(const LfProtocol *p);
+
+/**
+ * @brief  Helpers for validators: append one bit to / read one bit of a frame ID.
+ */
+void LF_Frame_PutBit(LfFrame *f, uint8_t bit);
+uint8_t LF_Frame_GetBit(const LfFrame *f, uint8_t index);
+
+#endif // LF_DECODER_H
@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    lf_protocols.h
+  * @brief   Header for the built-in LF protocol descriptors.
+  ******************************************************************************
+  */
+
+#ifndef LF_PROTOCOLS_H
+#define LF_PROTOCOLS_H
+
+#include "lf_decoder.h"
+
+// --- PROTOCOL IDS (stored with captured signals: never renumber) ---
+typedef enum {
+    LF_PROTO_NONE    = 0,
+    LF_PROTO_EM4100  = 1,
+    LF_PROTO_HID     = 2,
+    LF_PROTO_INDALA  = 3
+} LfProtocolId;
+
+extern const LfProtocol lf_protocols[];
+extern const uint8_t lf_protocol_count;
+
+/**
+ * @brief  Descriptor for a protocol id, or NULL if unknown.
+ */
+const LfProtocol* LF_Protocol_Find(uint8_t id);
+
+/**
+ * @brief  Short display name for a protocol id ("?" if unknown).
+ */
+const char* LF_Protocol_Name(uint8_t id);
+
+#endif // LF_PROTOCOLS_H
@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    lf_vote.h
+  * @brief   Header for multi-read consensus over decoded LF frames.
+  * Every validated frame votes per bit. The confidence follows the weakest
+  * bit: each agreeing read widens its margin by one, each disagreeing read
+  * (or a frame of another protocol) narrows it, and a capture is accepted
+  * once the margin is wide enough. Clean reads commit after a few frames;
+  * noisy ones need more, and a read that never converges is dropped instead
+  * of being saved. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef LF_VOTE_H
+#define LF_VOTE_H
+
+#include <stdint.h>
+#include "lf_decoder.h"
+
+#define LF_VOTE_MAX_READS  16  // Give up (and start over) after this many frames
+#define LF_VOTE_COMMIT     90  // Confidence (%) needed to accept the consensus: a margin of 4
+
+typedef struct {
+    uint8_t protocol;       // Protocol being voted on (set by the first frame)
+    uint8_t bit_len;
+    uint8_t reads;          // Frames counted, conflicting ones included
+    uint8_t conflicts;      // Frames of another protocol / length
+    uint8_t confidence;     // 0..99
+    uint8_t ones[LF_MAX_ID_BITS]; // Votes for 1 per bit
+    LfFrame consensus;      // Majority value of every bit
+} LfVote;
+
+/**
+ * @brief  Clears all votes.
+ */
+void LF_Vote_Reset(LfVote *v);
+
+/**
+ * @brief  Adds one decoded frame and updates consensus and confidence.
+ * @return 1 once the confidence reaches LF_VOTE_COMMIT.
+ */
+uint8_t LF_Vote_Add(LfVote *v, const LfFrame *f);
+
+#endif // LF_VOTE_H
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    listview.h
+  * @brief   Header for the virtualized, hardware-scrolled list widget.
+  * Only visible rows are rendered; scrolling moves the panel's scroll pointer
+  * and paints just the newly exposed lines.
+  ******************************************************************************
+  */
+
+#ifndef LISTVIEW_H
+#define LISTVIEW_H
+
+#include "main.h"
+
+// --- ROW GEOMETRY ---
+#define LIST_ROW_H    44   // Pitch between rows (scroll area is a multiple of this)
+#define LIST_ROW_X    5    // Row button left edge
+#define LIST_ROW_W    230  // Row button width
+#define LIST_BTN_OFS  2    // Button top offset inside the row pitch
+#define LIST_BTN_H    40   // Button height
+
+// Returns the text for item 'index' (0 <= index < count)
+typedef const char* (*ListView_LabelFn)(uint16_t index);
+
+typedef struct {
+    uint16_t top;            // First screen line of the scrolling area
+    uint16_t rows;           // Rows that fit in the scrolling area
+    uint16_t count;          // Items in the data source
+    int32_t scroll_px;       // Content line shown at the top of the area
+    ListView_LabelFn label;  // Data source
+} ListView;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Configures a list covering 'rows' rows starting at screen line 'top'.
+ */
+void ListView_Init(ListView *lv, uint16_t top, uint16_t rows, ListView_LabelFn label);
+
+/**
+ * @brief  Updates the item count (clamps the scroll position, does not redraw).
+ */
+void ListView_SetCount(ListView *lv, uint16_t count);
+
+/**
+ * @brief  Renders all visible rows and programs the hardware scroll area.
+ */
+void ListView_Render(ListView *lv);
+
+/**
+ * @brief  Scrolls by 'dy' content pixels (positive = towards later items).
+ * @note   Cost is proportional to |dy|, capped at one full render.
+ */
+void ListView_ScrollBy(ListView *lv, int32_t dy);
+
+/**
+ * @brief  Positions item 'index' as the first visible row (clamped).
+ * @note   Does not draw; call ListView_Render() when the page is shown.
+ */
+void ListView_SetTop(ListView *lv, uint16_t index);
+
+/**
+ * @brief  Maps a screen coordinate to an item.
+ * @return Item index, or -1 for gaps, empty rows and points outside the list.
+ */
+int32_t ListView_ItemAt(const ListView *lv, uint16_t y);
+
+/**
+ * @brief  Repaints the visible part of one item, optionally highlighted (tap feedback).
+ */
+void ListView_RedrawItem(ListView *lv, uint16_t index, uint8_t highlight);
+
+/**
+ * @brief  Restores an unscrolled full-screen mapping for pages without a list.
+ */
+void ListView_Release(void);
+
+#endif // LISTVIEW_H
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    page_layouts.h
+  * @brief   Header for the page geometry and precompiled page layouts.
+  * Button rectangles are shared by the hit-test ButtonDefs (ui.c) and the
+  * LAYOUT_BUTTON entries, so a button is drawn where it is tested. The
+  * tables hold the static part of each page for Layout_Draw().
+  ******************************************************************************
+  */
+
+#ifndef PAGE_LAYOUTS_H
+#define PAGE_LAYOUTS_H
+
+#include "layout.h"
+
+// --- BUTTON GEOMETRY (x, y, width, height) ---
+// Main Menu
+#define BTN_TX         10,  45,  220, 50
+#define BTN_RX         10,  110, 220, 50
+#define BTN_CAL        10,  175, 220, 50
+#define BTN_DIAG       10,  240, 220, 50
+
+// List Page (bottom fixed area, below the scrolling rows)
+#define BTN_LIST_HOME  5,   265, 55, 40
+#define BTN_LIST_JUMP  63,  265, 55, 40
+#define BTN_LIST_FIND  121, 265, 55, 40
+#define BTN_LIST_PLAY  179, 265, 56, 40
+
+// Navigation
+#define BTN_BACK       60,  260, 120, 40
+
+// Options Page
+#define BTN_OPT_TX     20,  75,  90, 50
+#define BTN_OPT_CLONE  130, 75,  90, 50
+#define BTN_OPT_RENAME 20,  145, 90, 40
+#define BTN_OPT_DEL    130, 145, 90, 40
+#define BTN_OPT_QUEUE  20,  215, 90, 40
+#define BTN_OPT_BACK   130, 215, 90, 40
+
+// Active Page Controls
+#define BTN_STOP       20,  200, 200, 60
+#define BTN_PL_REPEAT  20,  145, 90, 40
+#define BTN_PL_GAP     130, 145, 90, 40
+
+// Confirmation Page
+#define BTN_CONF_NO    20,  130, 90, 60
+#define BTN_CONF_YES   130, 130, 90, 60
+
+// Keyboard Buttons (5-Key Bottom Row)
+#define BTN_KB_MODE    2,   275, 45, 40
+#define BTN_KB_SHIFT   50,  275, 45, 40
+#define BTN_KB_SPACE   98,  275, 45, 40
+#define BTN_KB_DEL     146, 275, 45, 40
+#define BTN_KB_DONE    194, 275, 44, 40
+
+// Keyboard grid: 5x5 keys of 40x35 with 5 px gaps
+#define KB_KEY_W       40
+#define KB_KEY_H       35
+#define KB_KEY_X(col)  (10 + (col) * (KB_KEY_W + 5))
+#define KB_KEY_Y(row)  (65 + (row) * (KB_KEY_H + 5))
+
+// --- LAYOUTS ---
+extern const LayoutCmd layout_main[];
+extern const LayoutCmd layout_list[];
+extern const LayoutCmd layout_options[];
+extern const LayoutCmd layout_confirm_delete[];
+extern const LayoutCmd layout_keyboard[];
+extern const LayoutCmd layout_transmitting[];
+extern const LayoutCmd layout_writing[];
+extern const LayoutCmd layout_rx_sensing[];
+extern const LayoutCmd layout_calibrate[];
+extern const LayoutCmd layout_diag[];
+
+#endif // PAGE_LAYOUTS_H
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    payload.h
+  * @brief   Header for the versioned, length-prefixed signal payload format.
+  * A payload is a byte blob that can be read in place (from RAM or straight
+  * from memory-mapped flash); all fields are byte-addressed, so any
+  * alignment works. No HAL dependencies.
+  *
+  *   [0]    version (PAYLOAD_VERSION)
+  *   [1]    protocol id (LfProtocolId)
+  *   [2..3] total length in bytes, header included (little endian)
+  *   [4]    ID length in bits
+  *   [5]    flags (PAYLOAD_FLAG_*)
+  *   [6..]  ID bits, MSB first, ceil(bits / 8) bytes
+  *   [..]   optional raw edge-timing blob (rest of the payload)
+  ******************************************************************************
+  */
+
+#ifndef PAYLOAD_H
+#define PAYLOAD_H
+
+#include <stdint.h>
+#include "lf_decoder.h"
+
+#define PAYLOAD_VERSION     1
+#define PAYLOAD_HEADER_LEN  6
+#define PAYLOAD_ID_MAX      (LF_MAX_ID_BITS / 8)
+#define PAYLOAD_SMALL_MAX   (PAYLOAD_HEADER_LEN + PAYLOAD_ID_MAX) // Without raw data
+
+// --- FLAGS ---
+#define PAYLOAD_FLAG_RAW    0x01 // Raw edge blob present
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Writes a payload for a decoded frame into 'buf'.
+ * @param  raw, raw_len: Optional raw edge blob (NULL / 0 for none).
+ * @return Total length, or 0 if it does not fit in 'cap'.
+ */
+uint16_t Payload_Build(uint8_t *buf, uint16_t cap, const LfFrame *frame,
+                       const uint8_t *raw, uint16_t raw_len);
+
+/**
+ * @brief  Converts the pre-payload fixed 32-bit protocol_data field.
+ * @return Total length (PAYLOAD_HEADER_LEN + 4).
+ */
+uint16_t Payload_FromLegacy(uint8_t *buf, uint32_t protocol_data);
+
+/**
+ * @brief  Checks version and internal lengths against the 'avail' bytes at 'p'.
+ * @return 1 if every accessor below is safe to use on 'p'.
+ */
+uint8_t Payload_IsValid(const uint8_t *p, uint16_t avail);
+
+uint8_t Payload_Protocol(const uint8_t *p);
+uint16_t Payload_Length(const uint8_t *p);
+uint8_t Payload_BitLen(const uint8_t *p);
+const uint8_t* Payload_Id(const uint8_t *p);
+
+/**
+ * @brief  Raw edge blob, or NULL if the payload has none.
+ */
+const uint8_t* Payload_Raw(const uint8_t *p, uint16_t *len);
+
+/**
+ * @brief  Unpacks protocol and ID into a frame (as the decoder reported it).
+ */
+void Payload_ToFrame(const uint8_t *p, LfFrame *out);
+
+/**
+ * @brief  Formats the ID as upper-case hex into 'out' (truncated to 'cap').
+ */
+void Payload_IdHex(const uint8_t *p, char *out, uint16_t cap);
+
+#endif // PAYLOAD_H
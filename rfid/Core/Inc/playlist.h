@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    playlist.h
+  * @brief   Header for the multi-signal transmit playlist.
+  * Walks several cached timelines back to back as one endless run sequence:
+  * each timeline is played 'repeats' times, then the field is left unloaded
+  * for the gap, then the next one starts; after the last, the list wraps.
+  * Joins keep the levels alternating (equal levels merge into one run), so
+  * the stream can feed the replay timer directly. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <stdint.h>
+#include "wavecache.h"
+
+#define PLAYLIST_MAX         16
+#define PLAYLIST_GAP_MAX_MS  250  // A gap is one timer period (<= 65535 half cycles)
+
+typedef struct {
+    WaveTimeline items[PLAYLIST_MAX];
+    uint8_t ids[PLAYLIST_MAX];   // Caller's tag per item (e.g. the slot)
+    uint8_t count;
+    uint8_t repeats;             // Passes of each timeline before the gap
+    uint32_t gap_ticks;          // Unloaded time between timelines (0 = none)
+
+    // Cursor (one piece ahead of what the timer plays)
+    volatile uint8_t item;
+    volatile uint8_t pass;
+    volatile uint32_t loops;     // Times the whole list has wrapped
+    uint16_t index;
+    uint8_t in_gap;
+    uint8_t pend_level;          // Run being merged before it is handed out
+    uint32_t pend_ticks;
+} Playlist;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Empties the list and sets the schedule.
+ * @param  gap_ms: Clamped to PLAYLIST_GAP_MAX_MS.
+ */
+void Playlist_Init(Playlist *pl, uint8_t repeats, uint16_t gap_ms);
+
+/**
+ * @brief  Appends a timeline (must stay valid while the list plays).
+ * @return 0 if the list is full or the timeline is unusable.
+ */
+uint8_t Playlist_Add(Playlist *pl, const WaveTimeline *tl, uint8_t id);
+
+/**
+ * @brief  Moves the cursor to the first run of the first item.
+ * @return Level of the first run Playlist_Next() hands out.
+ */
+uint8_t Playlist_Rewind(Playlist *pl);
+
+/**
+ * @brief  Next run as a timer ARR value (half-cycle ticks - 1). Never ends.
+ */
+uint16_t Playlist_Next(Playlist *pl);
+
+#endif // PLAYLIST_H
@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    power.h
+  * @brief   Header for the clock and power mode manager.
+  * Moves the chip between the clock profiles of clocks.h and into stop mode,
+  * re-deriving the SPI dividers and the backlight PWM prescaler on every
+  * change so the LCD and touch links keep their timing. The timer-driven RF paths assume CLOCK_FULL: the
+  * caller must be back in it before starting any of them.
+  *
+  * Between loop passes the core sleeps tickless: the SysTick is stopped,
+  * TIM5 counts timer clock periods up to the earliest deadline registered
+  * during the pass, and any interrupt (touch EXTI, RF DMA, flash, TIM5) ends
+  * the sleep. The HAL tick is then advanced by the time spent asleep.
+  ******************************************************************************
+  */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include "main.h"
+#include "clocks.h"
+
+#define POWER_IDLE_AFTER_MS   2000   // Quiet time before dropping to CLOCK_IDLE
+#define POWER_SLEEP_MAX_MS    1000   // Longest tickless sleep without a deadline
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Takes over the clock tree set up by SystemClock_Config (CLOCK_FULL).
+ */
+void Power_Init(void);
+
+/**
+ * @brief  Switches to a profile (no-op if already there). Blocks for the PLL
+ *         lock when speeding up (~0.2 ms).
+ * @return 0 if RCC refused the change; the previous profile stays active.
+ */
+uint8_t Power_SetProfile(ClockProfileId id);
+
+ClockProfileId Power_Profile(void);
+const ClockTree* Power_Tree(void);
+
+/**
+ * @brief  Stops the clocks until the touch controller pulls its IRQ line low,
+ *         then resumes in CLOCK_IDLE and asks for a loop pass right away
+ *         (the held pen does not interrupt again). Only for waits with no deadline: nothing
+ *         measures time in stop mode, so the HAL tick stands still.
+ */
+void Power_StopUntilTouch(void);
+
+/**
+ * @brief  Asks the next Power_Idle() to wake by 'at_ms' (HAL tick). The
+ *         earliest request of the pass wins; 'now' or earlier means no sleep.
+ */
+void Power_WakeBy(uint32_t at_ms);
+
+/**
+ * @brief  Sleeps until the earliest deadline or the next interrupt, then
+ *         corrects the HAL tick. Call at the end of every loop pass.
+ */
+void Power_Idle(void);
+
+/**
+ * @brief  Microseconds from the HAL tick and the SysTick count, valid across
+ *         profile changes (the SysTick is reloaded for each HCLK). Stops with
+ *         the tick in stop mode. Wraps every ~71 minutes.
+ */
+uint32_t Power_NowUs(void);
+
+/**
+ * @brief  Percentage of time spent asleep since the previous call.
+ */
+uint8_t Power_Residency(void);
+
+/**
+ * @brief  TIM5 wakeup interrupt. Call from TIM5_IRQHandler.
+ */
+void Power_IRQHandler(void);
+
+#endif // POWER_H
@@ -0,0 +1,72 @@
+/**
+  ******************************************************************************
+  * @file    profiler.h
+  * @brief   Header for the cycle-count profiler.
+  * Times code sections with the DWT cycle counter (one register read at each
+  * end, no interrupts) and keeps the last, best and worst duration per
+  * section for the diagnostics page.
+  ******************************************************************************
+  */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "main.h"
+
+// --- SECTIONS ---
+typedef enum {
+    PROF_WAVE_BUILD,   // Payload expanded into the waveform cache
+    PROF_TX_START,     // Transmit page opened -> TIM1/DMA running
+    PROF_LCD_WAKE,     // Touch IRQ on a sleeping display -> first sample the recognizer takes at full clock
+    PROF_RF_BLOCK,     // Capture ISR: one DMA half through the DSP chain and edge tracker
+    PROF_DEMOD,        // One edge through the enabled decoders
+    PROF_UI_FRAME,     // Full page redraw (clear, frames, text)
+    PROF_COUNT
+} ProfId;
+
+typedef struct {
+    uint32_t last;     // Cycles (0 for sections recorded in microseconds)
+    uint32_t max;
+    uint32_t min;      // max - min is the jitter
+    uint32_t count;
+    uint32_t last_us;  // Converted when recorded: the core clock changes with the profile
+    uint32_t max_us;
+} ProfStat;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts the DWT cycle counter. Call once after HAL_Init().
+ */
+void Prof_Init(void);
+
+static inline uint32_t Prof_Now(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief  Closes a section opened with Prof_Now() (wraps every ~51 s at 84 MHz).
+ */
+void Prof_Record(ProfId id, uint32_t start);
+
+/**
+ * @brief  Records a section timed in microseconds (Power_NowUs), for spans the
+ *         cycle counter cannot follow: stop mode or a clock profile change.
+ *         Only count, last_us and max_us are kept.
+ */
+void Prof_RecordUs(ProfId id, uint32_t us);
+
+/**
+ * @brief  Forgets a section's figures, when what it times changes mode.
+ */
+void Prof_Reset(ProfId id);
+
+const ProfStat* Prof_Get(ProfId id);
+const char* Prof_Name(ProfId id);
+
+/**
+ * @brief  Cycles to microseconds at the current core clock.
+ */
+uint32_t Prof_Us(uint32_t cycles);
+
+#endif // PROFILER_H
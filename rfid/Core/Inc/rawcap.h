@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file    rawcap.h
+  * @brief   Header for raw edge-timing capture (unknown fobs).
+  * Records a window of sliced-envelope runs and stores them compactly:
+  * each run width is coded as the zigzag delta to the previous run of the
+  * same level, as a variable-length (7 bits per byte) integer. Fobs repeat a
+  * handful of widths, so most runs cost one byte. No HAL dependencies.
+  *
+  * Blob layout: [format][first level][run count, LE16][varint deltas...]
+  ******************************************************************************
+  */
+
+#ifndef RAWCAP_H
+#define RAWCAP_H
+
+#include <stdint.h>
+
+#define RAWCAP_FORMAT      1
+#define RAWCAP_HEADER_LEN  4
+#define RAWCAP_MAX_BYTES   1000   // Blob limit (fits the storage raw stage with a payload header)
+#define RAWCAP_WINDOW      32768  // Carrier cycles recorded once the signal starts (~260 ms)
+#define RAWCAP_IDLE        2048   // A run this long means no tag in the field
+#define RAWCAP_MIN_RUNS    32     // Shorter captures are treated as noise
+
+typedef struct {
+    uint8_t buf[RAWCAP_MAX_BYTES];
+    uint16_t len;           // Bytes used, header included
+    uint16_t runs;          // Runs encoded
+    uint32_t cycles;        // Carrier cycles recorded
+    uint16_t prev[2];       // Last width per level (delta reference)
+    uint16_t pend_width;    // Run still growing (same-level runs are merged)
+    uint8_t pend_level;
+    uint8_t state;          // Waiting / recording / done
+} RawCapture;
+
+typedef struct {
+    const uint8_t *blob;
+    const uint8_t *p, *end;
+    uint16_t total;         // Runs in the blob
+    uint16_t left;          // Runs not yet read in this pass
+    uint16_t prev[2];
+    uint8_t level;          // Level of the next run
+} RawReader;
+
+// --- CAPTURE ---
+
+/**
+ * @brief  Arms a capture; recording starts with the first non-idle run.
+ */
+void Rawcap_Begin(RawCapture *rc);
+
+/**
+ * @brief  Adds one run of the sliced envelope.
+ * @return 1 once the capture is complete (window full or the tag left).
+ */
+uint8_t Rawcap_Feed(RawCapture *rc, uint8_t level, uint16_t cycles);
+
+uint8_t Rawcap_IsDone(const RawCapture *rc);
+
+/**
+ * @brief  Finished blob (valid once Rawcap_IsDone()).
+ */
+const uint8_t* Rawcap_Blob(const RawCapture *rc, uint16_t *len);
+
+// --- PLAYBACK ---
+
+/**
+ * @brief  Opens a blob for reading.
+ * @return 0 if the header is not a supported raw capture.
+ */
+uint8_t Rawcap_Open(RawReader *r, const uint8_t *blob, uint16_t len);
+
+/**
+ * @brief  Reads the next run.
+ * @return 0 at the end of the capture (or on a malformed blob).
+ */
+uint8_t Rawcap_Next(RawReader *r, uint8_t *level, uint16_t *cycles);
+
+/**
+ * @brief  Restarts reading from the first run.
+ */
+void Rawcap_Rewind(RawReader *r);
+
+#endif // RAWCAP_H
@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    rf_frontend.h
+  * @brief   Header for the 125 kHz carrier and envelope acquisition front end.
+  * TIM3 drives the coil and triggers ADC1 once per carrier cycle; DMA fills a
+  * double buffer and each finished block runs through the DSP chain. The
+  * sliced output is reported as a ring of run lengths.
+  ******************************************************************************
+  */
+
+#ifndef RF_FRONTEND_H
+#define RF_FRONTEND_H
+
+#include "main.h"
+
+// --- CARRIER / SAMPLING ---
+#define RF_TIMER_CLK      84000000u  // TIM3 kernel clock (APB1 x2)
+#define RF_CARRIER_HZ     125000u
+#define RF_CARRIER_ARR    (RF_TIMER_CLK / RF_CARRIER_HZ - 1) // 671
+#define RF_CARRIER_TRIM   40u        // Largest ARR offset accepted from antenna tuning
+#define RF_BLOCK          256        // Samples per DMA half (~2 ms)
+#define RF_DECIM_LOG2     1          // 2 carrier cycles per processed sample (FSK needs the resolution)
+#define RF_MIN_SUBCARRIER (2u << RF_DECIM_LOG2) // Shortest subcarrier period (cycles) that survives decimation;
+                                                // shorter ones need RF_Frontend_SetFullRate()
+
+// --- COIL DRIVE (TIM3->CCMR1) ---
+// Driven: CH1 PWM1 and CH2 PWM2 at the same compare value (antiphase halves).
+// Off: both outputs forced low. Writing one or the other gates the field
+// without stopping the timer (T5577 downlink gaps).
+#define RF_CCMR1_CARRIER_ON   ((6u << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE | \
+                               (7u << TIM_CCMR1_OC2M_Pos) | TIM_CCMR1_OC2PE)
+#define RF_CCMR1_CARRIER_OFF  ((4u << TIM_CCMR1_OC1M_Pos) | (4u << TIM_CCMR1_OC2M_Pos))
+
+// --- EDGE RING ---
+// Each entry is one run of constant sliced level: bit 15 = level, bits 0-14 =
+// length in carrier cycles (saturated runs are split into several entries).
+#define RF_EDGE_LEVEL     0x8000u
+#define RF_EDGE_CYCLES    0x7FFFu
+#define RF_EDGE_RING      512        // Power of two
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts the carrier, the ADC trigger chain and the DMA double buffer.
+ */
+void RF_Frontend_Start(void);
+
+/**
+ * @brief  Stops the carrier and acquisition (outputs idle low).
+ */
+void RF_Frontend_Stop(void);
+
+uint8_t RF_Frontend_IsRunning(void);
+
+/**
+ * @brief  Sets where in the carrier cycle the ADC samples (timer ticks, 0..ARR).
+ */
+void RF_Frontend_SetSamplePhase(uint16_t ticks);
+
+/**
+ * @brief  Skips the decimator (one processed sample per carrier cycle) so a
+ *         subcarrier below RF_MIN_SUBCARRIER, PSK at RF/2, is not averaged
+ *         away. Costs twice the slicing per block. Applies from the next
+ *         block and is kept across stop / start.
+ */
+void RF_Frontend_SetFullRate(uint8_t on);
+
+/**
+ * @brief  Sets the carrier period (TIM3 ARR) found by antenna tuning.
+ * @return 0 if 'arr' is more than RF_CARRIER_TRIM away from RF_CARRIER_ARR.
+ */
+uint8_t RF_Frontend_SetCarrierArr(uint16_t arr);
+uint16_t RF_Frontend_CarrierArr(void);
+
+/**
+ * @brief  Re-seeds the carrier level from the next complete ADC block
+ *         (forgets the running mean after a period or phase change).
+ */
+void RF_Frontend_RestartLevel(void);
+
+/**
+ * @brief  Moves up to 'max' run-length entries out of the edge ring.
+ * @return Entries copied.
+ */
+uint16_t RF_Frontend_ReadEdges(uint16_t *dst, uint16_t max);
+
+/**
+ * @brief  Drops everything queued in the edge ring.
+ */
+void RF_Frontend_FlushEdges(void);
+
+/**
+ * @brief  Unmodulated carrier level seen by the ADC (running mean, ADC codes).
+ */
+int16_t RF_Frontend_CarrierLevel(void);
+
+/**
+ * @brief  Edge entries lost because the ring was full.
+ */
+uint32_t RF_Frontend_Dropped(void);
+
+/**
+ * @brief  DMA transfer-complete handler (call from DMA2_Stream0_IRQHandler).
+ */
+void RF_Frontend_IRQHandler(void);
+
+#endif // RF_FRONTEND_H
@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    rf_replay.h
+  * @brief   Header for timeline replay (tag emulation).
+  * TIM1 counts half carrier cycles and toggles the load-modulation switch
+  * (PA8) once per period; circular DMA rewrites the preloaded ARR on every
+  * update straight from a cached timeline (wavecache.h), so each period is
+  * one run and the timing comes from hardware, not code.
+  ******************************************************************************
+  */
+
+#ifndef RF_REPLAY_H
+#define RF_REPLAY_H
+
+#include "main.h"
+#include "wavecache.h"
+#include "playlist.h"
+
+#define RF_REPLAY_TIMER_CLK  84000000u  // TIM1 kernel clock (APB2)
+#define RF_REPLAY_BLOCK      64         // Playlist runs per DMA half
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts looping a timeline. It is read in place by DMA and must stay
+ *         untouched until RF_Replay_Stop().
+ * @return 0 if the timeline has fewer than two runs.
+ */
+uint8_t RF_Replay_Start(const WaveTimeline *tl);
+
+/**
+ * @brief  Starts cycling a playlist (rewound first). The playlist and its
+ *         timelines must stay untouched until RF_Replay_Stop().
+ * @return 0 if the playlist is empty.
+ */
+uint8_t RF_Replay_StartPlaylist(Playlist *pl);
+
+/**
+ * @brief  Stops the timeline and releases the load (PA8 low).
+ */
+void RF_Replay_Stop(void);
+
+uint8_t RF_Replay_IsRunning(void);
+
+/**
+ * @brief  Number of times the timeline (or the whole playlist) has been played through.
+ */
+uint32_t RF_Replay_Loops(void);
+
+/**
+ * @brief  DMA transfer-complete handler (call from DMA2_Stream5_IRQHandler).
+ */
+void RF_Replay_IRQHandler(void);
+
+#endif // RF_REPLAY_H
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    rf_writer.h
+  * @brief   Header for the T5577 clone writer.
+  * Sends write and read commands as gap timelines (TIM1 counts carrier
+  * cycles; DMA reloads its period and gates the TIM3 coil drive on every
+  * step), verifies each block by reading it back through the decoder, and
+  * rewrites only the blocks that did not verify.
+  ******************************************************************************
+  */
+
+#ifndef RF_WRITER_H
+#define RF_WRITER_H
+
+#include "main.h"
+#include "lf_decoder.h"
+
+#define RF_WRITER_RETRIES    3    // Rewrites per block before giving up
+#define RF_WRITER_VERIFY_MS  150  // Read-back window per block
+
+typedef enum {
+    RF_WRITER_IDLE,
+    RF_WRITER_WRITING,
+    RF_WRITER_VERIFYING,
+    RF_WRITER_DONE,
+    RF_WRITER_FAILED
+} RfWriterState;
+
+typedef struct {
+    RfWriterState state;
+    uint8_t blocks;         // Blocks in the card image (config included)
+    uint8_t block;          // Block being written / verified
+    uint8_t verified;       // Bit per verified block
+    uint8_t retries;        // Block rewrites so far
+    uint32_t elapsed_ms;    // Start to last verified block (or failure)
+} RfWriterStatus;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts cloning 'id' onto a T5577 in the field (carrier is started if needed).
+ * @return 0 if the protocol cannot be expressed as a T5577 image.
+ */
+uint8_t RF_Writer_Start(const LfProtocol *p, const LfFrame *id);
+
+/**
+ * @brief  Advances the write/verify sequence. Call every loop pass.
+ */
+void RF_Writer_Task(void);
+
+/**
+ * @brief  Cancels a clone in progress (leaves the carrier on).
+ */
+void RF_Writer_Abort(void);
+
+uint8_t RF_Writer_IsBusy(void);
+const RfWriterStatus* RF_Writer_Status(void);
+
+/**
+ * @brief  DMA transfer-complete handler (call from DMA2_Stream1_IRQHandler).
+ */
+void RF_Writer_IRQHandler(void);
+
+#endif // RF_WRITER_H
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    search.h
+  * @brief   Header for incremental fuzzy search over signal names.
+  * Each keystroke narrows the previous result set through a character index
+  * built once per session; names are not read again while typing.
+  ******************************************************************************
+  */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+
+// --- CAPACITY ---
+#ifndef SEARCH_MAX_ENTRIES
+#define SEARCH_MAX_ENTRIES 32    // Must cover MAX_SLOTS (the host benchmark builds 2048)
+#endif
+#define SEARCH_MAX_QUERY   10    // Matches NAME_LEN
+#define SEARCH_NAME_MAX    15    // Characters of each name that are indexed
+#define SEARCH_MAX_POSTINGS (SEARCH_MAX_ENTRIES * SEARCH_MAX_QUERY) // Distinct characters over all names
+
+// --- KEYSTROKE BUDGET ---
+// A keystroke walks the index entries of the typed character once and reads
+// no names. At SEARCH_MAX_ENTRIES it must fit half of a 1 ms main-loop pass.
+#define SEARCH_KEY_BUDGET_US 500
+
+// --- MATCH QUALITY (higher is better) ---
+#define SEARCH_NONE      0
+#define SEARCH_FUZZY     1  // Query letters appear in order
+#define SEARCH_SUBSTRING 2  // Query appears contiguously
+#define SEARCH_PREFIX    3  // Name starts with the query
+
+// Returns the name of entry 'index', or NULL if the entry is empty
+typedef const char* (*Search_NameFn)(uint16_t index);
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts a search session: indexes all names and resets to an empty query.
+ * @param  name: Name accessor for the data source.
+ * @param  count: Number of entries; those past SEARCH_MAX_ENTRIES, or past a full
+ *         index (SEARCH_MAX_POSTINGS), are never matched.
+ */
+void Search_Begin(Search_NameFn name, uint16_t count);
+
+/**
+ * @brief  Appends a character and narrows the current result set.
+ * @return 1 if accepted, 0 if the query is already full.
+ */
+uint8_t Search_Push(char c);
+
+/**
+ * @brief  Removes the last character, restoring the previous result set.
+ */
+void Search_Pop(void);
+
+/**
+ * @brief  Number of entries matching the current query.
+ */
+uint16_t Search_Count(void);
+
+/**
+ * @brief  Current (case-folded) query string.
+ */
+const char* Search_Query(void);
+
+/**
+ * @brief  Rates how well entry 'index' matches the current query.
+ * @return SEARCH_NONE .. SEARCH_PREFIX.
+ */
+uint8_t Search_Score(uint16_t index);
+
+#endif // SEARCH_H
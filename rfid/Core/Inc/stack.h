@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    stack.h
+  * @brief   Header for the main stack monitor and overflow guard.
+  * The startup code paints the stack with STACK_PAINT before main(); the
+  * high-water mark is the lowest word that no longer holds it, probed once
+  * a second from the main loop.
+  *
+  * Below the stack sits an MPU region with no access (_Stack_Guard_Size in
+  * the linker script, larger than any frame in the .su files). A push into
+  * it faults instead of silently overwriting the heap and .bss: the fault
+  * handler records the address in RAM that survives the reset, then resets.
+  *
+  * Tools/stack_usage.py gives the static side of the same budget: the
+  * post-build step writes its estimate into the ELF it was computed from.
+  ******************************************************************************
+  */
+
+#ifndef STACK_H
+#define STACK_H
+
+#include "main.h"
+
+#define STACK_PAINT     0xA5A5A5A5u  // Also in startup_stm32f401retx.s
+#define STACK_PROBE_MS  1000
+
+typedef struct {
+    uint32_t size;        // Bytes between the guard and _estack
+    uint32_t peak;        // High-water mark, bytes
+    uint32_t overflows;   // Guard hits since power-on
+    uint32_t fault_addr;  // Address of the last hit, 0 if the core did not latch it
+} StackStats;
+
+typedef struct {
+    uint32_t main;        // Deepest chain from main()
+    uint32_t isr;         // Deepest handler chain, with its exception frame
+    uint32_t worst;       // Bytes, 0 if the post-build step did not run
+} StackBudget;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Loads the fault record and arms the guard. Call once after HAL_Init().
+ */
+void Stack_Init(void);
+
+/**
+ * @brief  High-water mark probe, rescans the paint every STACK_PROBE_MS.
+ */
+void Stack_Poll(uint32_t now);
+
+const StackStats* Stack_Get(void);
+
+/**
+ * @brief  Static estimate of this firmware image (.stack_budget section).
+ */
+const StackBudget* Stack_Budget(void);
+
+/**
+ * @brief  From the HardFault handler (guard faults escalate there, with the
+ *         MPU off): records and resets if the fault hit the guard, else returns.
+ */
+void Stack_Fault(void);
+
+#endif // STACK_H
@@ -2,7 +2,9 @@
   ******************************************************************************
   * @file    storage.h
   * @brief   Header for Flash Memory Storage.
-  * Defines macros and prototypes for saving/loading signals.
+  * Write-back layer: mutations land in RAM and a dirty set immediately, and a
+  * background task appends them to a log in flash, one word per slice, driven
+  * by the flash end-of-operation interrupt.
   ******************************************************************************
   */
 
@@ -13,22 +15,71 @@
 #include "stm32f4xx_hal.h"
 
 // --- FLASH MEMORY MAP (STM32F401RE) ---
-// We use Sector 7 (Last sector) to avoid overwriting program code.
-// Sector 7 is 128KB, starting at 0x08060000.
-#define FLASH_STORAGE_ADDR 0x08060000 
-#define FLASH_SECTOR_NUM   FLASH_SECTOR_7
-#define FLASH_VOLTAGE_RANGE FLASH_VOLTAGE_RANGE_3
+// The log ping-pongs between the last two 128KB sectors; the linker script
+// keeps program code below 0x08040000.
+#define STORAGE_SECTOR_A_ADDR 0x08040000 // Sector 6
+#define STORAGE_SECTOR_B_ADDR 0x08060000 // Sector 7
+#define STORAGE_SECTOR_SIZE   0x20000
+#define FLASH_VOLTAGE_RANGE   FLASH_VOLTAGE_RANGE_3
+
+// Pre-log layout (fixed signal array + calibration record in sector 7),
+// imported once on the first boot after an upgrade.
+#define FLASH_STORAGE_ADDR    STORAGE_SECTOR_B_ADDR
+#define FLASH_CALIB_ADDR      (FLASH_STORAGE_ADDR + 0x1000)
+#define CALIB_MAGIC           0x54434C31 // "TCL1"
+
+#define LOG_SECTOR_MAGIC      0x474F4C53 // "SLOG"
+#define LOG_COMMIT            0x00C0FFEE // Written last; anything else means torn
 
 // --- PROTOTYPES ---
 
 /**
- * @brief  Erases the storage sector and saves the current signal database.
+ * @brief  Mounts the newest valid log and replays it into signal_db, the
+ *         touch calibration and the carrier tuning (imports the legacy layout
+ *         if no log exists).
+ * @note   Call once at startup, before anything reads signal_db.
+ */
+void Storage_Init(void);
+
+/**
+ * @brief  Marks a slot as changed. The RAM copy is already the truth; the
+ *         record (or a delete marker, if the slot is inactive) is committed later.
+ */
+void Storage_UpdateSignal(int slot);
+
+/**
+ * @brief  Replaces a slot's payload blob (payload.h) and marks it changed.
+ *         The blob is copied into RAM until committed, then read from flash.
+ * @param  blob, len: New payload, or NULL / 0 to clear it.
+ * @return 1 on success, 0 if the blob is too large to stage.
+ */
+uint8_t Storage_SetPayload(int slot, const uint8_t *blob, uint16_t len);
+
+/**
+ * @brief  Marks the active touch calibration for a deferred commit.
+ */
+void Storage_SaveCalibration(void);
+
+/**
+ * @brief  Records the carrier period chosen by antenna tuning (applied again
+ *         by Storage_Init on the next boot). No-op if it is already stored.
+ */
+void Storage_SaveTuning(uint16_t arr);
+
+/**
+ * @brief  Background committer. Issues at most one flash operation per call
+ *         and returns immediately while it is in flight. Call every loop pass.
+ */
+void Storage_Task(void);
+
+/**
+ * @brief  Blocks until every pending change is in flash (e.g. before a low-power mode).
  */
-void Storage_SaveSignals(void);
+void Storage_Flush(void);
 
 /**
- * @brief  Reads the signal database from Flash into RAM on startup.
+ * @brief  1 while changes are pending or a flash operation is in flight.
  */
-void Storage_LoadSignals(void);
+uint8_t Storage_IsBusy(void);
 
-#endif // STORAGE_H
\ No newline at end of file
+#endif // STORAGE_H
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    t5577.h
+  * @brief   Header for the T5577 (ATA5577) command encoder.
+  * Builds block contents for a decoded tag, downlink command bits, and the
+  * gap timeline that carries them: the reader switches the field off for a
+  * short gap after every bit, and the field-on time before the gap encodes
+  * the bit (fixed-bit-length mode). No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef T5577_H
+#define T5577_H
+
+#include <stdint.h>
+#include "lf_decoder.h"
+
+// --- DOWNLINK TIMING (carrier cycles; datasheet windows in brackets) ---
+#define T5577_START_GAP    30   // [8..50]
+#define T5577_WRITE_GAP    17   // [8..30]
+#define T5577_DATA_0       24   // [16..31] field on between gaps
+#define T5577_DATA_1       56   // [48..63]
+#define T5577_TAIL         64   // Field on after the last gap
+#define T5577_PROG_MS      6    // Programming time after a write (5.6 ms)
+
+// --- LIMITS ---
+#define T5577_MAX_BLOCKS   8                      // Config block 0 + 7 data blocks
+#define T5577_CMD_MAX      70                     // Password write: 2 + 32 + 1 + 32 + 3
+#define T5577_TIMELINE_MAX (2 + 2 * T5577_CMD_MAX)
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Configuration word (block 0) that makes the tag emulate 'p'.
+ * @param  data_blocks: Blocks 1..n sent in regular read mode.
+ * @return 0 if the modulation or rate has no T5577 equivalent.
+ */
+uint32_t T5577_Config(const LfProtocol *p, uint8_t data_blocks);
+
+/**
+ * @brief  Full card image for an ID: blocks[0] = config, then the raw frame
+ *         packed MSB first into 32-bit blocks.
+ * @return Blocks used (config included), 0 if the protocol cannot be written.
+ */
+uint8_t T5577_Blocks(const LfProtocol *p, const LfFrame *id, uint32_t *blocks);
+
+/**
+ * @brief  Standard write (page 0): opcode, [password], lock = 0, data, address.
+ * @param  password: NULL if password mode is off.
+ * @return Number of bits written to 'bits'.
+ */
+uint8_t T5577_WriteCmd(uint8_t *bits, uint8_t block, uint32_t data, const uint32_t *password);
+
+/**
+ * @brief  Direct access read (page 0): the tag then repeats the block forever.
+ */
+uint8_t T5577_ReadCmd(uint8_t *bits, uint8_t block, const uint32_t *password);
+
+/**
+ * @brief  Converts command bits into alternating field-off / field-on
+ *         durations, starting with the start gap and ending with T5577_TAIL.
+ * @return Entries written (even index = field off), 0 if 'cap' is too small.
+ */
+uint16_t T5577_Timeline(const uint8_t *bits, uint8_t nbits, uint16_t *cycles, uint16_t cap);
+
+#endif // T5577_H
@@ -12,12 +12,25 @@
 #include "main.h"
 
 // --- CALIBRATION DATA ---
-// Maps raw 12-bit ADC readings to screen pixel coordinates.
+// Factory defaults: maps raw 12-bit ADC readings to screen pixel coordinates.
+// Only used to build the default matrix until a calibration is stored in flash.
 #define RAW_X_MIN  200
 #define RAW_X_MAX  3700
 #define RAW_Y_MIN  300
 #define RAW_Y_MAX  3800
 
+// --- AFFINE CALIBRATION ---
+// screen_x = (a * raw_x + b * raw_y + c) >> TOUCH_CALIB_SHIFT
+// screen_y = (d * raw_x + e * raw_y + f) >> TOUCH_CALIB_SHIFT
+// a,b,d,e must fit in 16 bits so each axis is a single SMLAD (dual multiply-add).
+#define TOUCH_CALIB_SHIFT  16
+#define TOUCH_CALIB_POINTS 3
+
+typedef struct {
+    int32_t a, b, c;
+    int32_t d, e, f;
+} TouchCalib;
+
 // --- UI STRUCTURES ---
 typedef struct {
     uint16_t x;       // Top-left X position
@@ -42,6 +55,44 @@ uint8_t Touch_IsPressed(void);
  */
 uint8_t Touch_GetPixels(uint16_t *x, uint16_t *y);
 
+/**
+ * @brief  Returns the filtered raw ADC values behind the last valid Touch_GetPixels() call.
+ * @param  raw_x, raw_y: Pointers to store the raw readings.
+ */
+void Touch_GetLastRaw(uint16_t *raw_x, uint16_t *raw_y);
+
+/**
+ * @brief  Solves the affine matrix from three screen/raw point pairs (fixed point).
+ * @param  screen: Target pixel coordinates {x, y} for each point.
+ * @param  raw: Raw readings {x, y} measured at each target.
+ * @param  out: Resulting calibration matrix.
+ * @return 1 on success, 0 if the points are degenerate or the matrix is out of range.
+ */
+uint8_t Touch_SolveCalibration(const uint16_t screen[TOUCH_CALIB_POINTS][2],
+                               const uint16_t raw[TOUCH_CALIB_POINTS][2],
+                               TouchCalib *out);
+
+/**
+ * @brief  Installs a calibration matrix (e.g. solved on-device or loaded from flash).
+ */
+void Touch_SetCalibration(const TouchCalib *cal);
+
+/**
+ * @brief  Returns the active calibration matrix.
+ */
+const TouchCalib* Touch_GetCalibration(void);
+
+/**
+ * @brief  Reverts to the factory default matrix derived from RAW_X/Y_MIN/MAX.
+ */
+void Touch_LoadDefaultCalibration(void);
+
+/**
+ * @brief  Checks whether the active matrix came from a user calibration.
+ * @return 1 if calibrated, 0 if running on factory defaults.
+ */
+uint8_t Touch_IsCalibrated(void);
+
 /**
  * @brief  Checks if a specific touch coordinate falls within a button's boundaries.
  * @param  button: The button definition to check against.
@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    tuning.h
+  * @brief   Header for the antenna resonance sweep.
+  * Steps the carrier period around 125 kHz and measures the coil amplitude at
+  * each step through the ADC path, then fits the resonance peak. The ADC
+  * samples at a fixed point of the carrier cycle, and the coil phase turns
+  * through resonance, so each step is measured at four quadrature sample
+  * points: I = L0 - L2, Q = L1 - L3 cancels the bias and the phase.
+  * No HAL dependencies: the caller applies the settings it asks for.
+  ******************************************************************************
+  */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stdint.h>
+
+// --- SWEEP ---
+#define TUNE_ARR_SPAN      32   // Timer counts each side of the centre (~119..131 kHz)
+#define TUNE_ARR_STEP      2
+#define TUNE_POINTS        (2 * TUNE_ARR_SPAN / TUNE_ARR_STEP + 1)
+#define TUNE_SETTLE_MS     4    // Coil ring-up plus one ADC block after a change
+#define TUNE_MEASURE_MS    6    // Level average after the restart
+#define TUNE_MIN_AMPL      16   // ADC codes: weaker peaks mean no antenna
+
+typedef enum {
+    TUNE_ACT_NONE,
+    TUNE_ACT_APPLY,      // Program Tune_Arr() / Tune_Phase()
+    TUNE_ACT_RESTART,    // Restart the carrier level average
+    TUNE_ACT_DONE        // Tune_Result() is final
+} TuneAction;
+
+typedef struct {
+    uint16_t center;              // Nominal period (ARR)
+    uint8_t point;                // Sweep step being measured
+    uint8_t phase;                // Quadrature sample point (0..3)
+    uint8_t stage;
+    uint32_t since_ms;            // Start of the current stage
+    int16_t level[4];             // Carrier level per sample point
+    uint32_t power[TUNE_POINTS];  // I^2 + Q^2 per step
+    uint16_t result;              // Chosen ARR, 0 if no clear resonance
+} TuneSweep;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Starts a sweep around 'center_arr'. The first Tune_Feed() asks for
+ *         the first setting.
+ */
+void Tune_Begin(TuneSweep *s, uint16_t center_arr, uint32_t now_ms);
+
+/**
+ * @brief  Advances the sweep. Call every loop pass.
+ * @param  level: Current carrier level (ADC codes).
+ * @return What the caller has to do now.
+ */
+TuneAction Tune_Feed(TuneSweep *s, uint32_t now_ms, int16_t level);
+
+uint8_t Tune_IsDone(const TuneSweep *s);
+uint16_t Tune_Result(const TuneSweep *s);
+
+/**
+ * @brief  Setting requested by the last TUNE_ACT_APPLY.
+ */
+uint16_t Tune_Arr(const TuneSweep *s);
+uint16_t Tune_Phase(const TuneSweep *s); // Sample point in timer ticks (1..ARR)
+
+/**
+ * @brief  Squared amplitude from the levels at four quadrature sample points.
+ */
+uint32_t Tune_Power(const int16_t *level);
+
+/**
+ * @brief  Resonance from a sweep: highest step refined by a parabola through
+ *         it and its neighbours.
+ * @param  first_arr, step: ARR of power[0] and the ARR increment per entry.
+ * @return Best ARR, 0 if the response is too weak or flat to trust.
+ */
+uint16_t Tune_FitPeak(const uint32_t *power, uint8_t n, uint16_t first_arr, uint8_t step);
+
+#endif // TUNING_H
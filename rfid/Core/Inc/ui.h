@@ -13,6 +13,8 @@
 #include "touch.h"
 #include "ili9341.h"
 #include "fonts.h"
+#include "gesture.h"
+#include "lf_decoder.h"
 
 // --- THEME COLORS (High Contrast Hacker Theme) ---
 #define COLOR_TERM_BG    BLACK
@@ -29,12 +31,23 @@ typedef enum {
     PAGE_CONFIRM_DELETE,  // Safety check
     PAGE_TRANSMITTING,    // Active output
     PAGE_RX_SENSING,      // Active sniffing
-    PAGE_KEYBOARD         // Text entry
+    PAGE_WRITING,         // Cloning onto a T5577 blank
+    PAGE_KEYBOARD,        // Text entry
+    PAGE_CALIBRATE,       // Touch calibration targets
+    PAGE_DIAG             // Profiler and cache statistics
 } AppState;
 
 extern AppState currentState;
 extern uint8_t ui_needs_update;
 
+// --- SNIFFER STATUS (shown live on PAGE_RX_SENSING) ---
+typedef struct {
+    char mode[16];          // Classifier decision, e.g. "FSK RF/50"
+    uint8_t protocol;       // Protocol being voted on (LfProtocolId)
+    uint8_t reads;          // Frames voted so far
+    uint8_t confidence;     // Consensus confidence, 0..100
+} SnifferStatus;
+
 // --- DATABASE CONFIG ---
 #define MAX_SLOTS 15      // Max signals stored
 #define NAME_LEN  10      // Max chars per name
@@ -43,13 +56,33 @@ extern uint8_t ui_needs_update;
 typedef struct {
     char name[NAME_LEN + 1]; 
     uint8_t is_active;       // 1 = Occupied, 0 = Empty
-    uint32_t protocol_data;  // Placeholder for real physics data
+    uint16_t payload_len;
+    const uint8_t *payload;  // Versioned payload (payload.h), in flash once committed
 } Signal;
 
 // Shared Global Data
 extern Signal signal_db[MAX_SLOTS];
 extern int8_t selected_slot_idx; 
 
+// --- TRANSMIT PLAYLIST (PAGE_TRANSMITTING cycles these slots when count > 0) ---
+typedef struct {
+    uint8_t slots[MAX_SLOTS];
+    uint8_t count;
+    uint8_t repeats;         // Passes of each signal before moving on
+    uint16_t gap_ms;         // Field left unloaded between signals
+    uint8_t version;         // Bumped on every change: the player restarts
+} TxPlaylist;
+
+typedef struct {
+    uint8_t slot;            // Signal on air
+    uint8_t item;            // Its position in the playlist
+    uint8_t count;           // Signals that made it into the playlist
+    uint8_t pass;
+    uint32_t loops;          // Whole-list cycles
+} PlaylistProgress;
+
+extern TxPlaylist tx_playlist;
+
 // --- PUBLIC FUNCTIONS ---
 
 /**
@@ -73,6 +106,30 @@ void UI_Refresh(void);
  */
 void UI_Handle_Touch(uint16_t x, uint16_t y);
 
+/**
+ * @brief  Dispatches a recognized gesture (taps are forwarded to UI_Handle_Touch).
+ * @param  ev: Event produced by Gesture_Feed().
+ */
+void UI_Handle_Gesture(const GestureEvent *ev);
+
+/**
+ * @brief  Stores a captured tag in a free slot and opens the naming keyboard.
+ * @param  frame: First validated frame from the sniffer (protocol NONE and no
+ *                bits for an unidentified fob).
+ * @param  raw, raw_len: Raw edge-timing blob (rawcap.h), or NULL / 0.
+ */
+void UI_Signal_Captured(const LfFrame *frame, const uint8_t *raw, uint16_t raw_len);
+
+/**
+ * @brief  Publishes the sniffer's progress; redraws the status lines if they changed.
+ */
+void UI_Sniffer_Status(const SnifferStatus *status);
+
+/**
+ * @brief  Publishes playlist progress; redraws the progress lines if they changed.
+ */
+void UI_Playlist_Progress(const PlaylistProgress *progress);
+
 /**
  * @brief  Updates animations (cursors, hex dumps) without clearing the screen.
  */
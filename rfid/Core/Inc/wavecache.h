@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    wavecache.h
+  * @brief   Header for the emulation waveform cache.
+  * Expands a signal payload into the TIM1 period list that plays it (raw
+  * captures are decoded, decoded IDs are re-modulated from their protocol
+  * descriptor) and keeps the result for recently used signals in a fixed RAM
+  * pool with LRU eviction, so starting an emulation is only a DMA pointer
+  * swap. Entries are keyed by a hash of the payload bytes, which survive the
+  * blob moving between RAM and flash. No HAL dependencies.
+  ******************************************************************************
+  */
+
+#ifndef WAVECACHE_H
+#define WAVECACHE_H
+
+#include <stdint.h>
+
+#define WAVE_POOL_WORDS    6144   // 12 KB of ARR values shared by all entries
+#define WAVE_MAX_ENTRIES   16     // A full playlist stays cached
+#define WAVE_TICKS_PER_CYCLE 2    // Half-cycle resolution: PSK at RF/2 toggles every cycle
+
+// A ready-to-play timeline: one ARR value per run, an even number of runs
+typedef struct {
+    const uint16_t *arr;
+    uint16_t runs;
+    uint8_t first_level;    // Envelope level of arr[0] (1 = high, switch open)
+} WaveTimeline;
+
+typedef struct {
+    uint16_t entries;
+    uint32_t bytes_used;
+    uint32_t bytes_total;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} WaveStats;
+
+// --- PROTOTYPES ---
+
+/**
+ * @brief  Cached timeline for a payload (marks it most recently used).
+ * @return 0 on a miss.
+ */
+uint8_t Wave_Lookup(const uint8_t *payload, WaveTimeline *out);
+
+/**
+ * @brief  Expands a payload into the pool, evicting least recently used
+ *         entries (never locked ones) until it fits.
+ * @return 0 if the payload has nothing to play or cannot fit.
+ */
+uint8_t Wave_Build(const uint8_t *payload, WaveTimeline *out);
+
+/**
+ * @brief  1 if the payload holds a raw capture or an ID whose protocol can be
+ *         re-modulated.
+ */
+uint8_t Wave_CanPlay(const uint8_t *payload);
+
+/**
+ * @brief  Protects a timeline being played from eviction (several may be
+ *         locked at once). NULL releases all of them.
+ */
+void Wave_Lock(const WaveTimeline *tl);
+
+void Wave_Stats(WaveStats *out);
+
+#endif // WAVECACHE_H
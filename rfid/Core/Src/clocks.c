@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    clocks.c
+  * @brief   Clock profile table and clock tree derivation.
+  *
+  * Device limits (STM32F401, 2.7-3.6 V): HCLK 84 MHz at scale 2 and 60 MHz
+  * at scale 3, APB1 42 MHz, APB2 84 MHz, one flash wait state per started
+  * 30 MHz of HCLK.
+  ******************************************************************************
+  */
+
+#include "clocks.h"
+#include <stddef.h>
+
+#define HCLK_MAX_SCALE2  84000000u
+#define HCLK_MAX_SCALE3  60000000u
+#define PCLK1_MAX        42000000u
+#define PCLK2_MAX        84000000u
+#define FLASH_WS_STEP    30000000u
+
+static const ClockProfile profiles[CLOCK_PROFILE_COUNT] = {
+    // FULL must match SystemClock_Config (the tree the board boots into)
+    [CLOCK_FULL] = { "FULL", 1, 16, 4, 7, 336, 1, 2, 1, 2 },
+    [CLOCK_IDLE] = { "IDLE", 0, 0, 0, 0, 0, 1, 1, 1, 3 },
+};
+
+/* Timer kernel clock: the bus clock, doubled when the bus is divided */
+static uint32_t Timer_Clock(uint32_t hclk, uint8_t div) {
+    return (div == 1) ? hclk : 2u * (hclk / div);
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+const ClockProfile* Clock_Profile(ClockProfileId id) {
+    return (id < CLOCK_PROFILE_COUNT) ? &profiles[id] : NULL;
+}
+
+uint8_t Clock_SpiBr(uint32_t pclk, uint32_t max_hz) {
+    uint8_t br = 0;
+    while (br < 7 && (pclk >> (br + 1)) > max_hz) br++;
+    return br;
+}
+
+uint32_t Clock_Ns(uint32_t count, uint32_t hz) {
+    return (uint32_t)((uint64_t)count * 1000u / (hz / 1000000u));
+}
+
+uint32_t Clock_TickCatchUp(uint32_t partial_ns, uint32_t slept_ns, uint32_t *carry_ns) {
+    // The SysTick restarts with a full period on wakeup: what is left over is
+    // already elapsed towards the next tick and is owed to the next sleep.
+    // Nanoseconds: whole microseconds would drop up to 2 us per sleep
+    uint32_t total = *carry_ns + partial_ns + slept_ns;
+    *carry_ns = total % 1000000u;
+    return total / 1000000u;
+}
+
+uint8_t Clock_Derive(const ClockProfile *p, ClockTree *out) {
+    out->sysclk = p->use_pll ? CLOCK_HSI_HZ / p->pll_m * p->pll_n / p->pll_p : CLOCK_HSI_HZ;
+    out->hclk = out->sysclk / p->ahb_div;
+    out->pclk1 = out->hclk / p->apb1_div;
+    out->pclk2 = out->hclk / p->apb2_div;
+    out->tim3_clk = Timer_Clock(out->hclk, p->apb1_div);
+    out->tim1_clk = Timer_Clock(out->hclk, p->apb2_div);
+    out->us_psc = (uint16_t)(out->tim3_clk / 1000000u - 1);
+    out->flash_ws = (uint8_t)((out->hclk - 1) / FLASH_WS_STEP);
+    out->lcd_br = Clock_SpiBr(out->pclk2, CLOCK_LCD_SPI_MAX_HZ);
+    out->touch_br = Clock_SpiBr(out->pclk1, CLOCK_TOUCH_SPI_MAX_HZ);
+
+    if (out->hclk > ((p->vos == 3) ? HCLK_MAX_SCALE3 : HCLK_MAX_SCALE2)) return 0;
+    if (out->pclk1 > PCLK1_MAX || out->pclk2 > PCLK2_MAX) return 0;
+    if ((out->pclk1 >> (out->touch_br + 1)) > CLOCK_TOUCH_SPI_MAX_HZ) return 0; // Out of dividers
+    return 1;
+}
@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file    display.c
+  * @brief   Backlight PWM and panel sleep.
+  ******************************************************************************
+  */
+
+#include "display.h"
+#include "ili9341.h"
+#include "power.h"
+
+typedef enum {
+    DISP_ON,
+    DISP_DIM,
+    DISP_ASLEEP
+} DispState;
+
+static DispState state = DISP_ON;
+static uint32_t last_touch;
+static uint8_t swallow;       // Waking touch still held
+
+// --- PUBLIC FUNCTIONS ---
+
+void Display_Init(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_TIM4_CLK_ENABLE();
+
+    GPIO_InitStruct.Pin = GPIO_PIN_8;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = GPIO_AF2_TIM4;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    TIM4->CR1 = TIM_CR1_ARPE;
+    TIM4->PSC = Power_Tree()->us_psc; // Follows the clock profile (power.c)
+    TIM4->ARR = DISPLAY_PWM_PERIOD - 1;
+    // CH3 PWM1 without preload: a new duty applies at once, even right before stop mode
+    TIM4->CCMR2 = (6u << TIM_CCMR2_OC3M_Pos);
+    TIM4->CCER = TIM_CCER_CC3E;
+    TIM4->EGR = TIM_EGR_UG;
+    TIM4->CR1 |= TIM_CR1_CEN;
+
+    Display_SetBacklight(DISPLAY_BL_FULL);
+    state = DISP_ON;
+    last_touch = HAL_GetTick();
+}
+
+void Display_SetBacklight(uint8_t percent) {
+    if (percent > 100) percent = 100;
+    TIM4->CCR3 = (uint32_t)percent * DISPLAY_PWM_PERIOD / 100u;
+}
+
+uint8_t Display_Poll(uint32_t now_ms, uint8_t touched, uint8_t keep_on) {
+    if (swallow) {
+        swallow = touched;
+        if (touched) last_touch = now_ms;
+        return swallow;
+    }
+
+    if (touched || keep_on) {
+        last_touch = now_ms;
+        if (state == DISP_ASLEEP) {
+            LCD_Wake();
+            Display_SetBacklight(DISPLAY_BL_FULL);
+            state = DISP_ON;
+            swallow = touched;
+            return swallow;
+        }
+        if (state == DISP_DIM) Display_SetBacklight(DISPLAY_BL_FULL);
+        state = DISP_ON;
+        return 0;
+    }
+
+    uint32_t idle = now_ms - last_touch;
+    if (state == DISP_ON) {
+        if (idle < DISPLAY_DIM_MS) {
+            Power_WakeBy(last_touch + DISPLAY_DIM_MS);
+            return 0;
+        }
+        Display_SetBacklight(DISPLAY_BL_DIM);
+        state = DISP_DIM;
+    }
+    if (state == DISP_DIM) {
+        if (idle < DISPLAY_SLEEP_MS) {
+            Power_WakeBy(last_touch + DISPLAY_SLEEP_MS);
+            return 0;
+        }
+        Display_SetBacklight(0);
+        LCD_Sleep();
+        state = DISP_ASLEEP;
+    }
+    return 0;
+}
+
+uint8_t Display_IsAsleep(void) {
+    return state == DISP_ASLEEP;
+}
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    dsp.c
+  * @brief   Fixed-point pipeline stages (DC removal, decimation, slicing).
+  *
+  * Sample pairs are handled as one 32-bit word so the Cortex-M4 SIMD
+  * instructions (QSUB16, QADD16, SMLAD) do two lanes per cycle. Every
+  * intrinsic has a plain C equivalent, so the same code builds on a host.
+  ******************************************************************************
+  */
+
+#include "dsp.h"
+#include "arena.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#define DSP_SIMD 1
+#endif
+
+// --- LANE HELPERS ---
+
+static inline uint32_t Load_Pair(const int16_t *p) {
+    uint32_t w;
+    memcpy(&w, p, 4); // Single LDR on the target
+    return w;
+}
+
+static inline void Store_Pair(int16_t *p, uint32_t w) {
+    memcpy(p, &w, 4);
+}
+
+static inline uint32_t Pack(int16_t lo, int16_t hi) {
+    return (uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+#ifndef DSP_SIMD
+static inline int16_t Sat16(int32_t v) {
+    return (v > 32767) ? 32767 : (v < -32768) ? -32768 : (int16_t)v;
+}
+#endif
+
+/* Per-lane saturating a - b */
+static inline uint32_t Qsub2(uint32_t a, uint32_t b) {
+#ifdef DSP_SIMD
+    return __QSUB16(a, b);
+#else
+    return Pack(Sat16((int16_t)a - (int16_t)b), Sat16((int16_t)(a >> 16) - (int16_t)(b >> 16)));
+#endif
+}
+
+/* Per-lane saturating a + b */
+static inline uint32_t Qadd2(uint32_t a, uint32_t b) {
+#ifdef DSP_SIMD
+    return __QADD16(a, b);
+#else
+    return Pack(Sat16((int16_t)a + (int16_t)b), Sat16((int16_t)(a >> 16) + (int16_t)(b >> 16)));
+#endif
+}
+
+/* acc + lo + hi (dual multiply-accumulate against {1, 1}) */
+static inline int32_t Sum2(uint32_t pair, int32_t acc) {
+#ifdef DSP_SIMD
+    return (int32_t)__SMLAD(pair, 0x00010001u, (uint32_t)acc);
+#else
+    return acc + (int16_t)pair + (int16_t)(pair >> 16);
+#endif
+}
+
+// --- PIPELINE ---
+
+RAMFUNC uint16_t Dsp_Run(const DspStage *stages, uint8_t count, int16_t *buf, uint16_t n) {
+    for (uint8_t i = 0; i < count && n > 0; i++) {
+        n = stages[i].process(stages[i].ctx, buf, n);
+    }
+    return n;
+}
+
+// --- DC REMOVAL ---
+
+void Dsp_DcBlock_Init(DspDcBlock *s, uint8_t shift, int16_t initial) {
+    s->dc = (int32_t)initial << 16;
+    s->shift = shift;
+}
+
+RAMFUNC uint16_t Dsp_DcBlock(void *ctx, int16_t *buf, uint16_t n) {
+    DspDcBlock *s = (DspDcBlock *)ctx;
+    int32_t dc = s->dc;
+    uint16_t i = 0;
+
+    // Two samples per step against the same mean, then update with their average
+    for (; i + 1 < n; i += 2) {
+        uint32_t pair = Load_Pair(&buf[i]);
+        int16_t mean = (int16_t)(dc >> 16);
+        Store_Pair(&buf[i], Qsub2(pair, Pack(mean, mean)));
+        int32_t avg = ((int32_t)(int16_t)pair + (int16_t)(pair >> 16)) << 15;
+        dc += (avg - dc) >> s->shift;
+    }
+    if (i < n) {
+        int16_t x = buf[i];
+        buf[i] = (int16_t)(x - (dc >> 16));
+        dc += (((int32_t)x << 16) - dc) >> s->shift;
+    }
+
+    s->dc = dc;
+    return n;
+}
+
+// --- DECIMATOR ---
+
+void Dsp_Decimator_Init(DspDecimator *s, uint8_t log2_factor) {
+    s->log2_factor = log2_factor ? log2_factor : 1;
+}
+
+RAMFUNC uint16_t Dsp_Decimate(void *ctx, int16_t *buf, uint16_t n) {
+    const DspDecimator *s = (const DspDecimator *)ctx;
+    uint16_t factor = 1u << s->log2_factor;
+    uint16_t out = 0;
+
+    // Output k only depends on inputs >= k * factor, so writing in place is safe
+    for (uint16_t i = 0; i + factor <= n; i += factor) {
+        int32_t acc = 0;
+        for (uint16_t j = 0; j < factor; j += 2) {
+            acc = Sum2(Load_Pair(&buf[i + j]), acc);
+        }
+        buf[out++] = (int16_t)(acc >> s->log2_factor);
+    }
+    return out;
+}
+
+// --- SLICER ---
+
+void Dsp_Slicer_Init(DspSlicer *s, int16_t decay, int16_t min_span) {
+    s->hi = 0;
+    s->lo = 0;
+    s->decay = decay;
+    s->min_span = min_span;
+    s->level = DSP_SLICE_LOW;
+}
+
+RAMFUNC uint16_t Dsp_Slice(void *ctx, int16_t *buf, uint16_t n) {
+    DspSlicer *s = (DspSlicer *)ctx;
+    uint32_t decay = Pack(s->decay, (int16_t)-s->decay); // {lo rises, hi falls}
+    int16_t lo = s->lo, hi = s->hi;
+    int16_t level = s->level;
+
+    for (uint16_t i = 0; i < n; i++) {
+        int16_t x = buf[i];
+        if (x > hi) hi = x;
+        if (x < lo) lo = x;
+
+        int32_t span = (int32_t)hi - lo;
+        if (span >= s->min_span) {
+            int32_t mid = ((int32_t)hi + lo) >> 1;
+            int32_t hyst = span >> 3;
+            if (level == DSP_SLICE_LOW && x > mid + hyst) level = DSP_SLICE_HIGH;
+            else if (level == DSP_SLICE_HIGH && x < mid - hyst) level = DSP_SLICE_LOW;
+        }
+        buf[i] = level;
+
+        // Both extremes relax towards each other in one saturating step
+        uint32_t env = Qadd2(Pack(lo, hi), decay);
+        lo = (int16_t)env;
+        hi = (int16_t)(env >> 16);
+        if (hi < lo) hi = lo = (int16_t)(((int32_t)hi + lo) >> 1);
+    }
+
+    s->lo = lo;
+    s->hi = hi;
+    s->level = level;
+    return n;
+}
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    events.c
+  * @brief   Lock-free multi-producer, single-consumer event ring.
+  *
+  * Every slot carries a sequence number counted in laps of the ring: the
+  * slot for position 'pos' is free for the producer that claims 'pos' when
+  * its sequence equals LAP(pos), and holds a published event for the
+  * consumer when it equals LAP(pos) + 1. Zeroed memory is an empty ring.
+  * Producers race only on 'head', through a compare-and-swap; the event is
+  * written into the claimed slot and then released by storing the sequence.
+  * A producer interrupted between the claim and the release just delays the
+  * consumer at that slot, it never corrupts it.
+  *
+  * The GCC atomic builtins compile to LDREX/STREX loops on the Cortex-M4
+  * (exception entry clears the exclusive monitor, so an interrupted claim
+  * retries), and to native atomics on a host.
+  ******************************************************************************
+  */
+
+#include "events.h"
+
+#define MASK    (EVENTS_QUEUE_LEN - 1)
+#define LAP(p)  ((p) & ~(uint32_t)MASK)
+
+typedef struct {
+    volatile uint32_t seq;
+    Event ev;
+} Slot;
+
+static Slot ring[EVENTS_QUEUE_LEN];
+
+static volatile uint32_t head;    // Next position to claim (producers)
+static uint32_t tail;             // Next position to take (consumer)
+static volatile uint32_t posted[EVT_TYPE_COUNT];
+static volatile uint32_t dropped;
+
+// --- PUBLIC FUNCTIONS ---
+
+uint8_t Events_Post(EventType type, uint16_t arg) {
+    uint32_t pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    Slot *s;
+
+    for (;;) {
+        s = &ring[pos & MASK];
+        uint32_t seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        if (seq != LAP(pos)) {
+            if ((int32_t)(seq - LAP(pos)) < 0) {
+                // Still holds the event from one lap ago: ring full
+                __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+                return 0;
+            }
+            pos = __atomic_load_n(&head, __ATOMIC_RELAXED); // Claimed by someone else
+            continue;
+        }
+        // On failure 'pos' is reloaded with the current head
+        if (__atomic_compare_exchange_n(&head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+    }
+
+    s->ev.type = (uint16_t)type;
+    s->ev.arg = arg;
+    __atomic_store_n(&s->seq, LAP(pos) + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&posted[type], 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+uint8_t Events_Get(Event *out) {
+    Slot *s = &ring[tail & MASK];
+
+    if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != LAP(tail) + 1) return 0;
+    *out = s->ev;
+    // Free the slot for the producer one lap ahead
+    __atomic_store_n(&s->seq, LAP(tail) + EVENTS_QUEUE_LEN, __ATOMIC_RELEASE);
+    tail++;
+    return 1;
+}
+
+uint32_t Events_Posted(EventType type) {
+    return posted[type];
+}
+
+uint32_t Events_Dropped(void) {
+    return dropped;
+}
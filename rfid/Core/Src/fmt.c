@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    fmt.c
+  * @brief   Fixed-buffer string and number formatting.
+  ******************************************************************************
+  */
+
+#include "fmt.h"
+
+// --- PRIVATE HELPERS ---
+
+static void Put(Fmt *f, char c) {
+    if (f->len + 1u >= f->cap) return; // Full: keep the terminator
+    f->buf[f->len++] = c;
+    f->buf[f->len] = '\0';
+}
+
+static void Fill(Fmt *f, uint8_t n) {
+    while (n--) Put(f, ' ');
+}
+
+/* Appends 'n' chars of 's' inside a field of 'width' */
+static uint16_t Field(Fmt *f, const char *s, uint8_t n, int8_t width) {
+    uint8_t w = (width < 0) ? (uint8_t)-width : (uint8_t)width;
+    uint8_t pad = (w > n) ? (w - n) : 0;
+
+    if (width > 0) Fill(f, pad);
+    while (n--) Put(f, *s++);
+    if (width < 0) Fill(f, pad);
+    return f->len;
+}
+
+/* Decimal digits of 'v' at the end of 'tmp' (10 chars); returns the first */
+static char* Digits(char *tmp, uint32_t v) {
+    char *p = tmp + 10;
+    do {
+        *--p = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v);
+    return p;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Fmt_Init(Fmt *f, char *buf, uint16_t cap) {
+    f->buf = buf;
+    f->cap = cap;
+    f->len = 0;
+    if (cap) buf[0] = '\0';
+}
+
+uint16_t Fmt_Char(Fmt *f, char c) {
+    Put(f, c);
+    return f->len;
+}
+
+uint16_t Fmt_Str(Fmt *f, const char *s) {
+    while (*s) Put(f, *s++);
+    return f->len;
+}
+
+uint16_t Fmt_StrW(Fmt *f, const char *s, int8_t width) {
+    uint8_t n = 0;
+    while (s[n] && n < 255) n++;
+    return Field(f, s, n, width);
+}
+
+uint16_t Fmt_Uint(Fmt *f, uint32_t v) {
+    return Fmt_UintW(f, v, 0);
+}
+
+uint16_t Fmt_UintW(Fmt *f, uint32_t v, int8_t width) {
+    char tmp[10];
+    char *p = Digits(tmp, v);
+    return Field(f, p, (uint8_t)(tmp + 10 - p), width);
+}
+
+uint16_t Fmt_Int(Fmt *f, int32_t v) {
+    if (v < 0) {
+        Put(f, '-');
+        return Fmt_Uint(f, 0u - (uint32_t)v);
+    }
+    return Fmt_Uint(f, (uint32_t)v);
+}
+
+uint16_t Fmt_Hex(Fmt *f, uint32_t v, uint8_t digits) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (digits > 8) digits = 8;
+    while (digits--) Put(f, hex[(v >> (digits * 4u)) & 0xFu]);
+    return f->len;
+}
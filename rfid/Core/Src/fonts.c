@@ -132,6 +132,26 @@ FontDef Font_7x10 = {7, 10, Font7x10_Data};
 
 // --- DRAWING FUNCTIONS ---
 
+/* Glyph as one window, rows sent as runs of equal color */
+static void Char_Window(const uint16_t *glyph, FontDef font, uint16_t color, uint16_t bgcolor) {
+    LCD_SetAddress(LCD_CurrentX, LCD_CurrentY, LCD_CurrentX + font.width - 1, LCD_CurrentY + font.height - 1);
+
+    uint8_t ink = glyph[0] & 0x01;
+    uint32_t run = 0;
+    for (uint32_t j = 0; j < font.height; j++) {
+        for (uint32_t i = 0; i < font.width; i++) {
+            uint8_t bit = (glyph[i] >> j) & 0x01;
+            if (bit != ink) {
+                LCD_PushColor(ink ? color : bgcolor, run);
+                ink = bit;
+                run = 0;
+            }
+            run++;
+        }
+    }
+    LCD_PushColor(ink ? color : bgcolor, run);
+}
+
 void LCD_WriteChar(char ch, FontDef font, uint16_t color, uint16_t bgcolor) {
     uint32_t i, j;
 
@@ -139,6 +159,13 @@ void LCD_WriteChar(char ch, FontDef font, uint16_t color, uint16_t bgcolor) {
 
     int char_offset = (ch - 32) * font.width;
 
+    if (LCD_CurrentX + font.width <= ILI9341_WIDTH && LCD_CurrentY + font.height <= ILI9341_HEIGHT) {
+        Char_Window(&font.data[char_offset], font, color, bgcolor);
+        LCD_CurrentX += font.width;
+        return;
+    }
+
+    // Clipped at the screen edge: pixel by pixel
     for (i = 0; i < font.width; i++) {
         uint16_t columnData = font.data[char_offset + i];
 
@@ -157,6 +184,7 @@ void LCD_WriteString(const char* str, uint16_t x, uint16_t y, FontDef font, uint
     LCD_CurrentX = x;
     LCD_CurrentY = y;
     
+    LCD_Select(); // One transaction for the whole string
     while (*str) {
         if (*str == '\n') {
             LCD_CurrentY += font.height;
@@ -168,4 +196,5 @@ void LCD_WriteString(const char* str, uint16_t x, uint16_t y, FontDef font, uint
         LCD_WriteChar(*str, font, color, bgcolor);
         str++;
     }
+    LCD_Deselect();
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+  ******************************************************************************
+  * @file    gesture.c
+  * @brief   Touch gesture recognizer (tap, long-press, swipe, drag).
+  * Pure state machine over timestamped samples: no HAL calls, no delays.
+  ******************************************************************************
+  */
+
+#include "gesture.h"
+#include <stdlib.h>
+
+// --- RECOGNIZER STATE ---
+typedef enum {
+    G_IDLE,       // No contact
+    G_PENDING,    // Contact seen, waiting out the debounce time
+    G_PRESSED,    // Confirmed, stationary
+    G_LONG,       // Long-press already reported, waiting for release
+    G_DRAGGING    // Moved beyond the slop radius
+} GestureState;
+
+static GestureState state = G_IDLE;
+static uint32_t first_contact_ms; // Start of the debounce window
+static uint32_t last_contact_ms;  // Most recent pressed sample
+static uint32_t down_ms;          // When the press was confirmed
+static uint16_t start_x, start_y; // Press-down position
+static uint16_t last_x, last_y;   // Most recent pressed position
+static uint16_t drag_x, drag_y;   // Position at the previous DRAG event
+
+/* Fills an event relative to the press-down position */
+static uint8_t Emit(GestureEvent *ev, GestureType type, int16_t dx, int16_t dy) {
+    ev->type = type;
+    ev->x = start_x;
+    ev->y = start_y;
+    ev->dx = dx;
+    ev->dy = dy;
+    return 1;
+}
+
+/* Classifies a completed drag as a swipe (fast, long) or a plain drag end */
+static uint8_t Finish_Drag(GestureEvent *ev) {
+    int16_t dx = (int16_t)last_x - (int16_t)start_x;
+    int16_t dy = (int16_t)last_y - (int16_t)start_y;
+    uint32_t duration = last_contact_ms - down_ms;
+
+    if (duration <= GESTURE_SWIPE_MAX_MS) {
+        if (abs(dx) >= abs(dy) && abs(dx) >= GESTURE_SWIPE_MIN_PX) {
+            return Emit(ev, (dx > 0) ? GESTURE_SWIPE_RIGHT : GESTURE_SWIPE_LEFT, dx, dy);
+        }
+        if (abs(dy) > abs(dx) && abs(dy) >= GESTURE_SWIPE_MIN_PX) {
+            return Emit(ev, (dy > 0) ? GESTURE_SWIPE_DOWN : GESTURE_SWIPE_UP, dx, dy);
+        }
+    }
+    return Emit(ev, GESTURE_DRAG_END, dx, dy);
+}
+
+void Gesture_Reset(void) {
+    state = G_IDLE;
+}
+
+uint8_t Gesture_Feed(uint8_t pressed, uint16_t x, uint16_t y, uint32_t now_ms, GestureEvent *ev) {
+    if (pressed) {
+        last_contact_ms = now_ms;
+        last_x = x;
+        last_y = y;
+
+        switch (state) {
+            case G_IDLE:
+                state = G_PENDING;
+                first_contact_ms = now_ms;
+                return 0;
+
+            case G_PENDING:
+                if (now_ms - first_contact_ms < GESTURE_DEBOUNCE_MS) return 0;
+                state = G_PRESSED;
+                down_ms = now_ms;
+                start_x = drag_x = x;
+                start_y = drag_y = y;
+                return Emit(ev, GESTURE_DOWN, 0, 0);
+
+            case G_PRESSED:
+                if (abs((int16_t)x - (int16_t)start_x) > GESTURE_SLOP_PX ||
+                    abs((int16_t)y - (int16_t)start_y) > GESTURE_SLOP_PX) {
+                    state = G_DRAGGING;
+                    break; // Report the first movement below
+                }
+                if (now_ms - down_ms >= GESTURE_LONG_PRESS_MS) {
+                    state = G_LONG;
+                    return Emit(ev, GESTURE_LONG_PRESS, 0, 0);
+                }
+                return 0;
+
+            case G_LONG:
+                return 0;
+
+            case G_DRAGGING:
+                break;
+        }
+
+        // Dragging: report movement since the previous drag event
+        if (x == drag_x && y == drag_y) return 0;
+        int16_t dx = (int16_t)x - (int16_t)drag_x;
+        int16_t dy = (int16_t)y - (int16_t)drag_y;
+        drag_x = x;
+        drag_y = y;
+        return Emit(ev, GESTURE_DRAG, dx, dy);
+    }
+
+    // --- No contact ---
+    switch (state) {
+        case G_IDLE:
+            return 0;
+
+        case G_PENDING:
+            // Bounce during debounce: not a press
+            state = G_IDLE;
+            return 0;
+
+        default:
+            // Resistive panels drop out briefly under light pressure; ride through it
+            if (now_ms - last_contact_ms < GESTURE_RELEASE_MS) return 0;
+            break;
+    }
+
+    GestureState released = state;
+    state = G_IDLE;
+
+    if (released == G_PRESSED) return Emit(ev, GESTURE_TAP, 0, 0);
+    if (released == G_DRAGGING) return Finish_Drag(ev);
+    return Emit(ev, GESTURE_LONG_END, 0, 0);
+}
+
+uint8_t Gesture_IsRelease(GestureType type) {
+    return type == GESTURE_TAP || type == GESTURE_LONG_END || type == GESTURE_DRAG_END ||
+           (type >= GESTURE_SWIPE_LEFT && type <= GESTURE_SWIPE_DOWN);
+}
@@ -0,0 +1,262 @@
+/**
+  ******************************************************************************
+  * @file    gfx.c
+  * @brief   2D primitives as windowed color runs.
+  *
+  * Setting a window costs 11 bytes of commands; a run of n pixels then costs
+  * 2n bytes in one burst. So lines are cut into their straight runs
+  * (horizontal for shallow lines, vertical for steep ones), circles into the
+  * runs of each octant, and bitmaps into one window with a burst per change
+  * of color.
+  *
+  * Circles and rounded rectangles share one routine: a circle is a rounded
+  * rectangle whose four corner centers coincide.
+  ******************************************************************************
+  */
+
+#include "gfx.h"
+#include "ili9341.h"
+#include <stdlib.h>
+
+// --- PRIVATE HELPERS ---
+
+/* Clipped solid window */
+static void Span(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > ILI9341_WIDTH) w = ILI9341_WIDTH - x;
+    if (y + h > ILI9341_HEIGHT) h = ILI9341_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    LCD_SetAddress(x, y, x + w - 1, y + h - 1);
+    LCD_PushColor(color, (uint32_t)w * h);
+}
+
+static uint8_t On_Screen(int16_t x, int16_t y, int16_t w, int16_t h) {
+    return x >= 0 && y >= 0 && x + w <= ILI9341_WIDTH && y + h <= ILI9341_HEIGHT;
+}
+
+/* Octant runs x in [a, b] at distance y, around corner centers (l, t) and (r, b)
+   (left/top half of the shape and right/bottom half) */
+static void Arc_Runs(int16_t l, int16_t rx, int16_t t, int16_t by,
+                     int16_t a, int16_t b, int16_t y, uint16_t color) {
+    int16_t n = b - a + 1;
+
+    Span(rx + a, by + y, n, 1, color); // Bottom right, shallow
+    Span(l - b,  by + y, n, 1, color); // Bottom left
+    Span(rx + a, t - y,  n, 1, color); // Top right
+    Span(l - b,  t - y,  n, 1, color); // Top left
+    Span(rx + y, by + a, 1, n, color); // Right, steep
+    Span(rx + y, t - b,  1, n, color);
+    Span(l - y,  by + a, 1, n, color); // Left
+    Span(l - y,  t - b,  1, n, color);
+}
+
+/* Midpoint circle of radius 'r' split into four quadrants at the corner centers */
+static void Arcs(int16_t l, int16_t rx, int16_t t, int16_t by, int16_t r, uint16_t color) {
+    int16_t x = 0, y = r, d = 1 - r, x0 = 0;
+
+    while (x <= y) {
+        int16_t nx = x + 1, ny = y;
+        if (d < 0) {
+            d += 2 * x + 3;
+        } else {
+            d += 2 * (x - y) + 5;
+            ny = y - 1;
+        }
+        if (ny != y || nx > ny) {
+            // Run at this distance ends here
+            Arc_Runs(l, rx, t, by, x0, x, y, color);
+            x0 = nx;
+        }
+        x = nx;
+        y = ny;
+    }
+}
+
+/* Filled version of Arcs(): one row span per line */
+static void Fill_Arcs(int16_t l, int16_t rx, int16_t t, int16_t by, int16_t r, uint16_t color) {
+    int16_t x = 0, y = r, d = 1 - r;
+
+    while (x <= y) {
+        // Rows near the centers, half width y
+        Span(l - y, by + x, rx - l + 2 * y + 1, 1, color);
+        if (x != 0 || t != by) Span(l - y, t - x, rx - l + 2 * y + 1, 1, color);
+
+        int16_t ny = y;
+        if (d < 0) {
+            d += 2 * x + 3;
+        } else {
+            d += 2 * (x - y) + 5;
+            ny = y - 1;
+        }
+        if (ny != y && y != x) {
+            // Rows near the ends, half width x (the widest at this distance)
+            Span(l - x, by + y, rx - l + 2 * x + 1, 1, color);
+            Span(l - x, t - y,  rx - l + 2 * x + 1, 1, color);
+        }
+        x++;
+        y = ny;
+    }
+}
+
+static int16_t Clamp_Radius(int16_t w, int16_t h, int16_t r) {
+    int16_t m = ((w < h) ? w : h) / 2;
+    if (r > m) r = m;
+    return (r < 0) ? 0 : r;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Gfx_Begin(void) {
+    LCD_Select();
+}
+
+void Gfx_End(void) {
+    LCD_Deselect();
+}
+
+void Gfx_HLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    LCD_Select();
+    Span(x, y, w, 1, color);
+    LCD_Deselect();
+}
+
+void Gfx_VLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    LCD_Select();
+    Span(x, y, 1, h, color);
+    LCD_Deselect();
+}
+
+void Gfx_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    LCD_Select();
+    Span(x, y, w, h, color);
+    LCD_Deselect();
+}
+
+void Gfx_Rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+
+    LCD_Select();
+    Span(x, y, w, 1, color);                 // Top
+    if (h > 1) Span(x, y + h - 1, w, 1, color); // Bottom
+    Span(x, y + 1, 1, h - 2, color);         // Left (corners already drawn)
+    if (w > 1) Span(x + w - 1, y + 1, 1, h - 2, color); // Right
+    LCD_Deselect();
+}
+
+void Gfx_RoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    r = Clamp_Radius(w, h, r);
+
+    LCD_Select();
+    Span(x + r, y, w - 2 * r, 1, color);
+    Span(x + r, y + h - 1, w - 2 * r, 1, color);
+    Span(x, y + r, 1, h - 2 * r, color);
+    Span(x + w - 1, y + r, 1, h - 2 * r, color);
+    if (r > 0) Arcs(x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, color);
+    LCD_Deselect();
+}
+
+void Gfx_FillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    r = Clamp_Radius(w, h, r);
+
+    LCD_Select();
+    Span(x, y + r + 1, w, h - 2 * r - 2, color); // Between the corner rows
+    Fill_Arcs(x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, color);
+    LCD_Deselect();
+}
+
+void Gfx_Line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t dx = abs(x1 - x0), dy = abs(y1 - y0);
+    int16_t sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
+    uint8_t steep = dy > dx;
+    int16_t err = (steep ? dy : dx) / 2;
+    int16_t major = steep ? dy : dx;
+    int16_t run = 1;
+
+    LCD_Select();
+    for (int16_t i = 0; i < major; i++) {
+        err -= steep ? dx : dy;
+        if (err < 0) {
+            // The minor coordinate steps: close the run
+            if (steep) Span(x0, (sy > 0) ? y0 : y0 - run + 1, 1, run, color);
+            else       Span((sx > 0) ? x0 : x0 - run + 1, y0, run, 1, color);
+            err += major;
+            if (steep) { x0 += sx; y0 += sy * run; }
+            else       { y0 += sy; x0 += sx * run; }
+            run = 1;
+        } else {
+            run++;
+        }
+    }
+    if (steep) Span(x0, (sy > 0) ? y0 : y0 - run + 1, 1, run, color);
+    else       Span((sx > 0) ? x0 : x0 - run + 1, y0, run, 1, color);
+    LCD_Deselect();
+}
+
+void Gfx_Circle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    LCD_Select();
+    Arcs(cx, cx, cy, cy, r, color);
+    LCD_Deselect();
+}
+
+void Gfx_FillCircle(int16_t cx, int16_t cy, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    LCD_Select();
+    Fill_Arcs(cx, cx, cy, cy, r, color);
+    LCD_Deselect();
+}
+
+void Gfx_Bitmap(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bits,
+                uint16_t fg, uint16_t bg) {
+    uint16_t stride = (w + 7) / 8;
+
+    if (w == 0 || h == 0) return;
+    LCD_Select();
+    if (!On_Screen(x, y, w, h)) {
+        // Clipped: pixel by pixel
+        for (uint8_t j = 0; j < h; j++) {
+            for (uint8_t i = 0; i < w; i++) {
+                uint8_t ink = (bits[j * stride + i / 8] >> (7 - i % 8)) & 1;
+                Span(x + i, y + j, 1, 1, ink ? fg : bg);
+            }
+        }
+        LCD_Deselect();
+        return;
+    }
+
+    LCD_SetAddress(x, y, x + w - 1, y + h - 1);
+    uint8_t ink = bits[0] >> 7;
+    uint32_t run = 0;
+    for (uint8_t j = 0; j < h; j++) {
+        for (uint8_t i = 0; i < w; i++) {
+            uint8_t bit = (bits[j * stride + i / 8] >> (7 - i % 8)) & 1;
+            if (bit != ink) {
+                LCD_PushColor(ink ? fg : bg, run);
+                ink = bit;
+                run = 0;
+            }
+            run++;
+        }
+    }
+    LCD_PushColor(ink ? fg : bg, run);
+    LCD_Deselect();
+}
+
+void Gfx_Icon(int16_t x, int16_t y, const GfxIcon *icon, uint16_t fg, uint16_t bg) {
+    uint32_t left = (uint32_t)icon->width * icon->height;
+
+    if (left == 0 || !On_Screen(x, y, icon->width, icon->height)) return;
+    LCD_Select();
+    LCD_SetAddress(x, y, x + icon->width - 1, y + icon->height - 1);
+    for (const uint8_t *p = icon->runs; left > 0; p++) {
+        uint32_t n = (*p & 0x7Fu) + 1u;
+        if (n > left) n = left; // Malformed tail: stay inside the window
+        LCD_PushColor((*p & 0x80u) ? fg : bg, n);
+        left -= n;
+    }
+    LCD_Deselect();
+}
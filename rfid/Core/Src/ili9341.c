@@ -8,28 +8,73 @@
 #include "ili9341.h"
 #include "spi.h"
 
+static uint8_t select_depth; // > 0: CS stays low between transfers
+
 // --- LOW LEVEL SPI WRAPPERS ---
 
+static void Cs_Low(void) {
+    if (select_depth == 0) HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+}
+
+static void Cs_High(void) {
+    if (select_depth == 0) HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+}
+
+void LCD_Select(void) {
+    if (select_depth++ == 0) HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+}
+
+void LCD_Deselect(void) {
+    if (select_depth == 0) return;
+    if (--select_depth == 0) HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+}
+
 void LCD_WriteCommand(uint8_t cmd) {
     HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+    Cs_Low();
     HAL_SPI_Transmit(&hspi1, &cmd, 1, 10);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+    Cs_High();
 }
 
 void LCD_WriteData(uint8_t data) {
     HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+    Cs_Low();
     HAL_SPI_Transmit(&hspi1, &data, 1, 10);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+    Cs_High();
 }
 
 void LCD_WriteData16(uint16_t data) {
     uint8_t bytes[] = { (data >> 8), (data & 0xFF) };
     HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+    Cs_Low();
     HAL_SPI_Transmit(&hspi1, bytes, 2, 10);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+    Cs_High();
+}
+
+/* Streams 'count' pixels of one color as 16-bit SPI frames, straight into DR.
+   The link is switched back to 8-bit frames for the HAL afterwards. */
+void LCD_PushColor(uint16_t color, uint32_t count) {
+    SPI_TypeDef *spi = hspi1.Instance;
+
+    if (count == 0) return;
+    HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_SET);
+    Cs_Low();
+
+    spi->CR1 &= ~SPI_CR1_SPE;
+    spi->CR1 |= SPI_CR1_DFF | SPI_CR1_SPE;
+    while (count--) {
+        while (!(spi->SR & SPI_SR_TXE));
+        spi->DR = color;
+    }
+    while (!(spi->SR & SPI_SR_TXE));
+    while (spi->SR & SPI_SR_BSY);
+    spi->CR1 &= ~(SPI_CR1_SPE | SPI_CR1_DFF);
+    spi->CR1 |= SPI_CR1_SPE;
+    // Nothing reads the receive side: drop the overrun it raised
+    (void)spi->DR;
+    (void)spi->SR;
+
+    Cs_High();
 }
 
 // --- DRAWING LOGIC ---
@@ -95,18 +140,32 @@ void LCD_FillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color
     if((x + w) > ILI9341_WIDTH) w = ILI9341_WIDTH - x;
     if((y + h) > ILI9341_HEIGHT) h = ILI9341_HEIGHT - y;
 
+    if (w == 0 || h == 0) return;
+
     LCD_SetAddress(x, y, x+w-1, y+h-1);
+    LCD_PushColor(color, (uint32_t)w * h); // Burst write pixel data
+}
 
-    // Burst write pixel data
-    uint8_t bytes[] = { (color >> 8), (color & 0xFF) };
-    HAL_GPIO_WritePin(LCD_DC_GPIO_Port, LCD_DC_Pin, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET);
+void LCD_SetScrollArea(uint16_t tfa, uint16_t vsa, uint16_t bfa) {
+    LCD_WriteCommand(0x33); // Vertical Scrolling Definition
+    LCD_WriteData(tfa >> 8); LCD_WriteData(tfa);
+    LCD_WriteData(vsa >> 8); LCD_WriteData(vsa);
+    LCD_WriteData(bfa >> 8); LCD_WriteData(bfa);
+}
 
-    for(uint32_t i = 0; i < (w*h); i++) {
-        HAL_SPI_Transmit(&hspi1, bytes, 2, 10);
-    }
+void LCD_SetScrollStart(uint16_t line) {
+    LCD_WriteCommand(0x37); // Vertical Scrolling Start Address
+    LCD_WriteData(line >> 8); LCD_WriteData(line);
+}
 
-    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET);
+void LCD_Sleep(void) {
+    LCD_WriteCommand(0x28); // Display Off: no garbage while the panel powers down
+    LCD_WriteCommand(0x10); // Sleep In
+}
+
+void LCD_Wake(void) {
+    LCD_WriteCommand(0x11); HAL_Delay(5); // Sleep Out: 5 ms before the next command
+    LCD_WriteCommand(0x29); // Display On
 }
 
 void LCD_FillColor(uint16_t color) {
@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file    layout.c
+  * @brief   Replay of precompiled page layouts.
+  ******************************************************************************
+  */
+
+#include "layout.h"
+#include "ili9341.h"
+#include "fonts.h"
+#include "gfx.h"
+#include "ui.h"
+
+// --- PUBLIC FUNCTIONS ---
+
+void Layout_ButtonFrame(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    Gfx_Begin();
+    Gfx_Rect(x, y, w, h, color);
+    // Corner glitch accents
+    Gfx_FillRect(x, y, 5, 5, color);
+    Gfx_FillRect(x + w - 5, y + h - 5, 5, 5, color);
+    Gfx_End();
+}
+
+void Layout_Draw(const LayoutCmd *cmds) {
+    Gfx_Begin();
+    for (const LayoutCmd *c = cmds; c->op != LAYOUT_END; c++) {
+        switch (c->op) {
+            case LAYOUT_TEXT:
+                LCD_WriteString(c->text, c->x, c->y, Font_7x10, c->color, COLOR_TERM_BG);
+                break;
+            case LAYOUT_FILL:
+                LCD_FillRect(c->x, c->y, c->w, c->h, c->color);
+                break;
+            case LAYOUT_FRAME:
+                Gfx_Rect(c->x, c->y, c->w, c->h, c->color);
+                break;
+            case LAYOUT_BUTTON:
+                Layout_ButtonFrame(c->x, c->y, c->w, c->h, c->alert ? COLOR_ALERT : COLOR_TERM_DIM);
+                LCD_WriteString(c->text, c->tx, c->ty, Font_7x10,
+                                c->alert ? COLOR_ALERT : COLOR_TERM_TEXT, COLOR_TERM_BG);
+                break;
+        }
+    }
+    Gfx_End();
+}
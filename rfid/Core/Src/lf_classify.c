@@ -0,0 +1,325 @@
+/**
+  ******************************************************************************
+  * @file    lf_classify.c
+  * @brief   Run-width histogram classifier: modulation and data rate.
+  *
+  * Subcarrier modulations show up as runs of a few carrier cycles (half
+  * subcarrier periods), ASK as runs of one or two half-bits. Within those:
+  *  - FSK: consecutive run pairs form two distinct periods (fc/8, fc/10);
+  *    the data rate is the shortest stretch of one period.
+  *  - PSK: a single period; longer runs are phase reversals and the data
+  *    rate is the shortest distance between them.
+  *  - ASK: the shortest prominent width is a half-bit; the rate is refined
+  *    over every run that is one or two half-bits long.
+  * Manchester and biphase share the same timing, so both map to ASK and
+  * the decoders tell them apart.
+  ******************************************************************************
+  */
+
+#include "lf_classify.h"
+#include "arena.h"
+#include "lf_protocols.h"
+#include "fmt.h"
+#include <string.h>
+
+#define HIST_BINS      64   // 2-cycle bins; the last one collects everything longer
+#define SUB_MAX_RUN    8    // Runs below this are subcarrier half-periods
+#define FSK_SPLIT      9    // Period threshold between fc/8 and fc/10
+#define MAX_INTERVALS  64
+#define MIN_INTERVALS  4    // Fewer cannot tell a bit period from its multiples
+#define MAX_PARTS      8    // Longest interval taken as a candidate bit period multiple
+#define LEVEL_BIT      0x8000u
+
+static uint16_t window[LF_CLASS_WINDOW] ARENA_RF; // bit 15 = level, bits 0-14 = cycles
+static uint16_t count;
+static uint8_t done;
+static LfClassResult result;
+
+// Common RF/n data rates; estimates within ~10% snap to these
+static const uint16_t std_rates[] = { 8, 16, 32, 40, 50, 64, 100, 128 };
+
+// --- PRIVATE HELPERS ---
+
+static uint16_t Width(uint16_t i) {
+    return window[i] & ~LEVEL_BIT;
+}
+
+static uint16_t Snap_Rate(uint32_t rate) {
+    for (uint8_t i = 0; i < sizeof(std_rates) / sizeof(std_rates[0]); i++) {
+        uint32_t r = std_rates[i];
+        if (rate * 10 >= r * 9 && rate * 10 <= r * 11) return (uint16_t)r;
+    }
+    return (uint16_t)rate;
+}
+
+/* Whole multiple of 'base16' (base x16) that 'v' lies within base / 'tol' of, or 0 */
+static uint32_t Multiple_Of(uint32_t v, uint32_t base16, uint32_t tol) {
+    uint32_t k = (v * 16 + base16 / 2) / base16;
+    if (k == 0) return 0;
+    uint32_t d = (v * 16 > k * base16) ? v * 16 - k * base16 : k * base16 - v * 16;
+    return (d * tol <= base16) ? k : 0;
+}
+
+/* 'base16' refined as total / total multiples over the intervals it explains
+   (up to 'max_k' periods long) */
+static uint32_t Refine(const uint16_t *v, uint16_t n, uint32_t base16, uint32_t tol, uint32_t max_k) {
+    uint32_t total = 0, mult = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t k = Multiple_Of(v[i], base16, tol);
+        if (!k || k > max_k) continue;
+        total += v[i];
+        mult += k;
+    }
+    return mult ? total * 16 / mult : 0;
+}
+
+/* 1 if 7/8 of the intervals lie near a whole multiple of 'base16' */
+static uint8_t Explains(const uint16_t *v, uint16_t n, uint32_t base16) {
+    uint32_t fit = 0;
+    for (uint16_t i = 0; i < n; i++) fit += Multiple_Of(v[i], base16, 5) != 0;
+    return fit * 8 >= n * 7u;
+}
+
+/* Mean distance of the intervals from a whole multiple of 'base16', in 1/256 period */
+static uint32_t Misfit(const uint16_t *v, uint16_t n, uint32_t base16) {
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t k = (v[i] * 16u + base16 / 2) / base16;
+        if (k == 0) k = 1;
+        uint32_t d = (v[i] * 16u > k * base16) ? v[i] * 16u - k * base16 : k * base16 - v[i] * 16u;
+        if (d * 2 > base16) d = base16 / 2;
+        sum += d * 256 / base16;
+    }
+    return sum / n;
+}
+
+/*
+ * Base period of a set of intervals that are whole multiples of it. The
+ * candidates are the standard rates and every interval split into
+ * 1..MAX_PARTS parts (a window may hold no single-bit interval at all),
+ * refined over the short intervals it roughly explains and then over all of
+ * them. Of those explaining 7/8 of the intervals, the one they sit closest
+ * to in periods wins (a fraction of the period sits as close in cycles, but
+ * not in periods), the longest on a tie. Too few intervals, or no common
+ * period, give 0.
+ */
+static uint16_t Base_Interval(const uint16_t *v, uint16_t n) {
+    uint32_t best = 0, best_misfit = UINT32_MAX;
+    uint16_t rates = sizeof(std_rates) / sizeof(std_rates[0]);
+
+    if (n < MIN_INTERVALS) return 0;
+    for (uint16_t i = 0; i < rates + n; i++) {
+        for (uint32_t parts = 1; parts <= MAX_PARTS; parts++) {
+            uint32_t base16;
+            if (i < rates) {
+                if (parts > 1) break;
+                base16 = std_rates[i] * 16u;
+            } else {
+                base16 = Refine(v, n, v[i - rates] * 16u / parts, 3, 2);
+                base16 = base16 ? Refine(v, n, base16, 3, UINT32_MAX) : 0;
+            }
+            if (base16 < 16 || !Explains(v, n, base16)) continue;
+
+            uint32_t m = Misfit(v, n, base16);
+            if (m < best_misfit || (m == best_misfit && base16 > best)) {
+                best = base16;
+                best_misfit = m;
+            }
+        }
+    }
+    return best ? (uint16_t)((Refine(v, n, best, 5, UINT32_MAX) + 8) / 16) : 0;
+}
+
+static void Classify_Ask(const uint16_t *hist) {
+    // Shortest prominent width: half a bit
+    uint16_t peak = 0;
+    for (uint8_t b = 0; b < HIST_BINS - 1; b++) {
+        if (hist[b] > peak) peak = hist[b];
+    }
+    uint8_t first = 0;
+    while (first < HIST_BINS - 1 && hist[first] * 4 < peak) first++;
+    uint32_t half = first * 2 + 1; // Bin centre
+    if (half < 2) return;
+
+    // Refine over runs of one or two half-bits
+    uint32_t sum = 0, halves = 0;
+    uint16_t fit = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t w = Width(i);
+        uint32_t k = (w + half / 2) / half;
+        if (k < 1 || k > 2) continue;
+        if (w * 3 < k * half * 2 || w * 3 > k * half * 4) continue; // Within a third
+        sum += w;
+        halves += k;
+        fit++;
+    }
+    if (halves == 0) return;
+
+    result.fit = (uint8_t)(fit * 100u / count);
+    if (result.fit < 80) return;
+    result.cls = LF_CLASS_ASK;
+    result.bit_cycles = Snap_Rate((2 * sum + halves / 2) / halves);
+}
+
+static void Classify_Fsk(void) {
+    uint16_t stretch[MAX_INTERVALS];
+    uint16_t n = 0;
+    uint32_t per_sum[2] = {0, 0};
+    uint16_t per_cnt[2] = {0, 0};
+    uint32_t acc = 0;
+    int8_t cls = -1;
+
+    // Same pairing as the decoder: every run with its predecessor is one period
+    for (uint16_t i = 1; i < count; i++) {
+        uint16_t period = Width(i - 1) + Width(i);
+        uint8_t c = (period > FSK_SPLIT) ? 1 : 0;
+        per_sum[c] += period;
+        per_cnt[c]++;
+
+        if (c != cls) {
+            // A bit spans several subcarrier periods; shorter stretches are jitter
+            if (acc >= 3 * FSK_SPLIT && n < MAX_INTERVALS) stretch[n++] = (uint16_t)acc;
+            cls = c;
+            acc = 0;
+        }
+        acc += Width(i);
+    }
+
+    // Both periods must be present in quantity
+    if (per_cnt[0] * 7 < count || per_cnt[1] * 7 < count) return;
+
+    result.cls = LF_CLASS_FSK;
+    result.sub_a = (uint8_t)((per_sum[0] + per_cnt[0] / 2) / per_cnt[0]);
+    result.sub_b = (uint8_t)((per_sum[1] + per_cnt[1] / 2) / per_cnt[1]);
+    result.fit = 100;
+    // The first stretch is cut by the window edge
+    if (n > 1) result.bit_cycles = Snap_Rate(Base_Interval(&stretch[1], n - 1));
+}
+
+static void Classify_Psk(const uint16_t *hist) {
+    // Most common short width: half a subcarrier period
+    uint8_t mode = 0;
+    for (uint8_t b = 1; b < SUB_MAX_RUN / 2; b++) {
+        if (hist[b] > hist[mode]) mode = b;
+    }
+    uint16_t half = (mode == 0) ? 1 : mode * 2;
+
+    uint16_t gap[MAX_INTERVALS];
+    uint16_t n = 0;
+    uint32_t acc = 0;
+    uint8_t seen = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        acc += Width(i);
+        if (Width(i) * 2 < 3 * half) continue; // Not a reversal
+        if (seen && n < MAX_INTERVALS) gap[n++] = (uint16_t)acc;
+        seen = 1;
+        acc = 0;
+    }
+
+    result.cls = LF_CLASS_PSK;
+    result.sub_a = (uint8_t)(half * 2);
+    result.fit = (uint8_t)(hist[mode] * 100u / count);
+    result.bit_cycles = Snap_Rate(Base_Interval(gap, n));
+}
+
+static void Decide(void) {
+    uint16_t hist[HIST_BINS];
+    uint16_t sub_runs = 0;
+
+    memset(hist, 0, sizeof(hist));
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t b = Width(i) / 2;
+        hist[b < HIST_BINS ? b : HIST_BINS - 1]++;
+        if (Width(i) < SUB_MAX_RUN) sub_runs++;
+    }
+
+    memset(&result, 0, sizeof(result));
+    if (sub_runs * 4 >= count * 3) {
+        Classify_Fsk();
+        if (result.cls == LF_CLASS_UNKNOWN) Classify_Psk(hist);
+    } else {
+        Classify_Ask(hist);
+    }
+    done = 1;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void LF_Classify_Reset(void) {
+    count = 0;
+    done = 0;
+    memset(&result, 0, sizeof(result));
+}
+
+uint8_t LF_Classify_Feed(uint8_t level, uint16_t cycles) {
+    if (done) return 0;
+
+    if (cycles > LF_CLASS_MAX_RUN) { // Gap or no tag: start over
+        count = 0;
+        return 0;
+    }
+    window[count++] = (level ? LEVEL_BIT : 0) | cycles;
+    if (count < LF_CLASS_WINDOW) return 0;
+
+    Decide();
+    return 1;
+}
+
+uint8_t LF_Classify_IsDone(void) {
+    return done;
+}
+
+const LfClassResult* LF_Classify_Result(void) {
+    return &result;
+}
+
+uint8_t LF_Classify_Apply(void) {
+    static const LfModulation mod_of[] = {
+        [LF_CLASS_ASK] = LF_MOD_ASK_MANCHESTER,
+        [LF_CLASS_FSK] = LF_MOD_FSK,
+        [LF_CLASS_PSK] = LF_MOD_PSK1,
+    };
+    uint8_t enabled = 0;
+
+    // Pass 0: modulation and rate must match. Pass 1: modulation only (rate estimate off).
+    for (uint8_t pass = 0; pass < 2 && !enabled; pass++) {
+        for (uint8_t i = 0; i < lf_protocol_count; i++) {
+            const LfProtocol *p = &lf_protocols[i];
+            uint8_t on = 1;
+            if (result.cls != LF_CLASS_UNKNOWN) {
+                on = (p->modulation == mod_of[result.cls]);
+                if (pass == 0) {
+                    uint16_t r = result.bit_cycles;
+                    on = on && r && p->bit_cycles * 8u >= r * 7u && p->bit_cycles * 8u <= r * 9u;
+                }
+            }
+            LF_Decoder_Enable(p->id, on);
+            enabled += on;
+        }
+    }
+    return enabled;
+}
+
+uint8_t LF_Classify_Replay(LfFrame *out) {
+    for (uint16_t i = 0; i < count; i++) {
+        if (LF_Decoder_Feed((window[i] & LEVEL_BIT) ? 1 : 0, Width(i), out)) return 1;
+    }
+    return 0;
+}
+
+void LF_Classify_Describe(char *out, uint8_t cap) {
+    static const char *names[] = { "UNKNOWN", "ASK", "FSK", "PSK" };
+
+    Fmt f;
+
+    Fmt_Init(&f, out, cap);
+    if (!done) {
+        Fmt_Str(&f, "LISTENING");
+        return;
+    }
+    Fmt_Str(&f, names[result.cls]);
+    if (result.bit_cycles) {
+        Fmt_Str(&f, " RF/");
+        Fmt_Uint(&f, result.bit_cycles);
+    }
+}
@@ -0,0 +1,235 @@
+/**
+  ******************************************************************************
+  * @file    lf_decoder.c
+  * @brief   Incremental multi-protocol decoder over sliced envelope runs.
+  *
+  * Every enabled protocol owns a channel: a demodulator matching its
+  * descriptor turns runs into bits, and a 128-bit history holds the most
+  * recent ones. After each new bit the channel checks whether the newest
+  * frame_len bits start with the preamble (optionally inverted, optionally
+  * repeated) and only then hands the frame to the protocol's validator.
+  ******************************************************************************
+  */
+
+#include "lf_decoder.h"
+#include "arena.h"
+#include "lf_protocols.h"
+#include <string.h>
+
+#define MAX_CHANNELS 8
+#define HIST_WORDS   (LF_MAX_FRAME_BITS / 32)
+
+// --- PER-PROTOCOL STATE ---
+typedef struct {
+    uint32_t hist[HIST_WORDS];  // Newest bit = bit 0 of hist[0]
+    uint16_t nbits;             // Consecutive good bits in the history
+    uint32_t acc;               // FSK: cycles in the current stretch; PSK: cycles since the last reversal
+    uint16_t prev_run;          // FSK: previous run (pairs make one subcarrier period)
+    int8_t pending;             // Manchester: first half-bit level, -1 = none
+    uint8_t cls;                // FSK: bit value of the current stretch; PSK: current bit value
+} Channel;
+
+static Channel channels[MAX_CHANNELS + 1]; // Last one belongs to the probe
+static const LfProtocol *probe;
+static uint32_t enabled = 0xFFFFFFFF; // Bit per protocol id
+static uint32_t total_cycles;
+static uint8_t locked;
+
+// --- BIT HISTORY ---
+
+static RAMFUNC void Resync(Channel *ch) {
+    ch->nbits = 0;
+    ch->pending = -1;
+    ch->acc = 0;
+}
+
+static RAMFUNC uint8_t Hist_Bit(const Channel *ch, uint16_t age) {
+    return (ch->hist[age / 32] >> (age % 32)) & 1u;
+}
+
+/* Looks for a valid frame ending at the newest bit */
+static RAMFUNC uint8_t Check_Frame(const Channel *ch, const LfProtocol *p, LfFrame *out) {
+    uint16_t len = p->frame_len;
+    uint16_t need = (p->flags & LF_FLAG_REPEAT) ? 2 * len : len;
+    if (ch->nbits < need) return 0;
+
+    // Frame bit i (0 = first transmitted) is history age len-1-i
+    uint8_t pol;
+    for (pol = 0; pol < 2; pol++) {
+        if (pol && !(p->flags & LF_FLAG_EITHER_POLARITY)) return 0;
+
+        uint8_t i = 0;
+        while (i < p->preamble_len &&
+               (Hist_Bit(ch, len - 1 - i) ^ pol) == ((p->preamble >> (p->preamble_len - 1 - i)) & 1u)) {
+            i++;
+        }
+        if (i == p->preamble_len) break;
+    }
+    if (pol == 2) return 0;
+
+    if (p->flags & LF_FLAG_REPEAT) {
+        for (uint16_t i = 0; i < len; i++) {
+            if (Hist_Bit(ch, i) != Hist_Bit(ch, i + len)) return 0;
+        }
+    }
+
+    uint8_t bits[LF_MAX_FRAME_BITS];
+    for (uint16_t i = 0; i < len; i++) bits[i] = Hist_Bit(ch, len - 1 - i) ^ pol;
+
+    memset(out, 0, sizeof(*out));
+    out->protocol = p->id;
+    if (!p->validate(bits, out)) return 0;
+    out->cycles = total_cycles;
+    return 1;
+}
+
+static RAMFUNC uint8_t Push_Bit(Channel *ch, const LfProtocol *p, uint8_t bit, LfFrame *out) {
+    for (uint8_t w = HIST_WORDS - 1; w > 0; w--) {
+        ch->hist[w] = (ch->hist[w] << 1) | (ch->hist[w - 1] >> 31);
+    }
+    ch->hist[0] = (ch->hist[0] << 1) | bit;
+    if (ch->nbits < 0xFFFF) ch->nbits++;
+    return Check_Frame(ch, p, out);
+}
+
+/* Whole bits in a stretch of 'cycles', rounded */
+static RAMFUNC uint16_t Bits_In(uint32_t cycles, uint16_t bit_cycles) {
+    return (uint16_t)((cycles + bit_cycles / 2) / bit_cycles);
+}
+
+// --- DEMODULATORS (return 1 when a frame validated) ---
+
+/* Runs are one or two half-bits long; every bit has a mid-bit transition */
+static RAMFUNC uint8_t Demod_Manchester(Channel *ch, const LfProtocol *p, uint8_t level, uint16_t cycles, LfFrame *out) {
+    uint16_t half = p->bit_cycles / 2;
+    uint16_t halves = (cycles + half / 2) / half;
+    if (halves < 1 || halves > 2) {
+        Resync(ch);
+        return 0;
+    }
+
+    while (halves--) {
+        if (ch->pending < 0) {
+            ch->pending = level;
+        } else if (ch->pending == level) {
+            // No mid-bit transition: the pairing is off by one half-bit
+            ch->nbits = 0;
+        } else {
+            uint8_t bit = (uint8_t)ch->pending; // High-to-low = 1
+            ch->pending = -1;
+            if (Push_Bit(ch, p, bit, out)) return 1;
+        }
+    }
+    return 0;
+}
+
+/* Pairs of runs are subcarrier periods; a stretch of one period length is N equal bits */
+static RAMFUNC uint8_t Demod_Fsk(Channel *ch, const LfProtocol *p, uint16_t cycles, LfFrame *out) {
+    if (cycles > p->sub_b) { // Longer than half a slow period: no subcarrier
+        Resync(ch);
+        ch->prev_run = 0;
+        return 0;
+    }
+    if (ch->prev_run == 0) {
+        ch->prev_run = cycles;
+        return 0;
+    }
+
+    uint16_t period = ch->prev_run + cycles;
+    uint8_t cls = (period * 2 > p->sub_a + p->sub_b) ? 1 : 0;
+    ch->prev_run = cycles;
+
+    if (cls == ch->cls) {
+        ch->acc += cycles;
+        return 0;
+    }
+
+    uint16_t n = Bits_In(ch->acc, p->bit_cycles);
+    uint8_t bit = ch->cls;
+    ch->cls = cls;
+    ch->acc = cycles;
+    while (n--) {
+        if (Push_Bit(ch, p, bit, out)) return 1;
+    }
+    return 0;
+}
+
+/* A run of 1.5+ subcarrier half-periods is a phase reversal, which toggles the bit value */
+static RAMFUNC uint8_t Demod_Psk1(Channel *ch, const LfProtocol *p, uint16_t cycles, LfFrame *out) {
+    uint16_t half = (p->sub_a > 1) ? p->sub_a / 2 : 1;
+    if (cycles > 4 * half) { // Subcarrier lost
+        Resync(ch);
+        return 0;
+    }
+
+    ch->acc += cycles;
+    if (cycles * 2 < 3 * half) return 0;
+
+    uint16_t n = Bits_In(ch->acc, p->bit_cycles);
+    uint8_t bit = ch->cls;
+    ch->cls ^= 1;
+    ch->acc = 0;
+    while (n--) {
+        if (Push_Bit(ch, p, bit, out)) return 1;
+    }
+    return 0;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void LF_Decoder_Reset(void) {
+    memset(channels, 0, sizeof(channels));
+    for (uint8_t i = 0; i <= MAX_CHANNELS; i++) channels[i].pending = -1;
+    total_cycles = 0;
+    locked = 0;
+}
+
+void LF_Decoder_Rearm(void) {
+    locked = 0;
+}
+
+void LF_Decoder_Enable(uint8_t protocol, uint8_t enable) {
+    if (protocol >= 32) return;
+    if (enable) enabled |= 1u << protocol;
+    else enabled &= ~(1u << protocol);
+}
+
+static RAMFUNC uint8_t Demod(Channel *ch, const LfProtocol *p, uint8_t level, uint16_t cycles, LfFrame *out) {
+    switch (p->modulation) {
+        case LF_MOD_ASK_MANCHESTER: return Demod_Manchester(ch, p, level, cycles, out);
+        case LF_MOD_FSK:            return Demod_Fsk(ch, p, cycles, out);
+        case LF_MOD_PSK1:           return Demod_Psk1(ch, p, cycles, out);
+    }
+    return 0;
+}
+
+RAMFUNC uint8_t LF_Decoder_Feed(uint8_t level, uint16_t cycles, LfFrame *out) {
+    if (locked) return 0;
+    total_cycles += cycles;
+
+    uint8_t found = 0;
+    for (uint8_t i = 0; i < lf_protocol_count && i < MAX_CHANNELS && !found; i++) {
+        const LfProtocol *p = &lf_protocols[i];
+        if (enabled & (1u << p->id)) found = Demod(&channels[i], p, level, cycles, out);
+    }
+    if (!found && probe) found = Demod(&channels[MAX_CHANNELS], probe, level, cycles, out);
+
+    if (found) locked = 1; // First validated frame wins
+    return found;
+}
+
+void LF_Decoder_SetProbe(const LfProtocol *p) {
+    probe = p;
+    memset(&channels[MAX_CHANNELS], 0, sizeof(Channel));
+    channels[MAX_CHANNELS].pending = -1;
+}
+
+void LF_Frame_PutBit(LfFrame *f, uint8_t bit) {
+    if (f->bit_len >= LF_MAX_ID_BITS) return;
+    if (bit) f->data[f->bit_len / 8] |= 0x80u >> (f->bit_len % 8);
+    f->bit_len++;
+}
+
+uint8_t LF_Frame_GetBit(const LfFrame *f, uint8_t index) {
+    return (f->data[index / 8] >> (7 - index % 8)) & 1u;
+}
@@ -0,0 +1,149 @@
+/**
+  ******************************************************************************
+  * @file    lf_protocols.c
+  * @brief   Descriptors and validators for the supported LF tag families.
+  * Adding a protocol = one validator + one table row (and a new id); an
+ * encoder is optional and only needed to write the ID to a blank card.
+  ******************************************************************************
+  */
+
+#include "lf_protocols.h"
+#include <stddef.h>
+
+// --- VALIDATORS ---
+
+/* EM4100: 9 x '1', 10 rows of 4 data + even parity, 4 column parities, stop '0' */
+static uint8_t Validate_Em4100(const uint8_t *bits, LfFrame *out) {
+    uint8_t col[4] = {0};
+
+    for (uint8_t r = 0; r < 10; r++) {
+        const uint8_t *row = &bits[9 + r * 5];
+        if ((row[0] ^ row[1] ^ row[2] ^ row[3] ^ row[4]) != 0) return 0;
+        for (uint8_t c = 0; c < 4; c++) col[c] ^= row[c];
+    }
+    for (uint8_t c = 0; c < 4; c++) {
+        if (col[c] != bits[59 + c]) return 0;
+    }
+    if (bits[63] != 0) return 0;
+
+    for (uint8_t r = 0; r < 10; r++) {
+        for (uint8_t c = 0; c < 4; c++) LF_Frame_PutBit(out, bits[9 + r * 5 + c]);
+    }
+    return 1;
+}
+
+/* Parity of bits [from, to] of a value, LSB = bit 0 */
+static uint8_t Parity(uint64_t v, uint8_t from, uint8_t to) {
+    uint8_t p = 0;
+    for (uint8_t i = from; i <= to; i++) p ^= (v >> i) & 1u;
+    return p;
+}
+
+/* HID Prox: preamble 0x1D, then 44 Manchester-coded bits (10 = 1, 01 = 0).
+   Bit 37 set marks a short format whose length is given by a sentinel bit;
+   otherwise the card number is the 37-bit format. */
+static uint8_t Validate_Hid(const uint8_t *bits, LfFrame *out) {
+    uint64_t v = 0;
+    for (uint8_t k = 0; k < 44; k++) {
+        uint8_t a = bits[8 + 2 * k], b = bits[9 + 2 * k];
+        if (a == b) return 0; // Not Manchester
+        v = (v << 1) | a;
+    }
+
+    uint8_t len = 37;
+    if ((v >> 37) & 1u) {
+        len = 36;
+        while (len > 0 && !((v >> len) & 1u)) len--;
+    }
+    if (len < 26) return 0;
+
+    // Parity for the formats with a published layout
+    if (len == 26 && (Parity(v, 13, 25) != 0 || Parity(v, 0, 12) != 1)) return 0;  // H10301
+    if (len == 37 && (Parity(v, 18, 36) != 0 || Parity(v, 0, 18) != 1)) return 0;  // H10304
+
+    for (int8_t i = len - 1; i >= 0; i--) LF_Frame_PutBit(out, (v >> i) & 1u);
+    return 1;
+}
+
+/* Indala 64: 33-bit preamble + 31 data bits; no checksum, so the descriptor
+   asks for two identical consecutive frames instead */
+static uint8_t Validate_Indala(const uint8_t *bits, LfFrame *out) {
+    for (uint8_t i = 33; i < 64; i++) LF_Frame_PutBit(out, bits[i]);
+    return 1;
+}
+
+// --- ENCODERS ---
+
+static uint8_t Encode_Em4100(const LfFrame *id, uint8_t *bits) {
+    uint8_t col[4] = {0};
+    uint8_t n = 0;
+
+    if (id->bit_len != 40) return 0;
+    for (uint8_t i = 0; i < 9; i++) bits[n++] = 1;
+    for (uint8_t r = 0; r < 10; r++) {
+        uint8_t p = 0;
+        for (uint8_t c = 0; c < 4; c++) {
+            uint8_t b = LF_Frame_GetBit(id, r * 4 + c);
+            bits[n++] = b;
+            p ^= b;
+            col[c] ^= b;
+        }
+        bits[n++] = p;
+    }
+    for (uint8_t c = 0; c < 4; c++) bits[n++] = col[c];
+    bits[n++] = 0;
+    return n;
+}
+
+static uint8_t Encode_Hid(const LfFrame *id, uint8_t *bits) {
+    uint8_t len = id->bit_len;
+    uint64_t v = 0;
+    uint8_t n = 0;
+
+    if (len < 26 || len > 37) return 0;
+    for (uint8_t i = 0; i < len; i++) v = (v << 1) | LF_Frame_GetBit(id, i);
+    if (len < 37) v |= (1ULL << 37) | (1ULL << len); // Short format + sentinel
+
+    for (int8_t i = 7; i >= 0; i--) bits[n++] = (0x1D >> i) & 1u;
+    for (int8_t k = 43; k >= 0; k--) {
+        uint8_t b = (v >> k) & 1u;
+        bits[n++] = b;
+        bits[n++] = !b;
+    }
+    return n;
+}
+
+static uint8_t Encode_Indala(const LfFrame *id, uint8_t *bits) {
+    uint8_t n = 0;
+
+    if (id->bit_len != 31) return 0;
+    for (int8_t i = 32; i >= 0; i--) bits[n++] = (0x140000001ULL >> i) & 1u;
+    for (uint8_t i = 0; i < 31; i++) bits[n++] = LF_Frame_GetBit(id, i);
+    return n;
+}
+
+// --- DESCRIPTOR TABLE ---
+
+const LfProtocol lf_protocols[] = {
+    { LF_PROTO_EM4100, "EM4100", LF_MOD_ASK_MANCHESTER, 64, 0,  0,
+      0x1FF,          9, 64, LF_FLAG_EITHER_POLARITY,                 Validate_Em4100, Encode_Em4100 },
+    { LF_PROTO_HID,    "HID",    LF_MOD_FSK,            50, 8, 10,
+      0x1D,           8, 96, 0,                                       Validate_Hid,    Encode_Hid    },
+    // PSK at RF/2 is below RF_MIN_SUBCARRIER: received with the front end at full rate
+    { LF_PROTO_INDALA, "INDALA", LF_MOD_PSK1,           32, 2,  0,
+      0x140000001ULL, 33, 64, LF_FLAG_EITHER_POLARITY | LF_FLAG_REPEAT, Validate_Indala, Encode_Indala },
+};
+
+const uint8_t lf_protocol_count = sizeof(lf_protocols) / sizeof(lf_protocols[0]);
+
+const LfProtocol* LF_Protocol_Find(uint8_t id) {
+    for (uint8_t i = 0; i < lf_protocol_count; i++) {
+        if (lf_protocols[i].id == id) return &lf_protocols[i];
+    }
+    return NULL;
+}
+
+const char* LF_Protocol_Name(uint8_t id) {
+    const LfProtocol *p = LF_Protocol_Find(id);
+    return p ? p->name : "?";
+}
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    lf_vote.c
+  * @brief   Per-bit majority voting and confidence for captured IDs.
+  ******************************************************************************
+  */
+
+#include "lf_vote.h"
+#include <string.h>
+
+/* 100 * (1 - 2^-margin), rounded; a margin past 7 stays at 99 */
+static const uint8_t confidence_of_margin[] = { 0, 50, 75, 88, 94, 97, 98, 99 };
+#define MAX_MARGIN (sizeof(confidence_of_margin) - 1)
+
+// The commit threshold is tuned to take a weakest-bit margin of exactly 4
+_Static_assert(LF_VOTE_COMMIT > 88 && LF_VOTE_COMMIT <= 94, "LF_VOTE_COMMIT no longer needs a margin of 4");
+
+static uint8_t Confidence(int16_t margin) {
+    if (margin <= 0) return 0;
+    if (margin > (int16_t)MAX_MARGIN) margin = MAX_MARGIN;
+    return confidence_of_margin[margin];
+}
+
+void LF_Vote_Reset(LfVote *v) {
+    memset(v, 0, sizeof(*v));
+}
+
+uint8_t LF_Vote_Add(LfVote *v, const LfFrame *f) {
+    if (v->reads >= LF_VOTE_MAX_READS) LF_Vote_Reset(v); // Never converged: start over
+
+    if (v->reads == 0) {
+        v->protocol = f->protocol;
+        v->bit_len = f->bit_len;
+    }
+    v->reads++;
+
+    if (f->protocol != v->protocol || f->bit_len != v->bit_len) {
+        v->conflicts++;
+        // Outvoted by another protocol: let it take over
+        if (v->conflicts * 2 > v->reads) {
+            LF_Vote_Reset(v);
+            return LF_Vote_Add(v, f);
+        }
+    } else {
+        for (uint8_t i = 0; i < v->bit_len; i++) {
+            v->ones[i] += LF_Frame_GetBit(f, i);
+        }
+    }
+
+    // Consensus and the weakest bit's margin (agreeing minus disagreeing reads)
+    uint8_t counted = v->reads - v->conflicts;
+    int16_t weakest = counted;
+    memset(&v->consensus, 0, sizeof(v->consensus));
+    v->consensus.protocol = v->protocol;
+    v->consensus.cycles = f->cycles;
+    for (uint8_t i = 0; i < v->bit_len; i++) {
+        uint8_t ones = v->ones[i];
+        uint8_t zeros = counted - ones;
+        LF_Frame_PutBit(&v->consensus, ones > zeros);
+        int16_t margin = (ones > zeros) ? ones - zeros : zeros - ones;
+        if (margin < weakest) weakest = margin;
+    }
+
+    v->confidence = Confidence(weakest - v->conflicts);
+    return v->confidence >= LF_VOTE_COMMIT;
+}
@@ -0,0 +1,200 @@
+/**
+  ******************************************************************************
+  * @file    listview.c
+  * @brief   Virtualized list widget on top of ILI9341 vertical scrolling.
+  *
+  * Content line L of the list lives in panel memory line
+  *     top + (L mod area)      where area = rows * LIST_ROW_H
+  * so the memory acts as a ring of 'rows' row slots. Scrolling only moves the
+  * hardware start pointer and paints the band of lines that became visible;
+  * while a row is half scrolled, its slot is shared between the row leaving
+  * at the top and the row entering at the bottom, split at the scroll offset.
+  ******************************************************************************
+  */
+
+#include "listview.h"
+#include "ili9341.h"
+#include "fonts.h"
+#include "ui.h"
+#include <string.h>
+
+#define TEXT_OFS (LIST_BTN_OFS + (LIST_BTN_H - 10) / 2) // Label line inside a row
+
+// --- PRIVATE HELPERS ---
+
+static int32_t Area_Height(const ListView *lv) {
+    return (int32_t)lv->rows * LIST_ROW_H;
+}
+
+static int32_t Max_Scroll(const ListView *lv) {
+    int32_t content = (int32_t)lv->count * LIST_ROW_H;
+    int32_t area = Area_Height(lv);
+    return (content > area) ? (content - area) : 0;
+}
+
+/* Fills the part of a row-local rectangle that falls inside the band [b0, b1) */
+static void Band_Fill(uint16_t base, uint16_t b0, uint16_t b1,
+                      uint16_t x, uint16_t oy, uint16_t w, uint16_t h, uint16_t color) {
+    uint16_t lo = (oy > b0) ? oy : b0;
+    uint16_t hi = ((oy + h) < b1) ? (oy + h) : b1;
+    if (lo >= hi) return;
+    LCD_FillRect(x, base + lo, w, hi - lo, color);
+}
+
+/* Draws the glyph lines of 'str' (at row-local line oy) that fall inside [b0, b1) */
+static void Band_Text(uint16_t base, uint16_t b0, uint16_t b1, const char *str,
+                      uint16_t x, uint16_t oy, uint16_t color, uint16_t bgcolor) {
+    FontDef font = Font_7x10;
+
+    // Whole label inside the band: use the normal string path
+    if (b0 <= oy && (oy + font.height) <= b1) {
+        LCD_WriteString(str, x, base + oy, font, color, bgcolor);
+        return;
+    }
+
+    for (; *str; str++, x += font.width) {
+        if (*str < 32 || *str > 126) continue;
+        const uint16_t *glyph = &font.data[(*str - 32) * font.width];
+        for (uint16_t j = 0; j < font.height; j++) {
+            uint16_t line = oy + j;
+            if (line < b0 || line >= b1) continue;
+            for (uint16_t i = 0; i < font.width; i++) {
+                LCD_DrawPixel(x + i, base + line, ((glyph[i] >> j) & 0x01) ? color : bgcolor);
+            }
+        }
+    }
+}
+
+static void Row_Paint_Band(ListView *lv, int32_t row, uint16_t b0, uint16_t b1, uint8_t highlight) {
+    uint16_t base = lv->top + (uint16_t)(row % lv->rows) * LIST_ROW_H;
+    uint16_t frame = highlight ? COLOR_TERM_DIM : COLOR_TERM_BG;
+
+    // Background (gaps are always black, the button body follows the highlight)
+    Band_Fill(base, b0, b1, 0, 0, ILI9341_WIDTH, LIST_ROW_H, COLOR_TERM_BG);
+    if (row < 0 || row >= lv->count) return; // Past the end: blank row
+
+    if (highlight) {
+        Band_Fill(base, b0, b1, LIST_ROW_X, LIST_BTN_OFS, LIST_ROW_W, LIST_BTN_H, frame);
+    } else {
+        // Wireframe outline + corner glitch accents (same look as terminal buttons)
+        Band_Fill(base, b0, b1, LIST_ROW_X, LIST_BTN_OFS, LIST_ROW_W, 1, COLOR_TERM_DIM);
+        Band_Fill(base, b0, b1, LIST_ROW_X, LIST_BTN_OFS + LIST_BTN_H - 1, LIST_ROW_W, 1, COLOR_TERM_DIM);
+        Band_Fill(base, b0, b1, LIST_ROW_X, LIST_BTN_OFS, 1, LIST_BTN_H, COLOR_TERM_DIM);
+        Band_Fill(base, b0, b1, LIST_ROW_X + LIST_ROW_W - 1, LIST_BTN_OFS, 1, LIST_BTN_H, COLOR_TERM_DIM);
+        Band_Fill(base, b0, b1, LIST_ROW_X, LIST_BTN_OFS, 5, 5, COLOR_TERM_DIM);
+        Band_Fill(base, b0, b1, LIST_ROW_X + LIST_ROW_W - 5, LIST_BTN_OFS + LIST_BTN_H - 5, 5, 5, COLOR_TERM_DIM);
+    }
+
+    if (b1 <= TEXT_OFS || b0 >= TEXT_OFS + 10) return; // Band misses the label
+
+    char buf[NAME_LEN + 3] = "> ";
+    strncpy(buf + 2, lv->label((uint16_t)row), NAME_LEN);
+    buf[NAME_LEN + 2] = '\0';
+
+    uint16_t text_w = strlen(buf) * 7;
+    uint16_t text_x = LIST_ROW_X + (LIST_ROW_W - text_w) / 2;
+    Band_Text(base, b0, b1, buf, text_x, TEXT_OFS,
+              highlight ? BLACK : COLOR_TERM_TEXT, frame);
+}
+
+/* Renders row-local lines [b0, b1) of content row 'row' into its memory slot */
+static void Row_Render_Band(ListView *lv, int32_t row, uint16_t b0, uint16_t b1, uint8_t highlight) {
+    LCD_Select(); // All windows of the band in one transaction
+    Row_Paint_Band(lv, row, b0, b1, highlight);
+    LCD_Deselect();
+}
+
+/* Renders content lines [c0, c1), splitting the range into per-row bands */
+static void Render_Lines(ListView *lv, int32_t c0, int32_t c1) {
+    while (c0 < c1) {
+        int32_t row = c0 / LIST_ROW_H;
+        int32_t row_start = row * LIST_ROW_H;
+        int32_t end = (c1 < row_start + LIST_ROW_H) ? c1 : (row_start + LIST_ROW_H);
+        Row_Render_Band(lv, row, (uint16_t)(c0 - row_start), (uint16_t)(end - row_start), 0);
+        c0 = end;
+    }
+}
+
+/* Points the panel's scroll start at the current content offset */
+static void Apply_Scroll(const ListView *lv) {
+    int32_t area = Area_Height(lv);
+    LCD_SetScrollArea(lv->top, (uint16_t)area, ILI9341_HEIGHT - lv->top - (uint16_t)area);
+    LCD_SetScrollStart(lv->top + (uint16_t)(lv->scroll_px % area));
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void ListView_Init(ListView *lv, uint16_t top, uint16_t rows, ListView_LabelFn label) {
+    lv->top = top;
+    lv->rows = rows;
+    lv->count = 0;
+    lv->scroll_px = 0;
+    lv->label = label;
+}
+
+void ListView_SetCount(ListView *lv, uint16_t count) {
+    lv->count = count;
+    int32_t max = Max_Scroll(lv);
+    if (lv->scroll_px > max) lv->scroll_px = max;
+}
+
+void ListView_Render(ListView *lv) {
+    Render_Lines(lv, lv->scroll_px, lv->scroll_px + Area_Height(lv));
+    Apply_Scroll(lv);
+}
+
+void ListView_ScrollBy(ListView *lv, int32_t dy) {
+    int32_t target = lv->scroll_px + dy;
+    int32_t max = Max_Scroll(lv);
+    if (target < 0) target = 0;
+    if (target > max) target = max;
+
+    int32_t old = lv->scroll_px;
+    int32_t area = Area_Height(lv);
+    if (target == old) return;
+
+    lv->scroll_px = target;
+    if (target - old >= area || old - target >= area) {
+        ListView_Render(lv); // Jumped past everything on screen
+        return;
+    }
+
+    // Paint the newly exposed band first, then reveal it
+    if (target > old) Render_Lines(lv, old + area, target + area);
+    else              Render_Lines(lv, target, old);
+    Apply_Scroll(lv);
+}
+
+void ListView_SetTop(ListView *lv, uint16_t index) {
+    int32_t target = (int32_t)index * LIST_ROW_H;
+    int32_t max = Max_Scroll(lv);
+    lv->scroll_px = (target > max) ? max : target;
+}
+
+int32_t ListView_ItemAt(const ListView *lv, uint16_t y) {
+    if (y < lv->top || y >= lv->top + Area_Height(lv)) return -1;
+
+    int32_t content = lv->scroll_px + (y - lv->top);
+    int32_t row = content / LIST_ROW_H;
+    int32_t ofs = content % LIST_ROW_H;
+
+    if (ofs < LIST_BTN_OFS || ofs >= LIST_BTN_OFS + LIST_BTN_H) return -1;
+    if (row >= lv->count) return -1;
+    return row;
+}
+
+void ListView_RedrawItem(ListView *lv, uint16_t index, uint8_t highlight) {
+    int32_t row_start = (int32_t)index * LIST_ROW_H;
+    int32_t c0 = (row_start > lv->scroll_px) ? row_start : lv->scroll_px;
+    int32_t c1 = row_start + LIST_ROW_H;
+    int32_t view_end = lv->scroll_px + Area_Height(lv);
+    if (c1 > view_end) c1 = view_end;
+    if (c0 >= c1) return; // Not visible
+
+    Row_Render_Band(lv, index, (uint16_t)(c0 - row_start), (uint16_t)(c1 - row_start), highlight);
+}
+
+void ListView_Release(void) {
+    LCD_SetScrollArea(0, ILI9341_HEIGHT, 0);
+    LCD_SetScrollStart(0);
+}
@@ -24,10 +24,30 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include <stdio.h>
+#include <string.h>
 #include "ili9341.h"
 #include "fonts.h"
 #include "touch.h"
 #include "ui.h"
+#include "gesture.h"
+#include "storage.h"
+#include "rf_frontend.h"
+#include "lf_decoder.h"
+#include "lf_classify.h"
+#include "lf_vote.h"
+#include "rawcap.h"
+#include "payload.h"
+#include "rf_replay.h"
+#include "rf_writer.h"
+#include "lf_protocols.h"
+#include "tuning.h"
+#include "wavecache.h"
+#include "profiler.h"
+#include "arena.h"
+#include "power.h"
+#include "display.h"
+#include "events.h"
+#include "stack.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -37,6 +57,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define RAW_FALLBACK_MS  3000 // Sniff this long without a decode before keeping the raw capture
 
 /* USER CODE END PD */
 
@@ -48,18 +69,324 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+static RawCapture raw_capture ARENA_RF; // Recorded alongside decoding, kept if nothing decodes
+static uint32_t sniff_start;
+static LfVote vote;            // Consensus over repeated reads of the same tag
+static TuneSweep tune;         // Antenna resonance sweep, run once per boot
+static uint8_t tuning;         // 1 while the sweep owns the front end
+static uint8_t tuned;
+static uint16_t untuned_arr;   // Period to fall back to if the sweep finds nothing
+static Playlist playlist ARENA_RF; // Streamed by the replay DMA while a playlist plays
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-
+static void Events_Poll(void);
+static void Workload_Poll(uint8_t touched);
+static void Tuning_Poll(void);
+static void Sniffer_Publish(void);
+static void Sniffer_Poll(void);
+static void Wave_Poll(void);
+static void Replay_Poll(void);
+static void Writer_Poll(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+static uint8_t touch_irq; // TOUCH_IRQ fell since the last pass
+
+// Wake latency (PROF_LCD_WAKE): stamped by the touch EXTI while the display sleeps
+static volatile uint32_t wake_irq_us;
+static volatile uint8_t wake_passes; // Loop passes since the stamp, 0 = none open
+
+/* Takes what the interrupts reported since the last pass */
+static void Events_Poll(void) {
+    Event ev;
+
+    while (Events_Get(&ev)) {
+        switch (ev.type) {
+            case EVT_TOUCH_IRQ:
+                touch_irq = 1; // Even if the pen lifted before the loop sampled it
+                break;
+            default:
+                break; // Counted by the bus for the diagnostics page
+        }
+    }
+}
+
+/* Runs the clock only as fast as the current work needs, and tells the idle
+   sleep when the loop has to run again (the RF paths wake it by interrupt) */
+static void Workload_Poll(uint8_t touched) {
+    static uint32_t last_busy, last_touch;
+    uint32_t now = HAL_GetTick();
+
+    // The gesture recognizer needs samples until a release is confirmed
+    if (touched) last_touch = now;
+    if (now - last_touch <= GESTURE_RELEASE_MS) Power_WakeBy(now);
+    if (Storage_IsBusy()) Power_WakeBy(now); // Flash work is fed from the loop
+
+    // The RF paths are timed from the 84 MHz tree; decoding and redraws want the speed too
+    if (!tuned || touched || ui_needs_update || currentState == PAGE_RX_SENSING ||
+        currentState == PAGE_TRANSMITTING || currentState == PAGE_WRITING) {
+        last_busy = now;
+        Power_SetProfile(CLOCK_FULL);
+        return;
+    }
+    if (now - last_busy < POWER_IDLE_AFTER_MS) {
+        Power_WakeBy(last_busy + POWER_IDLE_AFTER_MS);
+        return;
+    }
+    Power_SetProfile(CLOCK_IDLE);
+
+    // Pages that only wait for a tap, display off: stop until the touch controller signals one
+    uint8_t still = currentState == PAGE_MAIN || currentState == PAGE_TX_LIST ||
+                    currentState == PAGE_OPTIONS || currentState == PAGE_CONFIRM_DELETE;
+    if (!still || !Display_IsAsleep()) return;
+    Storage_Flush();
+    Power_StopUntilTouch();
+}
+
+/* Hands the carrier back with its sampling point at a quarter period */
+static void Tuning_Release(uint16_t arr) {
+    RF_Frontend_Stop();
+    RF_Frontend_SetCarrierArr(arr);
+    RF_Frontend_SetSamplePhase((arr + 1) / 4);
+    tuning = 0;
+}
+
+/* Sweeps the antenna resonance in the background while no page needs the coil */
+static void Tuning_Poll(void) {
+    if (tuned) return;
+
+    // RF pages own the front end: yield, and sweep again from scratch once they close
+    if (currentState == PAGE_RX_SENSING || currentState == PAGE_WRITING ||
+        currentState == PAGE_TRANSMITTING) {
+        if (tuning) Tuning_Release(untuned_arr);
+        return;
+    }
+
+    if (!tuning) {
+        untuned_arr = RF_Frontend_CarrierArr(); // Stored tuning, or nominal
+        Tune_Begin(&tune, RF_CARRIER_ARR, HAL_GetTick());
+        RF_Frontend_Start();
+        tuning = 1;
+    }
+    RF_Frontend_FlushEdges(); // Nobody decodes during the sweep
+
+    switch (Tune_Feed(&tune, HAL_GetTick(), RF_Frontend_CarrierLevel())) {
+        case TUNE_ACT_APPLY:
+            RF_Frontend_SetCarrierArr(Tune_Arr(&tune));
+            RF_Frontend_SetSamplePhase(Tune_Phase(&tune));
+            break;
+        case TUNE_ACT_RESTART:
+            RF_Frontend_RestartLevel();
+            break;
+        case TUNE_ACT_DONE:
+            // No clear resonance (no antenna, or detuned past the sweep): keep what we had
+            if (Tune_Result(&tune)) Storage_SaveTuning(Tune_Result(&tune));
+            Tuning_Release(Tune_Result(&tune) ? Tune_Result(&tune) : untuned_arr);
+            tuned = 1;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Pushes classifier and voting progress to the sniffer page */
+static void Sniffer_Publish(void) {
+    SnifferStatus status;
+
+    memset(&status, 0, sizeof(status));
+    LF_Classify_Describe(status.mode, sizeof(status.mode));
+    status.protocol = vote.protocol;
+    status.reads = vote.reads;
+    status.confidence = vote.confidence;
+    UI_Sniffer_Status(&status);
+}
+
+/* Runs the front end while the sniffer page is open and decodes its output */
+static void Sniffer_Poll(void) {
+    if (currentState != PAGE_RX_SENSING) {
+        // Carrier off outside the sniffer (the clone writer and the tuner keep it for themselves)
+        if (RF_Frontend_IsRunning() && currentState != PAGE_WRITING && !tuning) RF_Frontend_Stop();
+        return;
+    }
+
+    if (!RF_Frontend_IsRunning()) {
+        LF_Decoder_Reset();
+        LF_Classify_Reset();
+        LF_Vote_Reset(&vote);
+        Rawcap_Begin(&raw_capture);
+        sniff_start = HAL_GetTick();
+        RF_Frontend_SetFullRate(1); // Classify at full rate: PSK at RF/2 does not survive decimation
+        RF_Frontend_Start();
+    }
+
+    uint16_t runs[32];
+    uint16_t n;
+    LfFrame frame;
+    while ((n = RF_Frontend_ReadEdges(runs, 32)) > 0) {
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t level = (runs[i] & RF_EDGE_LEVEL) ? 1 : 0;
+            uint16_t cycles = runs[i] & RF_EDGE_CYCLES;
+            Rawcap_Feed(&raw_capture, level, cycles);
+
+            // Classify first, then run only the matching decoders (window included)
+            uint8_t found;
+            if (!LF_Classify_IsDone()) {
+                found = 0;
+                if (LF_Classify_Feed(level, cycles)) {
+                    // ASK and FSK go back to decimated blocks; PSK (or no decision) stays at full rate
+                    LfClass cls = LF_Classify_Result()->cls;
+                    RF_Frontend_SetFullRate(cls == LF_CLASS_PSK || cls == LF_CLASS_UNKNOWN);
+                    found = LF_Classify_Apply() && LF_Classify_Replay(&frame);
+                }
+            } else {
+                uint32_t t0 = Prof_Now();
+                found = LF_Decoder_Feed(level, cycles, &frame);
+                Prof_Record(PROF_DEMOD, t0);
+            }
+            if (!found) continue;
+
+            // Keep reading until the votes agree well enough to save
+            LF_Decoder_Rearm();
+            if (LF_Vote_Add(&vote, &frame)) {
+                Sniffer_Publish();
+                UI_Signal_Captured(&vote.consensus, NULL, 0);
+                return;
+            }
+        }
+    }
+    Sniffer_Publish();
+
+    // No known protocol: clone the fob as a raw timeline
+    if (vote.reads == 0 && Rawcap_IsDone(&raw_capture) && HAL_GetTick() - sniff_start >= RAW_FALLBACK_MS) {
+        uint16_t len;
+        const uint8_t *blob = Rawcap_Blob(&raw_capture, &len);
+        memset(&frame, 0, sizeof(frame));
+        UI_Signal_Captured(&frame, blob, len);
+    }
+}
+
+/* Expands the selected signal into the waveform cache while its options are shown */
+static void Wave_Poll(void) {
+    static const uint8_t *seen; // Payload already looked up on this visit
+
+    if (currentState != PAGE_OPTIONS) {
+        seen = NULL;
+        return;
+    }
+
+    const uint8_t *payload = signal_db[selected_slot_idx].payload;
+    if (payload == NULL || payload == seen) return;
+    seen = payload;
+
+    WaveTimeline tl;
+    if (Wave_Lookup(payload, &tl)) return;
+    uint32_t t0 = Prof_Now();
+    if (Wave_Build(payload, &tl)) Prof_Record(PROF_WAVE_BUILD, t0);
+}
+
+/* Cached (or freshly built) timeline for a payload */
+static uint8_t Replay_Timeline(const uint8_t *payload, WaveTimeline *tl) {
+    if (Wave_Lookup(payload, tl)) return 1;
+    uint32_t t0 = Prof_Now();
+    if (!Wave_Build(payload, tl)) return 0;
+    Prof_Record(PROF_WAVE_BUILD, t0);
+    return 1;
+}
+
+/* (Re)starts tx_playlist from the top with its current schedule */
+static void Start_Playlist(void) {
+    uint32_t t0 = Prof_Now();
+
+    RF_Replay_Stop();
+    Wave_Lock(NULL);
+    Playlist_Init(&playlist, tx_playlist.repeats, tx_playlist.gap_ms);
+
+    for (uint8_t i = 0; i < tx_playlist.count; i++) {
+        WaveTimeline tl;
+        uint8_t slot = tx_playlist.slots[i];
+        // Locked as they go in, so building a later one cannot evict an earlier one
+        if (!Replay_Timeline(signal_db[slot].payload, &tl)) continue;
+        if (!Playlist_Add(&playlist, &tl, slot)) break;
+        Wave_Lock(&tl);
+    }
+    if (RF_Replay_StartPlaylist(&playlist)) Prof_Record(PROF_TX_START, t0);
+}
+
+/* Emulates the selected signal, or cycles the playlist, while the transmit page is open */
+static void Replay_Poll(void) {
+    static const uint8_t *started; // Payload already tried (a bad blob is not retried every pass)
+    static int16_t started_version = -1;
+
+    if (currentState != PAGE_TRANSMITTING) {
+        if (RF_Replay_IsRunning()) RF_Replay_Stop();
+        Wave_Lock(NULL);
+        started = NULL;
+        started_version = -1;
+        return;
+    }
+
+    if (tx_playlist.count) {
+        PlaylistProgress progress;
+        if (started_version != tx_playlist.version) {
+            started_version = tx_playlist.version;
+            Start_Playlist();
+        }
+        memset(&progress, 0, sizeof(progress));
+        if (RF_Replay_IsRunning()) {
+            progress.item = playlist.item;
+            progress.slot = playlist.ids[progress.item];
+            progress.count = playlist.count;
+            progress.pass = playlist.pass;
+            progress.loops = RF_Replay_Loops();
+        }
+        UI_Playlist_Progress(&progress);
+        return;
+    }
+    if (RF_Replay_IsRunning()) return;
+
+    const uint8_t *payload = signal_db[selected_slot_idx].payload;
+    if (payload == NULL || payload == started) return;
+    started = payload;
+
+    // Normally built on the options page already: starting is a DMA pointer swap
+    WaveTimeline tl;
+    uint32_t t0 = Prof_Now();
+    if (!Replay_Timeline(payload, &tl)) return;
+    Wave_Lock(&tl);
+    if (RF_Replay_Start(&tl)) Prof_Record(PROF_TX_START, t0);
+}
+
+/* Clones the selected signal onto a T5577 while the writer page is open */
+static void Writer_Poll(void) {
+    static uint8_t started;
+
+    if (currentState != PAGE_WRITING) {
+        RF_Writer_Abort();
+        started = 0;
+        return;
+    }
+    if (started) {
+        RF_Writer_Task();
+        if (RF_Writer_IsBusy()) Power_WakeBy(HAL_GetTick() + 1); // Programming steps are timed in ms
+        return;
+    }
+
+    const uint8_t *payload = signal_db[selected_slot_idx].payload;
+    const LfProtocol *p = payload ? LF_Protocol_Find(Payload_Protocol(payload)) : NULL;
+    started = 1;
+    if (p == NULL) return;
+
+    LfFrame id;
+    Payload_ToFrame(payload, &id);
+    RF_Writer_Start(p, &id);
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -79,6 +406,8 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  Prof_Init();
+  Stack_Init();
 
   /* USER CODE END Init */
 
@@ -94,10 +423,13 @@ int main(void)
   MX_SPI1_Init();
   MX_SPI2_Init();
   /* USER CODE BEGIN 2 */
+  Power_Init();
   UI_Init();
+  Display_Init();
   UI_Draw_Boot_Sequence(); // The cool startup animation
   
-  uint16_t px, py;
+  uint16_t px = 0, py = 0;
+  GestureEvent gesture;
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -113,17 +445,45 @@ int main(void)
       // 2. Animate elements (if needed)
       UI_Update_Dynamic_Elements();
 
-      // 3. Handle Input
-      if (Touch_GetPixels(&px, &py)) {
-          UI_Handle_Touch(px, py);
-          HAL_Delay(50); // Small debounce for page switching
+      // 3. Handle Input (sampled every pass, debounced by the gesture recognizer)
+      uint8_t pressed = Touch_GetPixels(&px, &py);
+      uint8_t live = currentState == PAGE_RX_SENSING || currentState == PAGE_TRANSMITTING ||
+                     currentState == PAGE_WRITING;
+      // A touch that only wakes the display is not input
+      uint8_t waking = Display_Poll(HAL_GetTick(), pressed, live);
+      if (Gesture_Feed(pressed && !waking, px, py, HAL_GetTick(), &gesture)) {
+          UI_Handle_Gesture(&gesture);
       }
-      
-      // 4. Handle Hardware Logic
-      if (currentState == PAGE_RX_SENSING) {
-          // Listen for signals...
+      // Covers stop exit, the wake pass (touch read, Sleep Out, backlight) and
+      // the clock restore: closes on the first sample taken with all of it done
+      if (wake_passes) {
+          if (!Display_IsAsleep() && Power_Profile() == CLOCK_FULL) {
+              Prof_RecordUs(PROF_LCD_WAKE, Power_NowUs() - wake_irq_us);
+              wake_passes = 0;
+          } else if (Display_IsAsleep() && ++wake_passes > 2) {
+              wake_passes = 0; // The IRQ came without a touch to read
+          }
       }
 
+      // Clock profile for what the page now needs (before the hardware starts)
+      Events_Poll();
+      Workload_Poll(pressed || touch_irq);
+      touch_irq = 0;
+      
+      // 4. Commit pending storage changes (one flash word per pass)
+      Storage_Task();
+
+      // 5. Handle Hardware Logic
+      Tuning_Poll();
+      Sniffer_Poll();
+      Wave_Poll();
+      Replay_Poll();
+      Writer_Poll();
+      Stack_Poll(HAL_GetTick());
+
+      // 6. Sleep until the next deadline or interrupt
+      Power_Idle();
+
   }
   /* USER CODE END 3 */
 }
@@ -175,6 +535,14 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    if (GPIO_Pin != TOUCH_IRQ_Pin) return;
+    if (wake_passes == 0 && Display_IsAsleep()) {
+        wake_irq_us = Power_NowUs();
+        wake_passes = 1;
+    }
+    Events_Post(EVT_TOUCH_IRQ, 0);
+}
 
 /* USER CODE END 4 */
 
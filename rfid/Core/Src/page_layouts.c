@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    page_layouts.c
+  * @brief   Static parts of the pages, resolved at compile time.
+  ******************************************************************************
+  */
+
+#include "page_layouts.h"
+#include "ui.h"
+
+// --- PAGE LAYOUTS ---
+
+const LayoutCmd layout_main[] = {
+    L_TEXT(5, 10, COLOR_TERM_DIM, "// ROOT_ACCESS"),
+    L_RULE(COLOR_TERM_DIM),
+    L_BUTTON(BTN_TX, "> EXECUTE_PAYLOAD", 0),
+    L_BUTTON(BTN_RX, "> SNIFF_TRAFFIC", 0),
+    L_BUTTON(BTN_CAL, "> CALIBRATE_TOUCH", 0),
+    L_BUTTON(BTN_DIAG, "> DIAGNOSTICS", 0),
+    L_END
+};
+
+const LayoutCmd layout_list[] = {
+    L_RULE(COLOR_TERM_DIM),
+    L_BUTTON(BTN_LIST_HOME, "< HOME", 1),
+    L_BUTTON(BTN_LIST_JUMP, "A-Z", 0),
+    L_BUTTON(BTN_LIST_PLAY, "PLAY", 0),
+    L_END
+};
+
+const LayoutCmd layout_options[] = {
+    L_TEXT(5, 10, COLOR_TERM_DIM, "// SIGNAL OPT."),
+    L_RULE(COLOR_TERM_DIM),
+    L_TEXT_CENTERED(35, COLOR_TERM_DIM, "SELECTED:"),
+    L_BUTTON(BTN_OPT_TX, "TRANSMIT", 0),
+    L_BUTTON(BTN_OPT_RENAME, "RENAME", 0),
+    L_BUTTON(BTN_OPT_DEL, "DELETE", 1),
+    L_BUTTON(BTN_OPT_BACK, "< BACK", 0),
+    L_END
+};
+
+const LayoutCmd layout_confirm_delete[] = {
+    L_TEXT(5, 10, COLOR_ALERT, "// WARNING"),
+    L_RULE(COLOR_ALERT),
+    L_TEXT_CENTERED(50, COLOR_TERM_TEXT, "CONFIRM DELETE?"),
+    L_BUTTON(BTN_CONF_NO, "NO", 1),
+    L_BUTTON(BTN_CONF_YES, "YES", 0),
+    L_END
+};
+
+#define KB_KEY_FRAME(row, col)  L_FRAME(KB_KEY_X(col), KB_KEY_Y(row), KB_KEY_W, KB_KEY_H, COLOR_TERM_DIM)
+#define KB_KEY_ROW(row) \
+    KB_KEY_FRAME(row, 0), KB_KEY_FRAME(row, 1), KB_KEY_FRAME(row, 2), KB_KEY_FRAME(row, 3), KB_KEY_FRAME(row, 4)
+
+const LayoutCmd layout_keyboard[] = {
+    L_FRAME(10, 25, 220, 30, COLOR_TERM_TEXT), // Input box
+    KB_KEY_ROW(0), KB_KEY_ROW(1), KB_KEY_ROW(2), KB_KEY_ROW(3), KB_KEY_ROW(4),
+    L_BUTTON(BTN_KB_SPACE, "_", 0),
+    L_BUTTON(BTN_KB_DEL, "DEL", 1),
+    L_BUTTON(BTN_KB_DONE, "OK", 0),
+    L_END
+};
+
+const LayoutCmd layout_transmitting[] = {
+    L_TEXT(5, 10, COLOR_TERM_TEXT, "// TRANSMITTING"),
+    L_RULE(COLOR_TERM_TEXT),
+    L_TEXT_CENTERED(80, COLOR_TERM_DIM, "SENDING:"),
+    L_BUTTON(BTN_STOP, "[ STOP SIGNAL ]", 1),
+    L_END
+};
+
+const LayoutCmd layout_writing[] = {
+    L_TEXT(5, 10, COLOR_TERM_TEXT, "// CLONE_T5577"),
+    L_RULE(COLOR_TERM_TEXT),
+    L_TEXT(54, 60, COLOR_TERM_DIM, "HOLD BLANK ON COIL:"),
+    L_BUTTON(BTN_STOP, "[ CLOSE ]", 1),
+    L_END
+};
+
+const LayoutCmd layout_rx_sensing[] = {
+    L_TEXT(5, 10, COLOR_ALERT, "// SNIFFER_ACTIVE"),
+    L_RULE(COLOR_ALERT),
+    L_TEXT(20, 100, COLOR_TERM_TEXT, "WAITING FOR SIGNAL..."),
+    L_BUTTON(BTN_BACK, "< STOP", 1),
+    L_END
+};
+
+const LayoutCmd layout_calibrate[] = {
+    L_TEXT(5, 10, COLOR_TERM_DIM, "// TOUCH_CALIBRATION"),
+    L_RULE(COLOR_TERM_DIM),
+    L_END
+};
+
+const LayoutCmd layout_diag[] = {
+    L_TEXT(5, 10, COLOR_TERM_DIM, "// DIAGNOSTICS"),
+    L_RULE(COLOR_TERM_DIM),
+    L_BUTTON(BTN_BACK, "< BACK", 0),
+    L_END
+};
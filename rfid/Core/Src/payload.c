@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file    payload.c
+  * @brief   Versioned signal payload: building, validation, in-place access.
+  ******************************************************************************
+  */
+
+#include "payload.h"
+#include "lf_protocols.h"
+#include <string.h>
+
+static uint16_t Id_Bytes(uint8_t bits) {
+    return (bits + 7) / 8;
+}
+
+static void Put_Header(uint8_t *buf, uint8_t protocol, uint16_t total, uint8_t bits, uint8_t flags) {
+    buf[0] = PAYLOAD_VERSION;
+    buf[1] = protocol;
+    buf[2] = total & 0xFF;
+    buf[3] = total >> 8;
+    buf[4] = bits;
+    buf[5] = flags;
+}
+
+uint16_t Payload_Build(uint8_t *buf, uint16_t cap, const LfFrame *frame,
+                       const uint8_t *raw, uint16_t raw_len) {
+    uint16_t id_len = Id_Bytes(frame->bit_len);
+    uint32_t total = PAYLOAD_HEADER_LEN + id_len + (raw ? raw_len : 0);
+    if (total > cap || total > 0xFFFF) return 0;
+
+    Put_Header(buf, frame->protocol, (uint16_t)total, frame->bit_len, raw ? PAYLOAD_FLAG_RAW : 0);
+    memcpy(&buf[PAYLOAD_HEADER_LEN], frame->data, id_len);
+    if (raw) memcpy(&buf[PAYLOAD_HEADER_LEN + id_len], raw, raw_len);
+    return (uint16_t)total;
+}
+
+uint16_t Payload_FromLegacy(uint8_t *buf, uint32_t protocol_data) {
+    uint16_t total = PAYLOAD_HEADER_LEN + 4;
+    Put_Header(buf, LF_PROTO_NONE, total, 32, 0);
+    buf[6] = protocol_data >> 24;
+    buf[7] = protocol_data >> 16;
+    buf[8] = protocol_data >> 8;
+    buf[9] = protocol_data;
+    return total;
+}
+
+uint8_t Payload_IsValid(const uint8_t *p, uint16_t avail) {
+    if (p == NULL || avail < PAYLOAD_HEADER_LEN) return 0;
+    if (p[0] != PAYLOAD_VERSION) return 0;
+
+    uint16_t total = Payload_Length(p);
+    if (total > avail || p[4] > LF_MAX_ID_BITS) return 0;
+    if (total < PAYLOAD_HEADER_LEN + Id_Bytes(p[4])) return 0;
+    return 1;
+}
+
+uint8_t Payload_Protocol(const uint8_t *p) {
+    return p[1];
+}
+
+uint16_t Payload_Length(const uint8_t *p) {
+    return p[2] | ((uint16_t)p[3] << 8);
+}
+
+uint8_t Payload_BitLen(const uint8_t *p) {
+    return p[4];
+}
+
+const uint8_t* Payload_Id(const uint8_t *p) {
+    return &p[PAYLOAD_HEADER_LEN];
+}
+
+const uint8_t* Payload_Raw(const uint8_t *p, uint16_t *len) {
+    uint16_t start = PAYLOAD_HEADER_LEN + Id_Bytes(p[4]);
+    if (!(p[5] & PAYLOAD_FLAG_RAW) || Payload_Length(p) <= start) {
+        *len = 0;
+        return NULL;
+    }
+    *len = Payload_Length(p) - start;
+    return &p[start];
+}
+
+void Payload_ToFrame(const uint8_t *p, LfFrame *out) {
+    memset(out, 0, sizeof(*out));
+    out->protocol = p[1];
+    out->bit_len = p[4];
+    memcpy(out->data, Payload_Id(p), Id_Bytes(p[4]));
+}
+
+void Payload_IdHex(const uint8_t *p, char *out, uint16_t cap) {
+    static const char hex[] = "0123456789ABCDEF";
+    uint16_t n = Id_Bytes(p[4]);
+    uint16_t o = 0;
+
+    for (uint16_t i = 0; i < n && o + 2 < cap; i++) {
+        out[o++] = hex[Payload_Id(p)[i] >> 4];
+        out[o++] = hex[Payload_Id(p)[i] & 0x0F];
+    }
+    if (cap) out[o] = '\0';
+}
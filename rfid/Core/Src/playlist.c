@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    playlist.c
+  * @brief   Back-to-back timeline sequencing with repeats and gaps.
+  ******************************************************************************
+  */
+
+#include "playlist.h"
+#include "arena.h"
+#include <string.h>
+
+#define CYCLES_PER_MS  125 // 125 kHz carrier
+#define GAP_LEVEL      1   // Switch open: the reader sees an unmodulated field
+
+/* Next piece of the sequence before merging: one timeline run or the gap */
+static void Piece(Playlist *pl, uint8_t *level, uint32_t *ticks) {
+    if (pl->in_gap) {
+        *level = GAP_LEVEL;
+        *ticks = pl->gap_ticks;
+        pl->in_gap = 0;
+        if (++pl->item == pl->count) {
+            pl->item = 0;
+            pl->loops++;
+        }
+        return;
+    }
+
+    const WaveTimeline *tl = &pl->items[pl->item];
+    *level = tl->first_level ^ (pl->index & 1u);
+    *ticks = tl->arr[pl->index] + 1u;
+
+    if (++pl->index < tl->runs) return;
+    pl->index = 0;
+    if (++pl->pass < pl->repeats) return;
+    pl->pass = 0;
+
+    if (pl->gap_ticks) {
+        pl->in_gap = 1;
+    } else if (++pl->item == pl->count) {
+        pl->item = 0;
+        pl->loops++;
+    }
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Playlist_Init(Playlist *pl, uint8_t repeats, uint16_t gap_ms) {
+    memset(pl, 0, sizeof(*pl));
+    pl->repeats = repeats ? repeats : 1;
+    if (gap_ms > PLAYLIST_GAP_MAX_MS) gap_ms = PLAYLIST_GAP_MAX_MS;
+    pl->gap_ticks = (uint32_t)gap_ms * CYCLES_PER_MS * WAVE_TICKS_PER_CYCLE;
+}
+
+uint8_t Playlist_Add(Playlist *pl, const WaveTimeline *tl, uint8_t id) {
+    if (pl->count == PLAYLIST_MAX || tl->runs < 2 || (tl->runs & 1u)) return 0;
+    pl->items[pl->count] = *tl;
+    pl->ids[pl->count] = id;
+    pl->count++;
+    return 1;
+}
+
+uint8_t Playlist_Rewind(Playlist *pl) {
+    pl->item = 0;
+    pl->pass = 0;
+    pl->loops = 0;
+    pl->index = 0;
+    pl->in_gap = 0;
+    pl->pend_ticks = 0;
+    if (pl->count == 0) return GAP_LEVEL;
+
+    Piece(pl, &pl->pend_level, &pl->pend_ticks);
+    return pl->pend_level;
+}
+
+RAMFUNC uint16_t Playlist_Next(Playlist *pl) {
+    uint8_t level;
+    uint32_t ticks;
+
+    if (pl->count == 0) return 0xFFFF;
+
+    // Timelines alternate internally, so this only loops at joins
+    for (;;) {
+        Piece(pl, &level, &ticks);
+        if (level == pl->pend_level) {
+            pl->pend_ticks += ticks;
+            continue;
+        }
+        uint32_t out = pl->pend_ticks;
+        pl->pend_level = level;
+        pl->pend_ticks = ticks;
+        return (out > 0x10000) ? 0xFFFF : (uint16_t)(out - 1);
+    }
+}
@@ -0,0 +1,233 @@
+/**
+  ******************************************************************************
+  * @file    power.c
+  * @brief   Clock profile transitions, tickless sleep and stop mode.
+  *
+  * Slowing down: SYSCLK moves to HSI first (HAL lowers the wait states after
+  * the switch), then the PLL stops and the regulator drops to scale 3.
+  * Speeding up: the regulator goes back to scale 2 before the PLL starts (the
+  * F401 only latches VOS with the PLL off), the PLL locks, then HAL raises the
+  * wait states before switching. HAL_RCC_ClockConfig also reloads the SysTick
+  * for the new HCLK, so HAL_GetTick keeps counting milliseconds.
+  *
+  * Tickless sleep runs with interrupts masked: WFI still returns on a
+  * pending interrupt, the tick is corrected, and only then do the handlers
+  * run, so they never see a stale HAL_GetTick. The SysTick and TIM5 hand over
+  * back to back and the remainder is carried in nanoseconds, so only the few
+  * instructions between stopping one counter and starting the other go
+  * uncounted (Tests/test_clocks.c simulates the drift).
+  ******************************************************************************
+  */
+
+#include "power.h"
+#include "spi.h"
+#include "events.h"
+
+static ClockProfileId current = CLOCK_FULL;
+static ClockTree tree;
+
+// Tickless sleep
+static uint32_t wake_at;
+static uint8_t wake_set;
+static uint32_t carry_ns;      // Sub-millisecond remainder owed to the tick
+static uint32_t asleep_us;     // Since the last Power_Residency()
+static uint32_t window_start;
+
+// --- HAL ENCODINGS ---
+
+static uint32_t Ahb_Bits(uint16_t div) {
+    uint32_t k = __builtin_ctz(div);
+    if (k == 0) return RCC_SYSCLK_DIV1;
+    return (0x8u | (k - ((k > 4) ? 2u : 1u))) << RCC_CFGR_HPRE_Pos; // No /32 step
+}
+
+static uint32_t Apb_Bits(uint8_t div) {
+    uint32_t k = __builtin_ctz(div);
+    if (k == 0) return RCC_HCLK_DIV1;
+    return (0x4u | (k - 1u)) << RCC_CFGR_PPRE1_Pos;
+}
+
+static void Spi_SetBr(SPI_HandleTypeDef *h, uint8_t br) {
+    uint32_t bits = (uint32_t)br << SPI_CR1_BR_Pos;
+    __HAL_SPI_DISABLE(h); // Transfers are blocking: nothing is in flight here
+    MODIFY_REG(h->Instance->CR1, SPI_CR1_BR, bits);
+    h->Init.BaudRatePrescaler = bits;
+}
+
+// --- TRANSITIONS ---
+
+static uint8_t Apply(const ClockProfile *p, const ClockTree *t) {
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.AHBCLKDivider = Ahb_Bits(p->ahb_div);
+    clk.APB1CLKDivider = Apb_Bits(p->apb1_div);
+    clk.APB2CLKDivider = Apb_Bits(p->apb2_div);
+
+    // Off the PLL before touching it
+    if (__HAL_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+        RCC_ClkInitTypeDef hsi = clk;
+        hsi.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+        hsi.AHBCLKDivider = RCC_SYSCLK_DIV1;
+        hsi.APB1CLKDivider = RCC_HCLK_DIV1;
+        hsi.APB2CLKDivider = RCC_HCLK_DIV1;
+        if (HAL_RCC_ClockConfig(&hsi, FLASH_LATENCY_0) != HAL_OK) return 0;
+    }
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    if (p->use_pll) {
+        __HAL_PWR_VOLTAGESCALING_CONFIG((p->vos == 3) ? PWR_REGULATOR_VOLTAGE_SCALE3 : PWR_REGULATOR_VOLTAGE_SCALE2);
+        osc.PLL.PLLState = RCC_PLL_ON;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+        osc.PLL.PLLM = p->pll_m;
+        osc.PLL.PLLN = p->pll_n;
+        osc.PLL.PLLP = p->pll_p;
+        osc.PLL.PLLQ = p->pll_q;
+    } else {
+        osc.PLL.PLLState = RCC_PLL_OFF;
+    }
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) return 0;
+    if (!p->use_pll) {
+        __HAL_PWR_VOLTAGESCALING_CONFIG((p->vos == 3) ? PWR_REGULATOR_VOLTAGE_SCALE3 : PWR_REGULATOR_VOLTAGE_SCALE2);
+    }
+
+    clk.SYSCLKSource = p->use_pll ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_HSI;
+    if (HAL_RCC_ClockConfig(&clk, t->flash_ws) != HAL_OK) return 0;
+
+    Spi_SetBr(&hspi1, t->lcd_br);
+    Spi_SetBr(&hspi2, t->touch_br);
+    TIM4->PSC = t->us_psc; // Backlight PWM keeps its rate (buffered until the next period)
+    return 1;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Power_Init(void) {
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    HAL_NVIC_SetPriority(TIM5_IRQn, 0, 3);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+
+    current = CLOCK_FULL;
+    Clock_Derive(Clock_Profile(CLOCK_FULL), &tree);
+    Spi_SetBr(&hspi1, tree.lcd_br);
+    Spi_SetBr(&hspi2, tree.touch_br);
+}
+
+uint8_t Power_SetProfile(ClockProfileId id) {
+    const ClockProfile *p = Clock_Profile(id);
+    ClockTree next;
+
+    if (id == current) return 1;
+    if (p == NULL || !Clock_Derive(p, &next)) return 0;
+
+    if (!Apply(p, &next)) {
+        // Land on a known tree rather than a half-switched one
+        Clock_Derive(Clock_Profile(CLOCK_IDLE), &tree);
+        Apply(Clock_Profile(CLOCK_IDLE), &tree);
+        current = CLOCK_IDLE;
+        return 0;
+    }
+    tree = next;
+    current = id;
+    return 1;
+}
+
+ClockProfileId Power_Profile(void) {
+    return current;
+}
+
+const ClockTree* Power_Tree(void) {
+    return &tree;
+}
+
+void Power_StopUntilTouch(void) {
+    // Wakes on the TOUCH_IRQ falling edge (EXTI1)
+    if (!Power_SetProfile(CLOCK_IDLE)) return;
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+    // Wakes on HSI with the IDLE prescalers retained: already CLOCK_IDLE.
+    // The EXTI edge is spent, so Power_Idle must not sleep before the touch is read
+    Power_WakeBy(HAL_GetTick());
+}
+
+void Power_WakeBy(uint32_t at_ms) {
+    if (!wake_set || (int32_t)(at_ms - wake_at) < 0) wake_at = at_ms;
+    wake_set = 1;
+}
+
+void Power_Idle(void) {
+    uint32_t now = HAL_GetTick();
+    int32_t ms = wake_set ? (int32_t)(wake_at - now) : POWER_SLEEP_MAX_MS;
+
+    wake_set = 0;
+    if (ms > POWER_SLEEP_MAX_MS) ms = POWER_SLEEP_MAX_MS;
+    if (ms < 1) return;
+
+    __disable_irq();
+    // TIM5 (APB1 timer clock) counts the sleep in timer clock periods
+    uint32_t tim_per_ms = tree.tim3_clk / 1000u;
+    TIM5->PSC = 0;
+    TIM5->ARR = 0xFFFFFFFFu;
+    TIM5->CCR1 = 0xFFFFFFFFu;
+    TIM5->SR = 0;
+    TIM5->DIER = TIM_DIER_CC1IE;
+
+    // Hand over from the SysTick: part of the current tick period is already
+    // gone, and the deadline counts from its start
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    TIM5->EGR = TIM_EGR_UG; // Clears CNT
+    TIM5->CR1 = TIM_CR1_CEN;
+    uint32_t partial_ns = Clock_Ns(SysTick->LOAD - SysTick->VAL, tree.hclk);
+    uint32_t target = (uint32_t)ms * tim_per_ms - (uint32_t)((uint64_t)partial_ns * tim_per_ms / 1000000u);
+    TIM5->SR = 0; // UG flagged an update
+    TIM5->CCR1 = target;
+    if (TIM5->CNT >= target) TIM5->EGR = TIM_EGR_CC1G; // Already due: wake at once
+
+    __DSB();
+    __WFI();
+
+    // And back: every timer period up to here is accounted for
+    uint32_t slept = TIM5->CNT;
+    SysTick->VAL = 0; // Fresh period from here
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    TIM5->CR1 = 0;
+    uint32_t slept_us = slept / (tim_per_ms / 1000u);
+    uint8_t deadline = (TIM5->SR & TIM_SR_CC1IF) != 0;
+    TIM5->DIER = 0;
+    TIM5->SR = 0;
+    NVIC_ClearPendingIRQ(TIM5_IRQn);
+
+    uwTick += Clock_TickCatchUp(partial_ns, Clock_Ns(slept, tree.tim3_clk), &carry_ns);
+    asleep_us += slept_us;
+    __enable_irq();
+    if (deadline) Events_Post(EVT_DEADLINE, 0);
+}
+
+uint32_t Power_NowUs(void) {
+    uint32_t ms, val, load = SysTick->LOAD + 1u;
+
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    // From an interrupt that masks the SysTick, a wrap is pending rather than counted
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && val > load / 2u) ms++;
+    return ms * 1000u + (uint32_t)((uint64_t)(load - 1u - val) * 1000u / load);
+}
+
+uint8_t Power_Residency(void) {
+    uint32_t now = HAL_GetTick();
+    uint32_t span_ms = now - window_start;
+    uint32_t pct = span_ms ? asleep_us / (10u * span_ms) : 0;
+
+    asleep_us = 0;
+    window_start = now;
+    return (pct > 100) ? 100 : (uint8_t)pct;
+}
+
+void Power_IRQHandler(void) {
+    // Normally cleared by Power_Idle before interrupts are unmasked
+    TIM5->DIER = 0;
+    TIM5->SR = 0;
+    Events_Post(EVT_DEADLINE, 0);
+}
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    profiler.c
+  * @brief   DWT cycle-count profiler.
+  ******************************************************************************
+  */
+
+#include "profiler.h"
+
+static ProfStat stats[PROF_COUNT];
+
+static const char *const names[PROF_COUNT] = {
+    "WAVE BUILD",
+    "TX START",
+    "LCD WAKE",
+    "RF BLOCK",
+    "DEMOD EDGE",
+    "UI FRAME",
+};
+
+// --- PUBLIC FUNCTIONS ---
+
+void Prof_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void Prof_Record(ProfId id, uint32_t start) {
+    uint32_t cycles = DWT->CYCCNT - start;
+    ProfStat *s = &stats[id];
+
+    s->last = cycles;
+    if (cycles > s->max) s->max = cycles;
+    if (s->count == 0 || cycles < s->min) s->min = cycles;
+    s->last_us = Prof_Us(cycles);
+    if (s->last_us > s->max_us) s->max_us = s->last_us;
+    s->count++;
+}
+
+void Prof_RecordUs(ProfId id, uint32_t us) {
+    ProfStat *s = &stats[id];
+
+    s->last_us = us;
+    if (us > s->max_us) s->max_us = us;
+    s->count++;
+}
+
+void Prof_Reset(ProfId id) {
+    stats[id] = (ProfStat){0};
+}
+
+const ProfStat* Prof_Get(ProfId id) {
+    return &stats[id];
+}
+
+const char* Prof_Name(ProfId id) {
+    return names[id];
+}
+
+uint32_t Prof_Us(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000u);
+}
@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    rawcap.c
+  * @brief   Raw edge-timing capture: delta + varint coding of run widths.
+  ******************************************************************************
+  */
+
+#include "rawcap.h"
+#include <string.h>
+
+enum { RC_WAITING, RC_RECORDING, RC_DONE };
+
+// --- CODING ---
+
+static uint32_t Zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t Unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1u);
+}
+
+/* Appends one run; returns 0 if the buffer is full */
+static uint8_t Emit(RawCapture *rc, uint8_t level, uint16_t width) {
+    uint32_t v = Zigzag((int32_t)width - rc->prev[level]);
+    uint8_t tmp[3];
+    uint8_t n = 0;
+
+    do {
+        tmp[n] = v & 0x7F;
+        v >>= 7;
+        if (v) tmp[n] |= 0x80;
+        n++;
+    } while (v);
+
+    if (rc->len + n > RAWCAP_MAX_BYTES) return 0;
+    memcpy(&rc->buf[rc->len], tmp, n);
+    rc->len += n;
+    rc->prev[level] = width;
+    rc->runs++;
+    return 1;
+}
+
+static void Finish(RawCapture *rc) {
+    if (rc->runs < RAWCAP_MIN_RUNS) {
+        Rawcap_Begin(rc); // Noise burst: keep waiting for a real signal
+        return;
+    }
+    rc->buf[2] = rc->runs & 0xFF;
+    rc->buf[3] = rc->runs >> 8;
+    rc->state = RC_DONE;
+}
+
+// --- CAPTURE ---
+
+void Rawcap_Begin(RawCapture *rc) {
+    rc->len = RAWCAP_HEADER_LEN;
+    rc->runs = 0;
+    rc->cycles = 0;
+    rc->prev[0] = rc->prev[1] = 0;
+    rc->state = RC_WAITING;
+    rc->buf[0] = RAWCAP_FORMAT;
+}
+
+uint8_t Rawcap_Feed(RawCapture *rc, uint8_t level, uint16_t cycles) {
+    level = level ? 1 : 0;
+
+    switch (rc->state) {
+        case RC_WAITING:
+            if (cycles >= RAWCAP_IDLE) return 0;
+            rc->state = RC_RECORDING;
+            rc->buf[1] = level;
+            rc->pend_level = level;
+            rc->pend_width = cycles;
+            rc->cycles = cycles;
+            return 0;
+
+        case RC_RECORDING:
+            if (cycles >= RAWCAP_IDLE) { // Tag left the field
+                Emit(rc, rc->pend_level, rc->pend_width);
+                Finish(rc);
+                break;
+            }
+            rc->cycles += cycles;
+            if (level == rc->pend_level) {
+                // Saturated run split by the front end: merge it back
+                uint32_t w = (uint32_t)rc->pend_width + cycles;
+                rc->pend_width = (w > 0xFFFF) ? 0xFFFF : (uint16_t)w;
+                return 0;
+            }
+            if (!Emit(rc, rc->pend_level, rc->pend_width) || rc->cycles >= RAWCAP_WINDOW) {
+                Finish(rc);
+                break;
+            }
+            rc->pend_level = level;
+            rc->pend_width = cycles;
+            return 0;
+
+        default:
+            break;
+    }
+    return rc->state == RC_DONE;
+}
+
+uint8_t Rawcap_IsDone(const RawCapture *rc) {
+    return rc->state == RC_DONE;
+}
+
+const uint8_t* Rawcap_Blob(const RawCapture *rc, uint16_t *len) {
+    *len = rc->len;
+    return rc->buf;
+}
+
+// --- PLAYBACK ---
+
+uint8_t Rawcap_Open(RawReader *r, const uint8_t *blob, uint16_t len) {
+    if (blob == NULL || len < RAWCAP_HEADER_LEN || blob[0] != RAWCAP_FORMAT) return 0;
+
+    r->blob = blob;
+    r->end = blob + len;
+    r->total = blob[2] | ((uint16_t)blob[3] << 8);
+    Rawcap_Rewind(r);
+    return r->total > 0;
+}
+
+void Rawcap_Rewind(RawReader *r) {
+    r->p = r->blob + RAWCAP_HEADER_LEN;
+    r->left = r->total;
+    r->prev[0] = r->prev[1] = 0;
+    r->level = r->blob[1] & 1u;
+}
+
+uint8_t Rawcap_Next(RawReader *r, uint8_t *level, uint16_t *cycles) {
+    if (r->left == 0) return 0;
+
+    uint32_t v = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+    do {
+        if (r->p >= r->end || shift > 21) return 0; // Truncated / malformed
+        b = *r->p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    int32_t w = (int32_t)r->prev[r->level] + Unzigzag(v);
+    if (w < 1 || w > 0xFFFF) return 0;
+
+    *level = r->level;
+    *cycles = (uint16_t)w;
+    r->prev[r->level] = (uint16_t)w;
+    r->level ^= 1;
+    r->left--;
+    return 1;
+}
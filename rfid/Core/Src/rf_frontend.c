@@ -0,0 +1,307 @@
+/**
+  ******************************************************************************
+  * @file    rf_frontend.c
+  * @brief   125 kHz carrier generation and envelope acquisition.
+  *
+  * TIM3 CH1 (PA6) and CH2 (PB5) drive the coil push-pull. CH4 has no pin;
+  * its OC4REF edge is routed to TRGO and starts one ADC1 conversion (PA0) per
+  * carrier cycle at a programmable phase, so every sample lands at the same
+  * point of the wave and the sample stream is the envelope. DMA2 Stream0
+  * writes the results into a double buffer; the transfer-complete interrupt
+  * runs the finished half through DC removal -> decimation -> slicer and
+  * appends the run lengths of the sliced signal to the edge ring. At full
+  * rate (PSK at RF/2) the decimation stage is skipped.
+  *
+  * TIM/ADC HAL modules are not enabled in this project, so the peripherals
+  * are programmed through their registers.
+  ******************************************************************************
+  */
+
+#include "rf_frontend.h"
+#include "arena.h"
+#include "dsp.h"
+#include "profiler.h"
+#include "events.h"
+
+#define DC_SHIFT        10   // DC tracker time constant: 1024 sample pairs (~16 ms)
+#define SLICE_DECAY     1    // Envelope extremes relax 1 code per processed sample
+#define SLICE_MIN_SPAN  24   // ADC codes of swing needed before slicing
+
+// --- ACQUISITION BUFFERS (DMA double buffer) ---
+static int16_t rx_buf[2][RF_BLOCK] __attribute__((aligned(4))) ARENA_RF;
+
+// --- DSP CHAIN ---
+static DspDcBlock dc_block;
+static DspDecimator decimator;
+static DspSlicer slicer;
+static const DspStage chain[] = {
+    { Dsp_DcBlock,  &dc_block  },
+    { Dsp_Decimate, &decimator },
+    { Dsp_Slice,    &slicer    },
+};
+static const DspStage chain_full_rate[] = {
+    { Dsp_DcBlock,  &dc_block  },
+    { Dsp_Slice,    &slicer    },
+};
+
+// --- EDGE RING (ISR produces, main loop consumes) ---
+static uint16_t edge_ring[RF_EDGE_RING] ARENA_RF;
+static volatile uint16_t edge_head;
+static volatile uint16_t edge_tail;
+static volatile uint32_t edge_dropped;
+
+static uint8_t running;
+static volatile uint8_t full_rate;
+static uint8_t dc_seeded;
+static int16_t run_level;
+static uint32_t run_cycles;
+static uint16_t carrier_arr = RF_CARRIER_ARR;
+static uint16_t sample_phase = (RF_CARRIER_ARR + 1) / 4; // Quarter period after the rising edge
+
+// --- PRIVATE HELPERS ---
+
+static RAMFUNC void Edge_Push(uint16_t entry) {
+    uint16_t next = (edge_head + 1) & (RF_EDGE_RING - 1);
+    if (next == edge_tail) {
+        edge_dropped++;
+        return;
+    }
+    edge_ring[edge_head] = entry;
+    edge_head = next;
+}
+
+/* Extends the current run or closes it on a level change */
+static RAMFUNC void Track_Runs(const int16_t *levels, uint16_t n, uint32_t cycles_per_sample) {
+    for (uint16_t i = 0; i < n; i++) {
+        if (levels[i] != run_level) {
+            Edge_Push((run_level > 0 ? RF_EDGE_LEVEL : 0) | (uint16_t)run_cycles);
+            run_level = levels[i];
+            run_cycles = 0;
+        }
+        run_cycles += cycles_per_sample;
+        if (run_cycles >= RF_EDGE_CYCLES) {
+            Edge_Push((run_level > 0 ? RF_EDGE_LEVEL : 0) | RF_EDGE_CYCLES);
+            run_cycles -= RF_EDGE_CYCLES;
+        }
+    }
+}
+
+static void Pins_Init(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+
+    // Coil drive: TIM3_CH1 (PA6), TIM3_CH2 (PB5)
+    GPIO_InitStruct.Pin = GPIO_PIN_6;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF2_TIM3;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    GPIO_InitStruct.Pin = GPIO_PIN_5;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    // Envelope input: ADC1_IN0 (PA0)
+    GPIO_InitStruct.Pin = GPIO_PIN_0;
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    GPIO_InitStruct.Alternate = 0;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+static void Carrier_Init(void) {
+    __HAL_RCC_TIM3_CLK_ENABLE();
+
+    TIM3->CR1 = TIM_CR1_ARPE; // Period changes take effect at the next update
+    TIM3->PSC = 0;
+    TIM3->ARR = carrier_arr;
+    TIM3->CCR1 = (carrier_arr + 1) / 2;
+    TIM3->CCR2 = (carrier_arr + 1) / 2;
+    TIM3->CCR4 = sample_phase;
+
+    TIM3->CCMR1 = RF_CCMR1_CARRIER_ON;
+    // CH4 PWM2: OC4REF rises at CCR4, which is the sampling instant
+    TIM3->CCMR2 = (7u << TIM_CCMR2_OC4M_Pos) | TIM_CCMR2_OC4PE;
+    TIM3->CR2 = (7u << TIM_CR2_MMS_Pos); // TRGO = OC4REF
+    TIM3->CCER = TIM_CCER_CC1E | TIM_CCER_CC2E;
+    TIM3->EGR = TIM_EGR_UG;
+}
+
+static void Adc_Dma_Init(void) {
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    // DMA2 Stream0 / Channel 0 = ADC1, 16-bit, double buffer
+    DMA_Stream_TypeDef *st = DMA2_Stream0;
+    st->CR &= ~DMA_SxCR_EN;
+    while (st->CR & DMA_SxCR_EN);
+    DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 |
+                  DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0;
+
+    st->PAR = (uint32_t)&ADC1->DR;
+    st->M0AR = (uint32_t)rx_buf[0];
+    st->M1AR = (uint32_t)rx_buf[1];
+    st->NDTR = RF_BLOCK;
+    st->FCR = 0; // Direct mode
+    st->CR = DMA_SxCR_DBM | DMA_SxCR_CIRC | DMA_SxCR_PL_1 |
+             DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC |
+             DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    st->CR |= DMA_SxCR_EN;
+
+    // ADCCLK = PCLK2 / 4 = 21 MHz; 15 + 12 cycles per conversion (~1.3 us)
+    ADC->CCR = (ADC->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;
+    ADC1->CR1 = 0;                         // 12-bit, single channel
+    ADC1->SMPR2 = (1u << ADC_SMPR2_SMP0_Pos);
+    ADC1->SQR1 = 0;                        // One conversion...
+    ADC1->SQR3 = 0;                        // ...of channel 0
+    ADC1->SR = 0;
+    ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS |
+                ADC_CR2_EXTEN_0 |          // Rising edge of...
+                ADC_CR2_EXTSEL_3;          // ...TIM3_TRGO
+
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 0, 1);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void RF_Frontend_Start(void) {
+    if (running) return;
+
+    Dsp_DcBlock_Init(&dc_block, DC_SHIFT, 0);
+    Dsp_Decimator_Init(&decimator, RF_DECIM_LOG2);
+    Dsp_Slicer_Init(&slicer, SLICE_DECAY, SLICE_MIN_SPAN);
+    dc_seeded = 0;
+    run_level = DSP_SLICE_LOW;
+    run_cycles = 0;
+    RF_Frontend_FlushEdges();
+
+    Pins_Init();
+    Carrier_Init();
+    Adc_Dma_Init();
+
+    running = 1;
+    TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+void RF_Frontend_Stop(void) {
+    if (!running) return;
+
+    // Force both coil outputs low before stopping the counter
+    TIM3->CCMR1 = RF_CCMR1_CARRIER_OFF;
+    TIM3->CCER = TIM_CCER_CC1E | TIM_CCER_CC2E;
+    TIM3->CR1 &= ~TIM_CR1_CEN;
+
+    HAL_NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+    ADC1->CR2 = 0;
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+
+    running = 0;
+}
+
+uint8_t RF_Frontend_IsRunning(void) {
+    return running;
+}
+
+void RF_Frontend_SetFullRate(uint8_t on) {
+    on = on ? 1 : 0;
+    if (on != full_rate) Prof_Reset(PROF_RF_BLOCK); // Twice the slicing is not jitter
+    full_rate = on;
+}
+
+void RF_Frontend_SetSamplePhase(uint16_t ticks) {
+    sample_phase = (ticks > carrier_arr) ? carrier_arr : ticks;
+    if (running) TIM3->CCR4 = sample_phase; // Preloaded: applies at the next period
+}
+
+uint8_t RF_Frontend_SetCarrierArr(uint16_t arr) {
+    if (arr + RF_CARRIER_TRIM < RF_CARRIER_ARR || arr > RF_CARRIER_ARR + RF_CARRIER_TRIM) return 0;
+
+    carrier_arr = arr;
+    if (sample_phase > arr) sample_phase = arr;
+    if (running) {
+        // All preloaded: the new period starts cleanly at the next update
+        TIM3->ARR = arr;
+        TIM3->CCR1 = (arr + 1) / 2;
+        TIM3->CCR2 = (arr + 1) / 2;
+        TIM3->CCR4 = sample_phase;
+    }
+    return 1;
+}
+
+uint16_t RF_Frontend_CarrierArr(void) {
+    return carrier_arr;
+}
+
+void RF_Frontend_RestartLevel(void) {
+    dc_seeded = 0;
+}
+
+uint16_t RF_Frontend_ReadEdges(uint16_t *dst, uint16_t max) {
+    uint16_t n = 0;
+    uint16_t tail = edge_tail;
+    uint16_t head = edge_head;
+
+    while (tail != head && n < max) {
+        dst[n++] = edge_ring[tail];
+        tail = (tail + 1) & (RF_EDGE_RING - 1);
+    }
+    edge_tail = tail;
+    return n;
+}
+
+void RF_Frontend_FlushEdges(void) {
+    edge_tail = edge_head;
+}
+
+int16_t RF_Frontend_CarrierLevel(void) {
+    return (int16_t)(dc_block.dc >> 16);
+}
+
+uint32_t RF_Frontend_Dropped(void) {
+    return edge_dropped;
+}
+
+RAMFUNC void RF_Frontend_IRQHandler(void) {
+    uint32_t isr = DMA2->LISR;
+
+    if (isr & DMA_LISR_TEIF0) {
+        // Transfer error disables the stream: re-arm from a clean state
+        DMA2->LIFCR = DMA_LIFCR_CTEIF0;
+        running = 0;
+        RF_Frontend_Start();
+        return;
+    }
+    if (!(isr & DMA_LISR_TCIF0)) return;
+    DMA2->LIFCR = DMA_LIFCR_CTCIF0;
+    uint32_t t0 = Prof_Now();
+    uint8_t seeding = !dc_seeded; // The extra pass over the block stays out of the figures
+    uint16_t head0 = edge_head;
+    uint32_t dropped0 = edge_dropped;
+
+    // CT already points at the half being filled; the other one is complete
+    int16_t *block = (DMA2_Stream0->CR & DMA_SxCR_CT) ? rx_buf[0] : rx_buf[1];
+
+    if (!dc_seeded) {
+        // Seed with the block mean: skips the long settle from 0 (or from the old level)
+        int32_t sum = 0;
+        for (uint16_t i = 0; i < RF_BLOCK; i++) sum += block[i];
+        Dsp_DcBlock_Init(&dc_block, DC_SHIFT, (int16_t)(sum / RF_BLOCK));
+        dc_seeded = 1;
+    }
+
+    uint16_t n;
+    if (full_rate) {
+        n = Dsp_Run(chain_full_rate, sizeof(chain_full_rate) / sizeof(chain_full_rate[0]), block, RF_BLOCK);
+        Track_Runs(block, n, 1);
+    } else {
+        n = Dsp_Run(chain, sizeof(chain) / sizeof(chain[0]), block, RF_BLOCK);
+        Track_Runs(block, n, 1u << RF_DECIM_LOG2);
+    }
+    if (!seeding) Prof_Record(PROF_RF_BLOCK, t0);
+
+    uint16_t queued = (edge_head - head0) & (RF_EDGE_RING - 1);
+    if (queued) Events_Post(EVT_RF_BLOCK, queued);
+    if (edge_dropped != dropped0) Events_Post(EVT_RF_OVERRUN, (uint16_t)(edge_dropped - dropped0));
+}
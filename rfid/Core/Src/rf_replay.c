@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file    rf_replay.c
+  * @brief   Timeline replay through TIM1 + DMA.
+  *
+  * TIM1 is prescaled to one tick per half carrier cycle. CH1 (PA8) drives the
+  * load-modulation switch in toggle mode with CCR1 = 1, so the output flips
+  * one tick after every update and each timer period is exactly one run.
+  * ARR is preloaded: the value DMA2 Stream5 writes on update N becomes the
+  * period after N + 1. The last two runs are primed by hand, then circular
+  * DMA walks the timeline from its first run, so the loop is seamless and
+  * the CPU only sees one interrupt per pass (loop counter).
+  *
+  * A playlist is an endless stream instead: DMA runs a double buffer and the
+  * transfer-complete interrupt refills the idle half from the playlist
+  * cursor. Edges still come from the timer; the interrupt has a whole half
+  * buffer of runs to finish in.
+  ******************************************************************************
+  */
+
+#include "rf_replay.h"
+#include "arena.h"
+#include "rf_frontend.h"
+
+#define REPLAY_PSC  (RF_REPLAY_TIMER_CLK / (RF_CARRIER_HZ * WAVE_TICKS_PER_CYCLE) - 1)
+
+// --- PLAYLIST STREAM (DMA double buffer) ---
+static uint16_t arr_buf[2][RF_REPLAY_BLOCK] ARENA_RF;
+static Playlist *playlist;  // NULL while a single timeline loops
+
+static uint32_t loops;
+static uint8_t running;
+
+// --- PRIVATE HELPERS ---
+
+static void Pins_Init(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+
+    // Load modulation switch: TIM1_CH1 (PA8)
+    GPIO_InitStruct.Pin = GPIO_PIN_8;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF1_TIM1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+}
+
+static RAMFUNC void Fill(uint16_t *dst) {
+    for (uint16_t i = 0; i < RF_REPLAY_BLOCK; i++) dst[i] = Playlist_Next(playlist);
+}
+
+/* DMA2 Stream5 / Channel 6 = TIM1_UP, memory -> TIM1->ARR, circular.
+   'm1' != NULL selects double-buffer mode. */
+static void Dma_Init(const uint16_t *m0, const uint16_t *m1, uint16_t n) {
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    DMA_Stream_TypeDef *st = DMA2_Stream5;
+    st->CR &= ~DMA_SxCR_EN;
+    while (st->CR & DMA_SxCR_EN);
+    DMA2->HIFCR = DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 |
+                  DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+
+    st->PAR = (uint32_t)&TIM1->ARR;
+    st->M0AR = (uint32_t)m0;
+    st->M1AR = (uint32_t)m1;
+    st->NDTR = n;
+    st->FCR = 0; // Direct mode
+    st->CR = (6u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 |
+             (m1 ? DMA_SxCR_DBM : 0) | DMA_SxCR_CIRC | DMA_SxCR_PL_1 |
+             DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC |
+             DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    st->CR |= DMA_SxCR_EN;
+
+    HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, 0, 1);
+    HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+}
+
+/* Primes the first two runs; the first one has envelope level 'level' */
+static void Timer_Init(uint16_t first, uint16_t second, uint8_t level) {
+    Pins_Init();
+    __HAL_RCC_TIM1_CLK_ENABLE();
+
+    TIM1->CR1 = TIM_CR1_ARPE;
+    TIM1->DIER = 0;
+    TIM1->PSC = REPLAY_PSC;
+    TIM1->RCR = 0;
+    TIM1->CCR1 = 1;
+    TIM1->ARR = first;
+    // Switch closed (REF high) while the tag's envelope is low. Start from the
+    // opposite state; the first toggle at CNT = 1 enters the first run.
+    TIM1->CCMR1 = ((level ? 5u : 4u) << TIM_CCMR1_OC1M_Pos);
+    TIM1->CCER = TIM_CCER_CC1E;
+    TIM1->BDTR = TIM_BDTR_MOE;
+    TIM1->EGR = TIM_EGR_UG;                   // Load PSC and the first run
+    TIM1->SR = 0;
+    TIM1->CCMR1 = (3u << TIM_CCMR1_OC1M_Pos); // Toggle on match
+    TIM1->ARR = second;                       // Applied at the first update
+}
+
+static void Timer_Go(void) {
+    running = 1;
+    TIM1->DIER = TIM_DIER_UDE;
+    TIM1->CR1 |= TIM_CR1_CEN;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+uint8_t RF_Replay_Start(const WaveTimeline *tl) {
+    if (running) RF_Replay_Stop();
+    if (tl->runs < 2 || (tl->runs & 1)) return 0; // Levels must alternate across the loop
+
+    loops = 0;
+    playlist = NULL;
+    // Even count: the second-to-last run has the level of run 0
+    Timer_Init(tl->arr[tl->runs - 2], tl->arr[tl->runs - 1], tl->first_level);
+    Dma_Init(tl->arr, NULL, tl->runs);
+    Timer_Go();
+    return 1;
+}
+
+uint8_t RF_Replay_StartPlaylist(Playlist *pl) {
+    if (running) RF_Replay_Stop();
+    if (pl->count == 0) return 0;
+
+    playlist = pl;
+    uint8_t level = Playlist_Rewind(pl);
+    uint16_t first = Playlist_Next(pl);
+    uint16_t second = Playlist_Next(pl);
+    Timer_Init(first, second, level);
+    Fill(arr_buf[0]);
+    Fill(arr_buf[1]);
+    Dma_Init(arr_buf[0], arr_buf[1], RF_REPLAY_BLOCK);
+    Timer_Go();
+    return 1;
+}
+
+void RF_Replay_Stop(void) {
+    if (!running) return;
+
+    TIM1->DIER = 0;
+    TIM1->CCMR1 = (4u << TIM_CCMR1_OC1M_Pos); // Force low: switch open
+    TIM1->CR1 &= ~TIM_CR1_CEN;
+
+    HAL_NVIC_DisableIRQ(DMA2_Stream5_IRQn);
+    DMA2_Stream5->CR &= ~DMA_SxCR_EN;
+
+    running = 0;
+}
+
+uint8_t RF_Replay_IsRunning(void) {
+    return running;
+}
+
+uint32_t RF_Replay_Loops(void) {
+    return playlist ? playlist->loops : loops;
+}
+
+RAMFUNC void RF_Replay_IRQHandler(void) {
+    uint32_t isr = DMA2->HISR;
+
+    if (isr & DMA_HISR_TEIF5) {
+        DMA2->HIFCR = DMA_HIFCR_CTEIF5;
+        RF_Replay_Stop(); // Timeline is broken; leave the switch open
+        return;
+    }
+    if (!(isr & DMA_HISR_TCIF5)) return;
+    DMA2->HIFCR = DMA_HIFCR_CTCIF5;
+
+    if (playlist) {
+        // CT already points at the half being read; refill the other one
+        Fill((DMA2_Stream5->CR & DMA_SxCR_CT) ? arr_buf[0] : arr_buf[1]);
+    } else {
+        loops++; // DMA wrapped to the first run
+    }
+}
@@ -0,0 +1,302 @@
+/**
+  ******************************************************************************
+  * @file    rf_writer.c
+  * @brief   T5577 clone writer: gap timelines, read-back verify, block retry.
+  *
+  * A command is precomputed into two tables: TIM1 periods (carrier cycles,
+  * PSC = one carrier period) and the TIM3->CCMR1 value for each period
+  * (coil driven or forced low). DMA2 Stream5 (TIM1_UP) reloads the
+  * preloaded ARR and DMA2 Stream1 (TIM1_CH1, CCR1 = 1) writes CCMR1 one tick
+  * into every period, so gap widths do not depend on code timing. The
+  * CCMR1 stream's transfer-complete ends the command with the field on.
+  *
+  * Data blocks are written first and block 0 (which switches the tag's
+  * modulation) last. Each block is then read back with a direct access
+  * command, decoded by a probe descriptor in the tag's new modulation and
+  * compared; a block 0 failure is rewritten before anything else is read.
+  * Subcarriers below RF_MIN_SUBCARRIER are read back at full rate.
+  ******************************************************************************
+  */
+
+#include "rf_writer.h"
+#include "arena.h"
+#include "rf_frontend.h"
+#include "rf_replay.h"
+#include "lf_protocols.h"
+#include "t5577.h"
+#include <string.h>
+
+#define TL_PSC  (RF_REPLAY_TIMER_CLK / RF_CARRIER_HZ - 1) // 1 tick = 1 carrier cycle
+
+typedef enum { STEP_IDLE, STEP_SEND_WRITE, STEP_PROGRAM, STEP_SEND_READ, STEP_LISTEN } Step;
+
+// --- TIMELINE (DMA sources) ---
+static uint16_t tl_cycles[T5577_TIMELINE_MAX] ARENA_RF;
+static uint16_t arr_tl[T5577_TIMELINE_MAX] ARENA_RF;
+static uint16_t ccmr_tl[T5577_TIMELINE_MAX] ARENA_RF;
+static volatile uint8_t tl_busy;
+
+// --- CLONE STATE ---
+static uint32_t image[T5577_MAX_BLOCKS];
+static uint8_t tries[T5577_MAX_BLOCKS];
+static uint8_t to_write;      // Bit per block
+static uint8_t to_verify;
+static Step step;
+static uint32_t step_start;
+static uint32_t clone_start;
+static LfProtocol probe_desc;
+static RfWriterStatus status;
+
+// --- TIMELINE OUTPUT ---
+
+static void Timeline_Stop(void) {
+    TIM1->DIER = 0;
+    TIM1->CR1 &= ~TIM_CR1_CEN;
+    DMA2_Stream5->CR &= ~DMA_SxCR_EN;
+    DMA2_Stream1->CR &= ~DMA_SxCR_EN;
+    HAL_NVIC_DisableIRQ(DMA2_Stream1_IRQn);
+    TIM3->CCMR1 = RF_CCMR1_CARRIER_ON; // Field on for programming / read-back
+    tl_busy = 0;
+}
+
+static void Dma_Stream(DMA_Stream_TypeDef *st, uint32_t channel, volatile uint32_t *dst,
+                       const uint16_t *src, uint16_t n, uint32_t irq) {
+    st->CR &= ~DMA_SxCR_EN;
+    while (st->CR & DMA_SxCR_EN);
+
+    st->PAR = (uint32_t)dst;
+    st->M0AR = (uint32_t)src;
+    st->NDTR = n;
+    st->FCR = 0; // Direct mode
+    st->CR = (channel << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_PL_1 |
+             DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | irq;
+    st->CR |= DMA_SxCR_EN;
+}
+
+/* Starts sending command bits; tl_busy clears when the last period began */
+static void Timeline_Send(const uint8_t *bits, uint8_t nbits) {
+    uint16_t n = T5577_Timeline(bits, nbits, tl_cycles, T5577_TIMELINE_MAX);
+
+    for (uint16_t k = 0; k < n; k++) {
+        ccmr_tl[k] = (k & 1) ? RF_CCMR1_CARRIER_ON : RF_CCMR1_CARRIER_OFF;
+        if (k >= 2) arr_tl[k - 2] = tl_cycles[k] - 1;
+    }
+
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    // Periods 0 and 1 are primed by hand (ARR is preloaded), DMA supplies the rest
+    TIM1->CR1 = TIM_CR1_ARPE;
+    TIM1->DIER = 0;
+    TIM1->PSC = TL_PSC;
+    TIM1->RCR = 0;
+    TIM1->ARR = tl_cycles[0] - 1;
+    TIM1->CCR1 = 1;
+    TIM1->CCMR1 = 0;  // CH1 frozen: compare events only, no pin
+    TIM1->CCER = 0;
+    TIM1->EGR = TIM_EGR_UG;
+    TIM1->SR = 0;
+    TIM1->ARR = tl_cycles[1] - 1;
+
+    DMA2->HIFCR = DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 |
+                  DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+    DMA2->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 |
+                  DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1;
+    Dma_Stream(DMA2_Stream5, 6, &TIM1->ARR, arr_tl, n - 2, 0);     // TIM1_UP
+    Dma_Stream(DMA2_Stream1, 6, &TIM3->CCMR1, ccmr_tl, n,          // TIM1_CH1
+               DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+
+    HAL_NVIC_SetPriority(DMA2_Stream1_IRQn, 0, 1);
+    HAL_NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+
+    tl_busy = 1;
+    TIM1->DIER = TIM_DIER_UDE | TIM_DIER_CC1DE;
+    TIM1->CR1 |= TIM_CR1_CEN;
+}
+
+// --- VERIFY ---
+
+/* Probe validator: any stable 32-bit loop; the caller compares it */
+static uint8_t Probe_Validate(const uint8_t *bits, LfFrame *out) {
+    for (uint8_t i = 0; i < 32; i++) LF_Frame_PutBit(out, bits[i]);
+    return 1;
+}
+
+/* The read-back starts anywhere in the loop and may come out inverted */
+static uint8_t Block_Matches(uint32_t expected, const LfFrame *f) {
+    uint32_t got = ((uint32_t)f->data[0] << 24) | ((uint32_t)f->data[1] << 16) |
+                   ((uint32_t)f->data[2] << 8) | f->data[3];
+    for (uint8_t r = 0; r < 32; r++) {
+        uint32_t rot = r ? (expected << r) | (expected >> (32 - r)) : expected;
+        if (got == rot || got == ~rot) return 1;
+    }
+    return 0;
+}
+
+static void Decoder_Restore(void) {
+    LF_Decoder_SetProbe(NULL);
+    for (uint8_t i = 0; i < lf_protocol_count; i++) LF_Decoder_Enable(lf_protocols[i].id, 1);
+}
+
+static void Finish(RfWriterState result) {
+    status.state = result;
+    status.elapsed_ms = HAL_GetTick() - clone_start;
+    step = STEP_IDLE;
+    Decoder_Restore();
+}
+
+static uint8_t Lowest(uint8_t mask) {
+    uint8_t b = 0;
+    while (!(mask & (1u << b))) b++;
+    return b;
+}
+
+/* Picks the next command: pending writes (block 0 last), then reads */
+static void Next_Action(void) {
+    uint8_t bits[T5577_CMD_MAX];
+
+    // A bad block 0 makes every other read meaningless: rewrite first
+    if (to_write && ((to_write & 1u) || !to_verify)) {
+        uint8_t b = (to_write & ~1u) ? Lowest(to_write & ~1u) : 0;
+        to_write &= ~(1u << b);
+        status.state = RF_WRITER_WRITING;
+        status.block = b;
+        Timeline_Send(bits, T5577_WriteCmd(bits, b, image[b], NULL));
+        step = STEP_SEND_WRITE;
+        return;
+    }
+    if (to_verify) {
+        uint8_t b = Lowest(to_verify);
+        status.state = RF_WRITER_VERIFYING;
+        status.block = b;
+        Timeline_Send(bits, T5577_ReadCmd(bits, b, NULL));
+        step = STEP_SEND_READ;
+        return;
+    }
+    Finish(RF_WRITER_DONE);
+}
+
+static void Verify_Result(uint8_t ok) {
+    uint8_t b = status.block;
+
+    to_verify &= ~(1u << b);
+    if (ok) {
+        status.verified |= 1u << b;
+    } else if (++tries[b] > RF_WRITER_RETRIES) {
+        Finish(RF_WRITER_FAILED);
+        return;
+    } else {
+        status.retries++;
+        to_write |= 1u << b;
+        to_verify |= 1u << b;
+    }
+    Next_Action();
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+uint8_t RF_Writer_Start(const LfProtocol *p, const LfFrame *id) {
+    uint8_t n = T5577_Blocks(p, id, image);
+    if (n == 0) return 0;
+
+    RF_Replay_Stop(); // TIM1 and DMA2 Stream5 are shared
+    // The read-back needs every sample when the subcarrier does not survive decimation
+    RF_Frontend_SetFullRate(p->modulation == LF_MOD_PSK1 && p->sub_a < RF_MIN_SUBCARRIER);
+    if (!RF_Frontend_IsRunning()) RF_Frontend_Start();
+
+    // Read-back descriptor: the tag's new modulation, one block per frame
+    probe_desc = *p;
+    probe_desc.id = LF_PROTO_NONE;
+    probe_desc.preamble = 0;
+    probe_desc.preamble_len = 0;
+    probe_desc.frame_len = 32;
+    probe_desc.flags = LF_FLAG_EITHER_POLARITY | LF_FLAG_REPEAT;
+    probe_desc.validate = Probe_Validate;
+    probe_desc.encode = NULL;
+
+    memset(&status, 0, sizeof(status));
+    memset(tries, 0, sizeof(tries));
+    status.blocks = n;
+    to_write = (uint8_t)((1u << n) - 1);
+    to_verify = to_write;
+    clone_start = HAL_GetTick();
+    Next_Action();
+    return 1;
+}
+
+void RF_Writer_Task(void) {
+    LfFrame frame;
+    uint16_t runs[32];
+    uint16_t n;
+
+    switch (step) {
+        case STEP_SEND_WRITE:
+            if (tl_busy) return;
+            step = STEP_PROGRAM;
+            step_start = HAL_GetTick();
+            break;
+
+        case STEP_PROGRAM:
+            // +1: a tick boundary may fall right after the command ended
+            if (HAL_GetTick() - step_start < T5577_PROG_MS + 1) return;
+            Next_Action();
+            break;
+
+        case STEP_SEND_READ:
+            if (tl_busy) return;
+            // Only the tag's answer from here on: drop the gaps' own edges
+            for (uint8_t i = 0; i < lf_protocol_count; i++) LF_Decoder_Enable(lf_protocols[i].id, 0);
+            LF_Decoder_Reset();
+            LF_Decoder_SetProbe(&probe_desc);
+            RF_Frontend_FlushEdges();
+            step = STEP_LISTEN;
+            step_start = HAL_GetTick();
+            break;
+
+        case STEP_LISTEN:
+            while ((n = RF_Frontend_ReadEdges(runs, 32)) > 0) {
+                for (uint16_t i = 0; i < n; i++) {
+                    if (LF_Decoder_Feed((runs[i] & RF_EDGE_LEVEL) ? 1 : 0, runs[i] & RF_EDGE_CYCLES, &frame)) {
+                        Verify_Result(Block_Matches(image[status.block], &frame));
+                        return;
+                    }
+                }
+            }
+            if (HAL_GetTick() - step_start >= RF_WRITER_VERIFY_MS) Verify_Result(0);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void RF_Writer_Abort(void) {
+    if (step == STEP_IDLE) return;
+    if (tl_busy) Timeline_Stop();
+    Decoder_Restore();
+    step = STEP_IDLE;
+    status.state = RF_WRITER_IDLE;
+}
+
+uint8_t RF_Writer_IsBusy(void) {
+    return step != STEP_IDLE;
+}
+
+const RfWriterStatus* RF_Writer_Status(void) {
+    return &status;
+}
+
+void RF_Writer_IRQHandler(void) {
+    uint32_t isr = DMA2->LISR;
+
+    if (isr & DMA_LISR_TEIF1) {
+        DMA2->LIFCR = DMA_LIFCR_CTEIF1;
+        Timeline_Stop(); // The command is cut short; verify will catch it
+        return;
+    }
+    if (!(isr & DMA_LISR_TCIF1)) return;
+    DMA2->LIFCR = DMA_LIFCR_CTCIF1;
+
+    // The last entry (field on) has been written: the command is out
+    Timeline_Stop();
+}
@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file    search.c
+  * @brief   Incremental fuzzy search over signal names.
+  *
+  * Matching is a case-insensitive subsequence test. Search_Begin() reads
+  * every name once into a character index: for each character, the entries
+  * that contain it with a bitmask of the positions where it occurs. Typing a
+  * character walks that character's list only: an entry still in the running
+  * moves on to the first occurrence after its previous match, which is one
+  * mask operation. Entries without the character drop out untouched.
+  *
+  * Each entry keeps where every query level's match ended, so backspace just
+  * lowers the depth. Entries are stamped with the keystroke that last wrote
+  * them; a level whose query character was retyped since then no longer
+  * counts, which retires stale deeper matches without visiting them.
+  ******************************************************************************
+  */
+
+#include "search.h"
+#include "arena.h"
+#include <stddef.h>
+
+#if SEARCH_NAME_MAX > 15
+#error "Match ends must fit a nibble"
+#endif
+
+#define CLASSES      96           // Folded printable ASCII, ' '..DEL
+#define CLASS(c)     ((uint8_t)((c) - ' '))
+#define IN_CLASS(c)  ((c) >= ' ' && (c) <= '~')
+
+typedef struct {
+    uint16_t entry;
+    uint16_t mask;     // Bit n: the character is at name position n
+} Posting;
+
+typedef struct {
+    uint16_t seq;      // Keystroke that last wrote the entry
+    uint8_t level;     // 1 + query levels matched as of 'seq', 0: never matches
+    uint8_t ends[(SEARCH_MAX_QUERY + 1) / 2]; // Per level: name index after its match
+} EntryState;
+
+// --- INDEX ---
+static Search_NameFn name_of;
+static uint16_t entry_count;
+static uint16_t class_start[CLASSES + 1];                     // Postings of class c: [c], [c + 1])
+static Posting postings[SEARCH_MAX_POSTINGS] ARENA_UI;        // By class, then by entry
+static EntryState entry_state[SEARCH_MAX_ENTRIES] ARENA_UI;
+
+// --- QUERY STATE ---
+static char query[SEARCH_MAX_QUERY + 1];
+static uint8_t depth;
+static uint16_t cand_count[SEARCH_MAX_QUERY + 1];
+static uint16_t seq;                                          // Keystrokes this session
+static uint16_t typed_at[SEARCH_MAX_QUERY];                   // Keystroke that set each query character
+
+// --- PRIVATE HELPERS ---
+
+static char Fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static uint8_t End(const EntryState *e, uint8_t level) {
+    return (uint8_t)((e->ends[(level - 1) / 2] >> (((level - 1) & 1u) * 4)) & 0x0Fu);
+}
+
+static void Set_End(EntryState *e, uint8_t level, uint8_t end) {
+    uint8_t shift = (uint8_t)(((level - 1) & 1u) * 4);
+    uint8_t *b = &e->ends[(level - 1) / 2];
+    *b = (uint8_t)((*b & ~(0x0Fu << shift)) | (end << shift));
+}
+
+/* 1 + levels of the first 'upto' query characters the entry still matches */
+static uint8_t Level(const EntryState *e, uint8_t upto) {
+    uint8_t valid = 1;
+    while (valid <= upto && typed_at[valid - 1] <= e->seq) valid++;
+    return (e->level < valid) ? e->level : valid;
+}
+
+/* Positions of 'c' in the name of entry 'i' (binary search of its class) */
+static uint16_t Mask(uint16_t i, char c) {
+    if (!IN_CLASS(c)) return 0;
+    uint16_t lo = class_start[CLASS(c)], hi = class_start[CLASS(c) + 1];
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (postings[mid].entry < i) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < class_start[CLASS(c) + 1] && postings[lo].entry == i) ? postings[lo].mask : 0;
+}
+
+/* Distinct indexed characters of 'n', as a mask per class in 'masks' (cleared) */
+static uint8_t Name_Masks(const char *n, uint16_t *masks, uint8_t *classes) {
+    uint8_t count = 0;
+    for (uint8_t at = 0; n[at] && at < SEARCH_NAME_MAX; at++) {
+        char c = Fold(n[at]);
+        if (!IN_CLASS(c)) continue;
+        if (!masks[CLASS(c)]) classes[count++] = CLASS(c);
+        masks[CLASS(c)] |= (uint16_t)(1u << at);
+    }
+    return count;
+}
+
+/* Keystroke stamps wrapped: settle every entry at the current query, restart */
+static void Restamp(void) {
+    for (uint16_t i = 0; i < entry_count; i++) {
+        entry_state[i].level = Level(&entry_state[i], depth);
+        entry_state[i].seq = 0;
+    }
+    for (uint8_t k = 0; k < depth; k++) typed_at[k] = 0;
+    seq = 0;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Search_Begin(Search_NameFn name, uint16_t count) {
+    uint16_t masks[CLASSES] = { 0 };
+    uint8_t classes[SEARCH_NAME_MAX];
+    uint16_t total = 0;
+
+    name_of = name;
+    entry_count = (count > SEARCH_MAX_ENTRIES) ? SEARCH_MAX_ENTRIES : count;
+    depth = 0;
+    query[0] = '\0';
+    seq = 0;
+    cand_count[0] = 0;
+
+    // Pass 1: postings per class, as many entries as the index holds
+    for (uint16_t c = 0; c <= CLASSES; c++) class_start[c] = 0;
+    for (uint16_t i = 0; i < entry_count; i++) {
+        const char *n = name_of(i);
+        entry_state[i].level = 0;
+        entry_state[i].seq = 0;
+        if (n == NULL) continue;
+
+        uint8_t k = Name_Masks(n, masks, classes);
+        uint8_t fits = total + k <= SEARCH_MAX_POSTINGS;
+        total += k;
+        while (k--) {
+            class_start[classes[k] + 1] += fits;
+            masks[classes[k]] = 0;
+        }
+        if (!fits) {
+            entry_count = i; // Full: this and the rest are never matched
+            break;
+        }
+        entry_state[i].level = 1;
+        cand_count[0]++;
+    }
+    for (uint16_t c = 0; c < CLASSES; c++) class_start[c + 1] += class_start[c];
+
+    // Pass 2: fill each class in entry order (class_start[c] runs to the end of c)
+    for (uint16_t i = 0; i < entry_count; i++) {
+        if (!entry_state[i].level) continue;
+        uint8_t k = Name_Masks(name_of(i), masks, classes);
+        while (k--) {
+            Posting *p = &postings[class_start[classes[k]]++];
+            p->entry = i;
+            p->mask = masks[classes[k]];
+            masks[classes[k]] = 0;
+        }
+    }
+    for (uint16_t c = CLASSES; c > 0; c--) class_start[c] = class_start[c - 1];
+    class_start[0] = 0;
+}
+
+uint8_t Search_Push(char c) {
+    if (depth >= SEARCH_MAX_QUERY) return 0;
+    if (seq == 0xFFFFu) Restamp();
+
+    uint8_t prev = depth;
+    uint8_t next = depth + 1;
+    char qc = Fold(c);
+
+    query[prev] = qc;
+    query[next] = '\0';
+    typed_at[prev] = ++seq;
+    cand_count[next] = 0;
+
+    if (IN_CLASS(qc)) {
+        for (uint16_t p = class_start[CLASS(qc)]; p < class_start[CLASS(qc) + 1]; p++) {
+            EntryState *e = &entry_state[postings[p].entry];
+            if (Level(e, prev) <= prev) continue; // Dropped at an earlier level
+
+            // First occurrence after the previous level's match
+            uint8_t at = prev ? End(e, prev) : 0;
+            uint16_t later = postings[p].mask & (uint16_t)(0xFFFFu << at);
+            if (!later) continue;
+
+            e->level = next + 1;
+            e->seq = seq;
+            Set_End(e, next, (uint8_t)(__builtin_ctz(later) + 1));
+            cand_count[next]++;
+        }
+    }
+
+    depth = next;
+    return 1;
+}
+
+void Search_Pop(void) {
+    if (depth == 0) return;
+    depth--;
+    query[depth] = '\0';
+}
+
+uint16_t Search_Count(void) {
+    return cand_count[depth];
+}
+
+const char* Search_Query(void) {
+    return query;
+}
+
+uint8_t Search_Score(uint16_t index) {
+    if (index >= entry_count || Level(&entry_state[index], depth) <= depth) return SEARCH_NONE;
+    if (depth == 0) return SEARCH_PREFIX;
+
+    // Bit n survives while the query so far reads from name position n
+    uint16_t starts = Mask(index, query[0]);
+    for (uint8_t k = 1; k < depth && starts; k++) starts &= Mask(index, query[k]) >> k;
+
+    if (starts & 1u) return SEARCH_PREFIX;
+    return starts ? SEARCH_SUBSTRING : SEARCH_FUZZY;
+}
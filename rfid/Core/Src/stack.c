@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    stack.c
+  * @brief   Stack high-water mark and MPU guard below the stack.
+  ******************************************************************************
+  */
+
+#include "stack.h"
+#include "arena.h"
+
+#define RECORD_MAGIC 0x5354414Bu // "STAK"
+
+extern uint32_t _sstack[], _estack[], _sstack_guard[]; // Linker script
+extern const StackBudget _stack_budget; // Filled in after the link
+
+typedef struct {
+    uint32_t magic;
+    uint32_t overflows;
+    uint32_t fault_addr;
+} FaultRecord;
+
+static FaultRecord record NOINIT;
+static StackStats stats;
+static uint32_t probed_at;
+
+// --- PRIVATE HELPERS ---
+
+/* Lowest word the stack has written since reset */
+static uint32_t Probe(void) {
+    const uint32_t *p = _sstack;
+    while (p < _estack && *p == STACK_PAINT) p++;
+    return (uint32_t)((uint8_t *)_estack - (uint8_t *)p);
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Stack_Init(void) {
+    MPU_Region_InitTypeDef region = {0};
+    uint32_t guard = (uint32_t)((uint8_t *)_sstack - (uint8_t *)_sstack_guard);
+
+    // Power-on leaves garbage, a reset keeps the record
+    if (record.magic != RECORD_MAGIC) {
+        record.magic = RECORD_MAGIC;
+        record.overflows = 0;
+        record.fault_addr = 0;
+    }
+    stats.size = (uint32_t)((uint8_t *)_estack - (uint8_t *)_sstack);
+    stats.overflows = record.overflows;
+    stats.fault_addr = record.fault_addr;
+    stats.peak = Probe();
+    probed_at = HAL_GetTick();
+
+    // Size field is log2(bytes) - 1; the linker script checks the alignment
+    HAL_MPU_Disable();
+    region.Enable = MPU_REGION_ENABLE;
+    region.Number = MPU_REGION_NUMBER0;
+    region.BaseAddress = (uint32_t)_sstack_guard;
+    region.Size = (uint8_t)(__builtin_ctz(guard) - 1);
+    region.SubRegionDisable = 0x00;
+    region.TypeExtField = MPU_TEX_LEVEL0;
+    region.AccessPermission = MPU_REGION_NO_ACCESS;
+    region.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    region.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+    region.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+    region.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+    HAL_MPU_ConfigRegion(&region);
+    // Everything else keeps the default map; MemManage stays disabled so a
+    // hit escalates to HardFault, which runs with the MPU off
+    HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
+
+void Stack_Poll(uint32_t now) {
+    if (now - probed_at < STACK_PROBE_MS) return;
+    probed_at = now;
+    stats.peak = Probe();
+}
+
+const StackStats* Stack_Get(void) {
+    return &stats;
+}
+
+const StackBudget* Stack_Budget(void) {
+    return &_stack_budget;
+}
+
+void Stack_Fault(void) {
+    uint32_t cfsr = SCB->CFSR;
+    uint32_t addr = (cfsr & SCB_CFSR_MMARVALID_Msk) ? SCB->MMFAR : 0;
+
+    // A push into the guard, or exception entry stacking into it
+    uint8_t in_guard = addr >= (uint32_t)_sstack_guard && addr < (uint32_t)_sstack;
+    if (!in_guard && !(cfsr & SCB_CFSR_MSTKERR_Msk)) return;
+
+    record.overflows++;
+    record.fault_addr = addr;
+    NVIC_SystemReset();
+}
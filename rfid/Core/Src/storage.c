@@ -2,56 +2,578 @@
   ******************************************************************************
   * @file    storage.c
   * @brief   Implementation of persistent storage using internal Flash.
+  *
+  * Layout: each of the two storage sectors is either erased or holds a log
+  *     [magic][generation][commit]  [record][record]...  (erased tail)
+  * and a record is
+  *     [type | slot << 8 | length << 16][crc32][payload, padded][commit]
+  * A signal record's payload is its name (NAME_BYTES) followed by the
+  * versioned payload blob (payload.h). Once a record is committed, the slot
+  * points straight at the blob in flash; RAM only holds blobs that are not
+  * committed yet, and the committer streams them from there.
+  * Every commit word is programmed last, so a power cut at any word leaves
+  * either a complete record or one that fails the check. Mounting replays the
+  * newest sector with a committed header up to the first erased or torn
+  * record; a torn record forces a compaction before anything else is appended.
+  * Compaction writes the live RAM state into the other sector and only then
+  * commits that sector's header with a higher generation, so the old log stays
+  * authoritative until the new one is complete.
+  *
+  * Note: the F401 has a single flash bank. Each word program stalls fetches
+  * for ~16us, which is fine; a sector erase stalls for ~1-2s and only happens
+  * when a compaction has to reuse a dirty sector.
   ******************************************************************************
   */
 
 #include "storage.h"
+#include "arena.h"
+#include "payload.h"
+#include "rf_frontend.h"
+#include "events.h"
 #include <string.h>
 
-// Total size needed for the database
-#define DB_SIZE (sizeof(Signal) * MAX_SLOTS)
+#if MAX_SLOTS > 32
+#error "The dirty set is a 32-bit mask"
+#endif
 
-void Storage_SaveSignals(void) {
-    HAL_FLASH_Unlock();
+#define NO_SECTOR       0xFF
+#define HEADER_WORDS    3                 // magic, generation, commit
+#define ITEM_CALIB      MAX_SLOTS         // Dirty-set / cursor id of the calibration
+#define ITEM_TUNE       (MAX_SLOTS + 1)   // ...and of the antenna tuning
+#define NAME_BYTES      12                // Name field of a signal record (NUL padded)
+#define STAGE_WORDS     8                 // Head, CRC and the fixed part of a record
+#define SMALL_STAGE     ((PAYLOAD_SMALL_MAX + 3) & ~3)
+#define RAW_STAGE       1024              // RAM home of one uncommitted payload with raw data
+#define MAX_RETRIES     3                 // Consecutive flash errors before giving up
+
+_Static_assert(NAME_LEN + 1 <= NAME_BYTES && NAME_BYTES % 4 == 0, "Name field layout");
+_Static_assert(sizeof(TouchCalib) % 4 == 0 && sizeof(TouchCalib) <= (STAGE_WORDS - 2) * 4,
+               "Calibration record layout");
+
+// --- RECORD TYPES ---
+enum {
+    REC_SIGNAL_V1 = 1, // Payload: LegacySignal (read for migration only)
+    REC_DELETE    = 2, // No payload: slot becomes inactive
+    REC_CALIB     = 3, // Payload: TouchCalib
+    REC_SIGNAL    = 4, // Payload: name[NAME_BYTES] + payload blob
+    REC_TUNE      = 5  // Payload: uint32_t carrier ARR
+};
+
+// Pre-payload signal layout (fixed array and REC_SIGNAL_V1 records)
+typedef struct {
+    char name[NAME_LEN + 1];
+    uint8_t is_active;
+    uint32_t protocol_data;
+} LegacySignal;
+
+// --- COMMITTER STATE ---
+typedef enum {
+    ST_IDLE,
+    ST_APPEND,         // Programming one record at the log tail
+    ST_COMPACT_ERASE,  // Erasing the spare sector
+    ST_COMPACT_COPY,   // Writing the live state into the spare sector
+    ST_COMPACT_COMMIT  // Programming the spare sector's header
+} StorageState;
+
+static StorageState state = ST_IDLE;
+static uint8_t active = NO_SECTOR;  // Sector holding the current log
+static uint8_t spare;               // Compaction target
+static uint32_t generation;
+static uint32_t log_tail;           // Next free address in the active sector
+static uint32_t spare_tail;
+static uint8_t log_broken;          // Torn record seen: compact before appending
+static uint8_t compact_cursor;      // Next slot (or ITEM_CALIB / ITEM_TUNE) to copy
+static uint8_t failures;
+
+// --- RAM JOURNAL ---
+static uint32_t dirty_slots;        // Bit per slot changed since its last commit
+static uint8_t calib_dirty;
+static uint8_t tune_dirty;
+static uint16_t tune_arr;           // Stored carrier period, 0 = never tuned
+
+// --- UNCOMMITTED PAYLOADS ---
+static uint8_t slot_stage[MAX_SLOTS][SMALL_STAGE] __attribute__((aligned(4))) ARENA_STORAGE;
+static uint8_t raw_stage[RAW_STAGE] __attribute__((aligned(4))) ARENA_STORAGE;
+static const uint8_t *moved_src[MAX_SLOTS]; // Compaction: payload copied from...
+static uint32_t moved_to[MAX_SLOTS];        // ...to this spare-sector address
+
+// --- STAGED IMAGE (one record or header being programmed) ---
+// Words [0, stage_fixed) come from 'stage', then the payload is streamed
+// from 'stage_src', then the commit word.
+static uint32_t stage[STAGE_WORDS];
+static uint8_t stage_fixed;
+static const uint8_t *stage_src;
+static uint16_t stage_src_len;
+static uint16_t stage_len;
+static uint16_t stage_pos;
+static uint32_t stage_addr;
+static uint8_t stage_item;
+
+// --- SET FROM THE FLASH INTERRUPT ---
+static volatile uint8_t flash_busy;
+static volatile uint8_t flash_error;
+
+// --- PRIVATE HELPERS ---
+
+static uint32_t Sector_Base(uint8_t sector) {
+    return sector ? STORAGE_SECTOR_B_ADDR : STORAGE_SECTOR_A_ADDR;
+}
+
+static uint32_t Sector_Number(uint8_t sector) {
+    return sector ? FLASH_SECTOR_7 : FLASH_SECTOR_6;
+}
+
+/* CRC-32 (IEEE), nibble table: small and fast enough for a few dozen bytes */
+static uint32_t Crc32(uint32_t crc, const uint8_t *data, uint32_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static uint32_t Record_Crc(uint32_t head, const void *payload, uint16_t length) {
+    uint32_t crc = Crc32(0, (const uint8_t *)&head, 4);
+    return Crc32(crc, (const uint8_t *)payload, length);
+}
+
+static uint8_t Header_Valid(uint8_t sector, uint32_t *gen) {
+    const uint32_t *hdr = (const uint32_t *)Sector_Base(sector);
+    if (hdr[0] != LOG_SECTOR_MAGIC || hdr[2] != LOG_COMMIT) return 0;
+    *gen = hdr[1];
+    return 1;
+}
+
+static uint8_t Sector_IsBlank(uint8_t sector) {
+    const uint32_t *p = (const uint32_t *)Sector_Base(sector);
+    for (uint32_t i = 0; i < STORAGE_SECTOR_SIZE / 4; i++) {
+        if (p[i] != 0xFFFFFFFF) return 0;
+    }
+    return 1;
+}
+
+static void Clear_Slot(uint8_t slot) {
+    memset(&signal_db[slot], 0, sizeof(Signal));
+}
+
+/* Converts an old fixed-layout signal; the dirty bit rewrites it in the new format */
+static void Migrate_Legacy(uint8_t slot, const LegacySignal *old) {
+    Clear_Slot(slot);
+    memcpy(signal_db[slot].name, old->name, NAME_LEN);
+    signal_db[slot].is_active = 1;
+    signal_db[slot].payload_len = Payload_FromLegacy(slot_stage[slot], old->protocol_data);
+    signal_db[slot].payload = slot_stage[slot];
+    dirty_slots |= 1u << slot;
+}
+
+/* Replays one sector's records into RAM; returns the address after the last good one */
+static uint32_t Replay(uint8_t sector) {
+    uint32_t addr = Sector_Base(sector) + HEADER_WORDS * 4;
+    uint32_t end = Sector_Base(sector) + STORAGE_SECTOR_SIZE;
+
+    while (addr + 12 <= end) {
+        const uint32_t *w = (const uint32_t *)addr;
+        if (w[0] == 0xFFFFFFFF) break; // Clean end of log
 
-    // 1. Erase the Sector
-    FLASH_EraseInitTypeDef EraseInitStruct;
-    uint32_t SectorError;
+        uint8_t type = w[0] & 0xFF;
+        uint8_t slot = (w[0] >> 8) & 0xFF;
+        uint16_t length = w[0] >> 16;
+        uint32_t words = 2 + (length + 3) / 4 + 1;
 
-    EraseInitStruct.TypeErase = FLASH_TYPEERASE_SECTORS;
-    EraseInitStruct.VoltageRange = FLASH_VOLTAGE_RANGE;
-    EraseInitStruct.Sector = FLASH_SECTOR_NUM;
-    EraseInitStruct.NbSectors = 1;
+        if (addr + words * 4 > end ||
+            w[words - 1] != LOG_COMMIT || w[1] != Record_Crc(w[0], &w[2], length)) {
+            log_broken = 1; // Torn write: everything after it is suspect
+            break;
+        }
+
+        if (type == REC_SIGNAL && slot < MAX_SLOTS && length >= NAME_BYTES) {
+            const uint8_t *blob = (const uint8_t *)&w[2] + NAME_BYTES;
+            uint16_t blob_len = length - NAME_BYTES;
+
+            Clear_Slot(slot);
+            memcpy(signal_db[slot].name, &w[2], NAME_LEN);
+            signal_db[slot].is_active = 1;
+            if (blob_len && Payload_IsValid(blob, blob_len)) {
+                signal_db[slot].payload = blob; // Zero-copy: read in place from flash
+                signal_db[slot].payload_len = Payload_Length(blob);
+            }
+        } else if (type == REC_SIGNAL_V1 && slot < MAX_SLOTS && length == sizeof(LegacySignal)) {
+            Migrate_Legacy(slot, (const LegacySignal *)&w[2]);
+        } else if (type == REC_DELETE && slot < MAX_SLOTS) {
+            Clear_Slot(slot);
+        } else if (type == REC_CALIB && length == sizeof(TouchCalib)) {
+            TouchCalib cal;
+            memcpy(&cal, &w[2], sizeof(cal));
+            Touch_SetCalibration(&cal);
+        } else if (type == REC_TUNE && length == sizeof(uint32_t)) {
+            if (RF_Frontend_SetCarrierArr((uint16_t)w[2])) tune_arr = (uint16_t)w[2];
+        }
+        addr += words * 4;
+    }
+    return addr;
+}
+
+/* One-time import of the pre-log layout (fixed array + calibration record) */
+static void Import_Legacy(void) {
+    typedef struct {
+        uint32_t magic;
+        TouchCalib cal;
+        uint32_t checksum;
+    } CalibRecord;
+
+    const LegacySignal *old = (const LegacySignal *)FLASH_STORAGE_ADDR;
+    if (*(const uint32_t *)FLASH_STORAGE_ADDR == LOG_SECTOR_MAGIC) return; // Aborted log, not legacy
+
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        if (old[i].is_active != 1) continue; // Erased flash reads 0xFF
+        Migrate_Legacy(i, &old[i]);
+    }
+
+    const CalibRecord *rec = (const CalibRecord *)FLASH_CALIB_ADDR;
+    const uint32_t *words = (const uint32_t *)&rec->cal;
+    uint32_t sum = CALIB_MAGIC;
+    for (uint32_t i = 0; i < sizeof(TouchCalib) / 4; i++) {
+        sum = (sum << 1 | sum >> 31) + words[i];
+    }
+    if (rec->magic == CALIB_MAGIC && rec->checksum == sum) {
+        Touch_SetCalibration(&rec->cal);
+        calib_dirty = 1;
+    }
+}
+
+/* Stages the record for a slot (or the calibration / tuning) at 'addr' */
+static void Stage_Record(uint8_t item, uint32_t addr) {
+    uint16_t fixed = 0; // Bytes snapshotted into 'stage' after head and CRC
+    uint8_t type;
+
+    memset(stage, 0, sizeof(stage));
+    stage_src = NULL;
+    stage_src_len = 0;
 
-    if (HAL_FLASHEx_Erase(&EraseInitStruct, &SectorError) != HAL_OK) {
+    if (item == ITEM_CALIB) {
+        type = REC_CALIB;
+        memcpy(&stage[2], Touch_GetCalibration(), sizeof(TouchCalib));
+        fixed = sizeof(TouchCalib);
+    } else if (item == ITEM_TUNE) {
+        type = REC_TUNE;
+        stage[2] = tune_arr;
+        fixed = sizeof(uint32_t);
+    } else if (signal_db[item].is_active) {
+        type = REC_SIGNAL;
+        strncpy((char *)&stage[2], signal_db[item].name, NAME_LEN);
+        fixed = NAME_BYTES;
+        stage_src = signal_db[item].payload;
+        stage_src_len = stage_src ? signal_db[item].payload_len : 0;
+    } else {
+        type = REC_DELETE;
+    }
+
+    uint32_t head = type | ((uint32_t)item << 8) | ((uint32_t)(fixed + stage_src_len) << 16);
+    uint32_t crc = Record_Crc(head, &stage[2], fixed);
+    stage[0] = head;
+    stage[1] = Crc32(crc, stage_src, stage_src_len);
+
+    stage_fixed = 2 + fixed / 4;
+    stage_len = stage_fixed + (stage_src_len + 3) / 4 + 1;
+    stage_pos = 0;
+    stage_addr = addr;
+    stage_item = item;
+}
+
+static void Stage_Header(uint32_t base, uint32_t gen) {
+    stage[0] = LOG_SECTOR_MAGIC;
+    stage[1] = gen;
+    stage[2] = LOG_COMMIT;
+    stage_fixed = HEADER_WORDS;
+    stage_src = NULL;
+    stage_src_len = 0;
+    stage_len = HEADER_WORDS;
+    stage_pos = 0;
+    stage_addr = base;
+}
+
+/* Word 'pos' of the staged image */
+static uint32_t Stage_Word(uint16_t pos) {
+    if (pos < stage_fixed) return stage[pos];
+
+    uint32_t ofs = (uint32_t)(pos - stage_fixed) * 4;
+    if (ofs >= stage_src_len) return LOG_COMMIT;
+
+    uint32_t w = 0xFFFFFFFF; // Tail padding stays erased
+    uint32_t n = stage_src_len - ofs;
+    memcpy(&w, stage_src + ofs, (n < 4) ? n : 4);
+    return w;
+}
+
+/* Starts programming the next staged word; completion arrives via the EOP interrupt */
+static void Program_Next(void) {
+    flash_busy = 1;
+    if (HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_WORD, stage_addr + stage_pos * 4u, Stage_Word(stage_pos)) != HAL_OK) {
+        flash_busy = 0;
+        flash_error = 1;
+        return;
+    }
+    stage_pos++;
+}
+
+/* Where the payload of the record just staged ends up in flash */
+static const uint8_t* Staged_Blob(void) {
+    return (const uint8_t *)(stage_addr + stage_fixed * 4u);
+}
+
+/* 1 while a blob in 'buf' is being streamed into flash */
+static uint8_t Streaming_From(const uint8_t *buf) {
+    return stage_src == buf && stage_pos < stage_len;
+}
+
+static void Mark_All_Dirty(void) {
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        if (signal_db[i].is_active) dirty_slots |= 1u << i;
+    }
+    if (Touch_IsCalibrated()) calib_dirty = 1;
+    if (tune_arr) tune_dirty = 1;
+}
+
+static void Start_Compaction(void) {
+    // Without a log, sector 6 goes first so the legacy data in 7 survives until the commit
+    spare = (active == 0) ? 1 : 0;
+    dirty_slots = 0; // Everything live is rewritten below
+    calib_dirty = 0;
+    tune_dirty = 0;
+    memset(moved_to, 0, sizeof(moved_to));
+    stage_len = stage_pos = 0;
+    state = ST_COMPACT_ERASE;
+
+    if (Sector_IsBlank(spare)) return; // Next slice moves straight on to copying
+
+    FLASH_EraseInitTypeDef erase;
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE;
+    erase.Sector = Sector_Number(spare);
+    erase.NbSectors = 1;
+
+    flash_busy = 1;
+    if (HAL_FLASHEx_Erase_IT(&erase) != HAL_OK) {
+        flash_busy = 0;
+        flash_error = 1;
+    }
+}
+
+/* Stages the next live item of a compaction, or the header once all are copied */
+static void Compact_Step(void) {
+    while (compact_cursor < MAX_SLOTS && !signal_db[compact_cursor].is_active) compact_cursor++;
+
+    if (compact_cursor < MAX_SLOTS) {
+        Stage_Record(compact_cursor, spare_tail);
+        moved_src[compact_cursor] = stage_src;
+        moved_to[compact_cursor] = stage_src ? (uint32_t)Staged_Blob() : 0;
+        compact_cursor++;
+    } else if (compact_cursor == ITEM_CALIB && Touch_IsCalibrated()) {
+        Stage_Record(compact_cursor++, spare_tail);
+    } else if (compact_cursor <= ITEM_TUNE && tune_arr) {
+        Stage_Record(ITEM_TUNE, spare_tail);
+        compact_cursor = ITEM_TUNE + 1;
+    } else {
+        Stage_Header(Sector_Base(spare), generation + 1);
+        state = ST_COMPACT_COMMIT;
+    }
+    Program_Next();
+}
+
+/* Picks the next dirty item and appends it, compacting first when needed */
+static void Start_Next(void) {
+    if (failures >= MAX_RETRIES) return; // Flash is failing: keep running from RAM
+
+    int item = -1;
+    if (dirty_slots) item = __builtin_ctz(dirty_slots);
+    else if (calib_dirty) item = ITEM_CALIB;
+    else if (tune_dirty) item = ITEM_TUNE;
+
+    if (item < 0) {
         HAL_FLASH_Lock();
-        return; // Failed to erase
+        return;
     }
 
-    // 2. Program Data (Byte by Byte)
-    uint8_t *data_ptr = (uint8_t *)signal_db;
-    uint32_t address = FLASH_STORAGE_ADDR;
+    HAL_FLASH_Unlock();
+    if (active == NO_SECTOR || log_broken) {
+        Start_Compaction();
+        return;
+    }
 
-    for (int i = 0; i < DB_SIZE; i++) {
-        HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, address + i, data_ptr[i]);
+    Stage_Record((uint8_t)item, log_tail);
+    if (log_tail + stage_len * 4u > Sector_Base(active) + STORAGE_SECTOR_SIZE) {
+        Start_Compaction(); // Log full
+        return;
     }
 
-    HAL_FLASH_Lock();
+    if (item == ITEM_CALIB) calib_dirty = 0;
+    else if (item == ITEM_TUNE) tune_dirty = 0;
+    else dirty_slots &= ~(1u << item);
+    state = ST_APPEND;
+    Program_Next();
 }
 
-void Storage_LoadSignals(void) {
-    // 1. Point to the Flash address
-    Signal *flash_data = (Signal *)FLASH_STORAGE_ADDR;
+/* A program or erase failed: drop the operation and retry from the RAM state */
+static void Abort_Operation(void) {
+    failures++;
+    if (state == ST_APPEND) log_broken = 1; // The tail may hold a partial record
+    Mark_All_Dirty();
+    stage_len = stage_pos = 0;
+    state = ST_IDLE;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Storage_Init(void) {
+    uint32_t gen_a = 0, gen_b = 0;
+    uint8_t valid_a = Header_Valid(0, &gen_a);
+    uint8_t valid_b = Header_Valid(1, &gen_b);
+
+    memset(signal_db, 0, sizeof(Signal) * MAX_SLOTS);
+    Touch_LoadDefaultCalibration();
+
+    if (valid_a && (!valid_b || gen_a > gen_b)) active = 0;
+    else if (valid_b) active = 1;
+
+    if (active != NO_SECTOR) {
+        generation = active ? gen_b : gen_a;
+        log_tail = Replay(active);
+    } else {
+        Import_Legacy(); // Dirty set makes the first commit a compaction into sector 6
+    }
+
+    HAL_NVIC_SetPriority(FLASH_IRQn, 0, 2);
+    HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+void Storage_UpdateSignal(int slot) {
+    if (slot < 0 || slot >= MAX_SLOTS) return;
+    dirty_slots |= 1u << slot;
+}
 
-    // 2. Copy data to RAM
-    memcpy(signal_db, flash_data, DB_SIZE);
+uint8_t Storage_SetPayload(int slot, const uint8_t *blob, uint16_t len) {
+    if (slot < 0 || slot >= MAX_SLOTS) return 0;
 
-    // 3. Sanity Check
-    // If flash was empty (0xFF), mark slots as inactive.
-    for (int i = 0; i < MAX_SLOTS; i++) {
-        if (signal_db[i].is_active == 0xFF) {
-            signal_db[i].is_active = 0;
-            memset(signal_db[i].name, 0, NAME_LEN);
+    uint8_t *dst = NULL;
+    if (blob && len) {
+        if (len <= SMALL_STAGE) {
+            dst = slot_stage[slot];
+        } else if (len <= RAW_STAGE) {
+            // One large uncommitted blob at a time: commit the previous owner first
+            for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+                if (i != slot && signal_db[i].payload == raw_stage) Storage_Flush();
+            }
+            dst = raw_stage;
+        } else {
+            return 0;
         }
+
+        // Never rewrite a buffer the committer is reading
+        while (Streaming_From(dst) && failures < MAX_RETRIES) Storage_Task();
+        memcpy(dst, blob, len);
+    }
+
+    signal_db[slot].payload = dst;
+    signal_db[slot].payload_len = dst ? len : 0;
+    dirty_slots |= 1u << slot;
+    return 1;
+}
+
+void Storage_SaveCalibration(void) {
+    calib_dirty = 1;
+}
+
+void Storage_SaveTuning(uint16_t arr) {
+    if (arr == tune_arr) return; // Unchanged: spare the flash
+    tune_arr = arr;
+    tune_dirty = 1;
+}
+
+void Storage_Task(void) {
+    if (flash_busy) return;
+
+    if (flash_error) {
+        flash_error = 0;
+        Abort_Operation();
+    }
+
+    // Keep feeding the current image, one word per slice
+    if (stage_pos < stage_len) {
+        Program_Next();
+        return;
+    }
+
+    // Current image (or erase) finished
+    switch (state) {
+        case ST_APPEND:
+            // Unchanged since staging: read the committed copy from now on
+            if (stage_src && stage_item < MAX_SLOTS && signal_db[stage_item].payload == stage_src) {
+                signal_db[stage_item].payload = Staged_Blob();
+            }
+            log_tail = stage_addr + stage_len * 4u;
+            failures = 0;
+            state = ST_IDLE;
+            break;
+
+        case ST_COMPACT_ERASE:
+            spare_tail = Sector_Base(spare) + HEADER_WORDS * 4;
+            compact_cursor = 0;
+            state = ST_COMPACT_COPY;
+            Compact_Step();
+            return;
+
+        case ST_COMPACT_COPY:
+            spare_tail = stage_addr + stage_len * 4u;
+            Compact_Step();
+            return;
+
+        case ST_COMPACT_COMMIT:
+            for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+                if (moved_to[i] && signal_db[i].payload == moved_src[i]) {
+                    signal_db[i].payload = (const uint8_t *)moved_to[i];
+                }
+            }
+            active = spare;
+            generation++;
+            log_tail = spare_tail;
+            log_broken = 0;
+            failures = 0;
+            state = ST_IDLE;
+            break;
+
+        case ST_IDLE:
+            break;
+    }
+
+    stage_len = stage_pos = 0;
+    Start_Next();
+}
+
+void Storage_Flush(void) {
+    while (Storage_IsBusy() && failures < MAX_RETRIES) {
+        Storage_Task();
     }
-}
\ No newline at end of file
+}
+
+uint8_t Storage_IsBusy(void) {
+    return state != ST_IDLE || flash_busy || dirty_slots != 0 || calib_dirty || tune_dirty;
+}
+
+// --- HAL CALLBACKS (flash interrupt context) ---
+
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue) {
+    flash_busy = 0;
+    Events_Post(EVT_FLASH_DONE, 0);
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue) {
+    flash_error = 1;
+    flash_busy = 0;
+    Events_Post(EVT_FLASH_ERROR, 0);
+}
@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file    t5577.c
+  * @brief   T5577 block images, downlink commands and gap timelines.
+  ******************************************************************************
+  */
+
+#include "t5577.h"
+#include <stddef.h>
+
+// --- BLOCK 0 FIELDS ---
+#define CFG_RATE_POS      18   // Data bit rate code (RF/8 .. RF/128)
+#define CFG_MOD_POS       12   // Modulation
+#define CFG_PSKCF_POS     10   // PSK subcarrier (RF/2, RF/4, RF/8)
+#define CFG_MAXBLOCK_POS  5
+
+#define MOD_PSK1          0x01
+#define MOD_FSK2A         0x07 // fc/8 = 0, fc/10 = 1
+#define MOD_MANCHESTER    0x08
+
+static const uint16_t rate_codes[] = { 8, 16, 32, 40, 50, 64, 100, 128 }; // Index = code
+
+static uint8_t Put_Word(uint8_t *bits, uint32_t v, uint8_t width) {
+    for (uint8_t i = 0; i < width; i++) bits[i] = (v >> (width - 1 - i)) & 1u;
+    return width;
+}
+
+/* Opcode '1' + page 0, then the password if one is set */
+static uint8_t Put_Header(uint8_t *bits, const uint32_t *password) {
+    uint8_t n = 0;
+    bits[n++] = 1;
+    bits[n++] = 0;
+    if (password) n += Put_Word(&bits[n], *password, 32);
+    return n;
+}
+
+uint32_t T5577_Config(const LfProtocol *p, uint8_t data_blocks) {
+    uint32_t rate = 0xFF;
+    for (uint8_t i = 0; i < sizeof(rate_codes) / sizeof(rate_codes[0]); i++) {
+        if (rate_codes[i] == p->bit_cycles) rate = i;
+    }
+    if (rate == 0xFF || data_blocks == 0 || data_blocks >= T5577_MAX_BLOCKS) return 0;
+
+    uint32_t cfg = (rate << CFG_RATE_POS) | ((uint32_t)data_blocks << CFG_MAXBLOCK_POS);
+    switch (p->modulation) {
+        case LF_MOD_ASK_MANCHESTER:
+            return cfg | (MOD_MANCHESTER << CFG_MOD_POS);
+        case LF_MOD_FSK:
+            if (p->sub_a != 8 || p->sub_b != 10) return 0;
+            return cfg | (MOD_FSK2A << CFG_MOD_POS);
+        case LF_MOD_PSK1:
+            if (p->sub_a != 2 && p->sub_a != 4 && p->sub_a != 8) return 0;
+            return cfg | (MOD_PSK1 << CFG_MOD_POS) | ((uint32_t)(p->sub_a / 4) << CFG_PSKCF_POS);
+    }
+    return 0;
+}
+
+uint8_t T5577_Blocks(const LfProtocol *p, const LfFrame *id, uint32_t *blocks) {
+    uint8_t bits[LF_MAX_FRAME_BITS];
+    if (p->encode == NULL) return 0;
+
+    uint8_t len = p->encode(id, bits);
+    if (len == 0 || len % 32) return 0; // The tag loops whole blocks
+
+    uint8_t data_blocks = len / 32;
+    blocks[0] = T5577_Config(p, data_blocks);
+    if (blocks[0] == 0) return 0;
+
+    for (uint8_t b = 0; b < data_blocks; b++) {
+        uint32_t v = 0;
+        for (uint8_t i = 0; i < 32; i++) v = (v << 1) | bits[b * 32 + i];
+        blocks[1 + b] = v;
+    }
+    return 1 + data_blocks;
+}
+
+uint8_t T5577_WriteCmd(uint8_t *bits, uint8_t block, uint32_t data, const uint32_t *password) {
+    uint8_t n = Put_Header(bits, password);
+    bits[n++] = 0; // Lock bit: never lock a clone
+    n += Put_Word(&bits[n], data, 32);
+    n += Put_Word(&bits[n], block, 3);
+    return n;
+}
+
+uint8_t T5577_ReadCmd(uint8_t *bits, uint8_t block, const uint32_t *password) {
+    uint8_t n = Put_Header(bits, password);
+    bits[n++] = 0;
+    n += Put_Word(&bits[n], block, 3);
+    return n;
+}
+
+uint16_t T5577_Timeline(const uint8_t *bits, uint8_t nbits, uint16_t *cycles, uint16_t cap) {
+    uint16_t n = 0;
+    if (cap < 2u + 2u * nbits) return 0;
+
+    cycles[n++] = T5577_START_GAP;
+    for (uint8_t i = 0; i < nbits; i++) {
+        cycles[n++] = bits[i] ? T5577_DATA_1 : T5577_DATA_0;
+        cycles[n++] = T5577_WRITE_GAP;
+    }
+    cycles[n++] = T5577_TAIL;
+    return n;
+}
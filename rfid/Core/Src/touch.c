@@ -20,6 +20,18 @@
 #define TOUCH_WIDTH  240
 #define TOUCH_HEIGHT 320
 
+// --- CALIBRATION STATE ---
+static TouchCalib touch_calib;
+static uint8_t touch_calibrated = 0;
+
+// Coefficients pre-packed as {lo, hi} halfword pairs for the dual multiply-add
+static uint32_t calib_packed_x;  // {a, b}
+static uint32_t calib_packed_y;  // {d, e}
+
+// Raw readings behind the last valid touch (used by the calibration page)
+static uint16_t last_raw_x = 0;
+static uint16_t last_raw_y = 0;
+
 /* Simple bubble sort for the median filter */
 static void Sort_Array(uint16_t *arr, uint8_t n) {
     for (uint8_t i = 1; i < n; i++) {
@@ -64,15 +76,41 @@ static uint16_t TP_ReadAxis(uint8_t cmd) {
     return total / 8;
 }
 
+/* Computes k0 * raw_lo + k1 * raw_hi + k2 in one instruction where the DSP extension exists */
+static inline int32_t Calib_Axis(uint32_t packed_k, int32_t k2, uint32_t packed_raw) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return (int32_t)__SMLAD(packed_raw, packed_k, (uint32_t)k2);
+#else
+    return (int16_t)(packed_k & 0xFFFF) * (int32_t)(packed_raw & 0xFFFF) +
+           (int16_t)(packed_k >> 16)    * (int32_t)(packed_raw >> 16) + k2;
+#endif
+}
+
+/* Converts a fixed-point result to a pixel, clamped to the panel */
+static uint16_t Calib_ToPixel(int32_t value, uint16_t limit) {
+    value = (value + (1 << (TOUCH_CALIB_SHIFT - 1))) >> TOUCH_CALIB_SHIFT;
+    if (value < 0) return 0;
+    if (value >= limit) return limit - 1;
+    return (uint16_t)value;
+}
+
+/* Signed 64-bit division rounded to nearest */
+static int64_t Div_Round(int64_t num, int64_t den) {
+    if (den < 0) { num = -num; den = -den; }
+    if (num >= 0) return (num + den / 2) / den;
+    return -((-num + den / 2) / den);
+}
+
+static uint8_t Fits_Int16(int64_t v) {
+    return (v >= INT16_MIN && v <= INT16_MAX);
+}
+
 uint8_t Touch_IsPressed(void) {
     return (HAL_GPIO_ReadPin(TOUCH_IRQ_GPIO_Port, TOUCH_IRQ_Pin) == GPIO_PIN_RESET);
 }
 
 uint8_t Touch_GetPixels(uint16_t *x, uint16_t *y) {
-    if (!Touch_IsPressed()) return 0;
-
-    HAL_Delay(20); // Debounce
-
+    // No blocking debounce here: the gesture recognizer debounces on timestamps
     if (!Touch_IsPressed()) return 0;
 
     uint16_t raw_x = TP_ReadAxis(CMD_X_READ);
@@ -82,21 +120,88 @@ uint8_t Touch_GetPixels(uint16_t *x, uint16_t *y) {
     if (raw_x < 50 || raw_x > 4050) return 0;
     if (raw_y < 50 || raw_y > 4050) return 0;
 
-    // Clamp to calibration limits
-    if (raw_x < RAW_X_MIN) raw_x = RAW_X_MIN;
-    if (raw_x > RAW_X_MAX) raw_x = RAW_X_MAX;
-    
-    // Map raw values to screen pixels (Rotation logic included)
-    *y = (uint32_t)(raw_x - RAW_X_MIN) * TOUCH_HEIGHT / (RAW_X_MAX - RAW_X_MIN);
+    last_raw_x = raw_x;
+    last_raw_y = raw_y;
+
+    // Map raw values to screen pixels (rotation/skew are part of the matrix)
+    uint32_t packed_raw = ((uint32_t)raw_y << 16) | raw_x;
+    *x = Calib_ToPixel(Calib_Axis(calib_packed_x, touch_calib.c, packed_raw), TOUCH_WIDTH);
+    *y = Calib_ToPixel(Calib_Axis(calib_packed_y, touch_calib.f, packed_raw), TOUCH_HEIGHT);
+
+    return 1;
+}
 
-    if (raw_y < RAW_Y_MIN) raw_y = RAW_Y_MIN;
-    if (raw_y > RAW_Y_MAX) raw_y = RAW_Y_MAX;
+void Touch_GetLastRaw(uint16_t *raw_x, uint16_t *raw_y) {
+    *raw_x = last_raw_x;
+    *raw_y = last_raw_y;
+}
+
+// --- CALIBRATION ---
+
+uint8_t Touch_SolveCalibration(const uint16_t screen[TOUCH_CALIB_POINTS][2],
+                               const uint16_t raw[TOUCH_CALIB_POINTS][2],
+                               TouchCalib *out) {
+    // Cramer's rule relative to point 2 (keeps the products small)
+    int64_t x0 = (int64_t)raw[0][0] - raw[2][0];
+    int64_t x1 = (int64_t)raw[1][0] - raw[2][0];
+    int64_t y0 = (int64_t)raw[0][1] - raw[2][1];
+    int64_t y1 = (int64_t)raw[1][1] - raw[2][1];
+
+    int64_t div = x0 * y1 - x1 * y0;
+    if (div == 0) return 0; // Points are collinear
+
+    int64_t k[2][3];
+    for (int axis = 0; axis < 2; axis++) {
+        int64_t t0 = (int64_t)screen[0][axis] - screen[2][axis];
+        int64_t t1 = (int64_t)screen[1][axis] - screen[2][axis];
 
-    *x = TOUCH_WIDTH - ((uint32_t)(raw_y - RAW_Y_MIN) * TOUCH_WIDTH / (RAW_Y_MAX - RAW_Y_MIN));
+        int64_t ka = Div_Round((t0 * y1 - t1 * y0) << TOUCH_CALIB_SHIFT, div);
+        int64_t kb = Div_Round((x0 * t1 - x1 * t0) << TOUCH_CALIB_SHIFT, div);
+        if (!Fits_Int16(ka) || !Fits_Int16(kb)) return 0;
 
+        // Offset is derived from the rounded gains so point 2 maps exactly
+        int64_t kc = ((int64_t)screen[2][axis] << TOUCH_CALIB_SHIFT) - ka * raw[2][0] - kb * raw[2][1];
+        if (kc < INT32_MIN || kc > INT32_MAX) return 0;
+
+        k[axis][0] = ka; k[axis][1] = kb; k[axis][2] = kc;
+    }
+
+    out->a = (int32_t)k[0][0]; out->b = (int32_t)k[0][1]; out->c = (int32_t)k[0][2];
+    out->d = (int32_t)k[1][0]; out->e = (int32_t)k[1][1]; out->f = (int32_t)k[1][2];
     return 1;
 }
 
+void Touch_SetCalibration(const TouchCalib *cal) {
+    touch_calib = *cal;
+    calib_packed_x = ((uint32_t)(uint16_t)cal->b << 16) | (uint16_t)cal->a;
+    calib_packed_y = ((uint32_t)(uint16_t)cal->e << 16) | (uint16_t)cal->d;
+    touch_calibrated = 1;
+}
+
+const TouchCalib* Touch_GetCalibration(void) {
+    return &touch_calib;
+}
+
+void Touch_LoadDefaultCalibration(void) {
+    TouchCalib cal;
+
+    // Raw X runs along the screen Y axis, raw Y runs (inverted) along screen X
+    cal.a = 0;
+    cal.b = -(int32_t)(((uint32_t)TOUCH_WIDTH << TOUCH_CALIB_SHIFT) / (RAW_Y_MAX - RAW_Y_MIN));
+    cal.c = ((int32_t)TOUCH_WIDTH << TOUCH_CALIB_SHIFT) - RAW_Y_MIN * cal.b;
+
+    cal.d = (int32_t)(((uint32_t)TOUCH_HEIGHT << TOUCH_CALIB_SHIFT) / (RAW_X_MAX - RAW_X_MIN));
+    cal.e = 0;
+    cal.f = -RAW_X_MIN * cal.d;
+
+    Touch_SetCalibration(&cal);
+    touch_calibrated = 0;
+}
+
+uint8_t Touch_IsCalibrated(void) {
+    return touch_calibrated;
+}
+
 uint8_t Button_IsPressed(ButtonDef button, uint16_t touch_x, uint16_t touch_y) {
     if (touch_x >= button.x && touch_x <= (button.x + button.width) &&
         touch_y >= button.y && touch_y <= (button.y + button.height)) {
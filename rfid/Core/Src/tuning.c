@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    tuning.c
+  * @brief   Antenna resonance sweep and peak fit.
+  ******************************************************************************
+  */
+
+#include "tuning.h"
+
+enum {
+    STAGE_START,      // Nothing applied yet
+    STAGE_SETTLING,   // Setting applied, coil and ADC block settling
+    STAGE_MEASURING,  // Level average restarted, collecting
+    STAGE_DONE
+};
+
+/* Parabola vertex through (-1, ym), (0, y0), (1, yp), in 1/256 steps */
+static int32_t Vertex_Q8(uint32_t ym, uint32_t y0, uint32_t yp) {
+    int64_t den = (int64_t)ym - 2 * (int64_t)y0 + (int64_t)yp;
+    if (den >= 0) return 0; // Not a maximum (flat top)
+    return (int32_t)(((int64_t)ym - (int64_t)yp) * 128 / den);
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+void Tune_Begin(TuneSweep *s, uint16_t center_arr, uint32_t now_ms) {
+    s->center = center_arr;
+    s->point = 0;
+    s->phase = 0;
+    s->stage = STAGE_START;
+    s->since_ms = now_ms;
+    s->result = 0;
+}
+
+TuneAction Tune_Feed(TuneSweep *s, uint32_t now_ms, int16_t level) {
+    switch (s->stage) {
+        case STAGE_START:
+            s->stage = STAGE_SETTLING;
+            s->since_ms = now_ms;
+            return TUNE_ACT_APPLY;
+
+        case STAGE_SETTLING:
+            if (now_ms - s->since_ms < TUNE_SETTLE_MS) return TUNE_ACT_NONE;
+            s->stage = STAGE_MEASURING;
+            s->since_ms = now_ms;
+            return TUNE_ACT_RESTART;
+
+        case STAGE_MEASURING:
+            if (now_ms - s->since_ms < TUNE_MEASURE_MS) return TUNE_ACT_NONE;
+            s->level[s->phase++] = level;
+            if (s->phase == 4) {
+                s->power[s->point++] = Tune_Power(s->level);
+                s->phase = 0;
+            }
+            if (s->point == TUNE_POINTS) {
+                s->result = Tune_FitPeak(s->power, TUNE_POINTS, s->center - TUNE_ARR_SPAN, TUNE_ARR_STEP);
+                s->stage = STAGE_DONE;
+                return TUNE_ACT_DONE;
+            }
+            s->stage = STAGE_SETTLING;
+            s->since_ms = now_ms;
+            return TUNE_ACT_APPLY;
+    }
+    return TUNE_ACT_NONE;
+}
+
+uint8_t Tune_IsDone(const TuneSweep *s) {
+    return s->stage == STAGE_DONE;
+}
+
+uint16_t Tune_Result(const TuneSweep *s) {
+    return s->result;
+}
+
+uint16_t Tune_Arr(const TuneSweep *s) {
+    return s->center - TUNE_ARR_SPAN + s->point * TUNE_ARR_STEP;
+}
+
+uint16_t Tune_Phase(const TuneSweep *s) {
+    uint16_t period = Tune_Arr(s) + 1;
+    // Eighth-period offset: a compare value of 0 would never trigger the ADC
+    return period / 8 + s->phase * period / 4;
+}
+
+uint32_t Tune_Power(const int16_t *level) {
+    int32_t i = (int32_t)level[0] - level[2];
+    int32_t q = (int32_t)level[1] - level[3];
+    return (uint32_t)(i * i) + (uint32_t)(q * q);
+}
+
+uint16_t Tune_FitPeak(const uint32_t *power, uint8_t n, uint16_t first_arr, uint8_t step) {
+    uint8_t best = 0;
+    uint32_t lowest = power[0];
+
+    for (uint8_t i = 1; i < n; i++) {
+        if (power[i] > power[best]) best = i;
+        if (power[i] < lowest) lowest = power[i];
+    }
+
+    // I and Q are differences of two levels: amplitude x2
+    if (power[best] < 4u * TUNE_MIN_AMPL * TUNE_MIN_AMPL) return 0;
+    if (power[best] - lowest < lowest / 4) return 0; // No peak inside the sweep
+
+    int32_t pos = (int32_t)(first_arr + best * step) << 8;
+    if (best > 0 && best < n - 1) {
+        pos += Vertex_Q8(power[best - 1], power[best], power[best + 1]) * step;
+    }
+    return (uint16_t)((pos + 128) >> 8);
+}
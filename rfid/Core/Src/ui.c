@@ -7,101 +7,145 @@
   */
 
 #include "ui.h"
+#include "arena.h"
 #include "storage.h"
-#include <stdio.h>
+#include "listview.h"
+#include "search.h"
+#include "payload.h"
+#include "lf_protocols.h"
+#include "rawcap.h"
+#include "lf_vote.h"
+#include "rf_writer.h"
+#include "wavecache.h"
+#include "profiler.h"
+#include "power.h"
+#include "events.h"
+#include "gfx.h"
+#include "layout.h"
+#include "page_layouts.h"
+#include "fmt.h"
+#include "stack.h"
 #include <string.h>
-#include <stdlib.h> 
+#include <ctype.h>
 
 // --- STATE MANAGEMENT ---
 AppState currentState = PAGE_BOOT;
 uint8_t ui_needs_update = 1;
 
-// --- PAGINATION ---
-int8_t list_page = 0; 
-#define SLOTS_PER_PAGE 3
+// --- SIGNAL LIST ---
+// Virtualized view over a name-sorted index (rebuilt on page entry, not on scroll)
+#define LIST_TOP   30   // Title area above the scrolling rows
+#define LIST_ROWS  5    // Visible rows: 5 * LIST_ROW_H = 220 lines
+static ListView signal_list;
+static uint8_t list_order[MAX_SLOTS];
+static uint16_t list_count = 0;
+static uint8_t list_filtered = 0;  // 1 = List shows search results only
+
+#if SEARCH_MAX_ENTRIES < MAX_SLOTS
+#error "SEARCH_MAX_ENTRIES must cover MAX_SLOTS"
+#endif
 
 // --- DATABASE ---
-Signal signal_db[MAX_SLOTS];
+Signal signal_db[MAX_SLOTS] ARENA_UI;
 int8_t selected_slot_idx = -1; 
 
+// --- PLAYLIST ---
+static const uint16_t repeat_steps[] = { 3, 5, 8, 2 };  // Readers want 2+ frames to lock
+static const uint16_t gap_steps[] = { 50, 100, 250, 0 };
+TxPlaylist tx_playlist = { {0}, 0, 3, 50, 0 };
+static uint32_t tx_queue;  // Bit per slot marked with QUEUE on its options page
+
 // --- KEYBOARD BUFFER ---
 char input_buffer[NAME_LEN + 1];
 uint8_t kb_mode = 0;  // 0 = Letters, 1 = Numbers/Symbols
 uint8_t kb_shift = 0; // 0 = Lowercase, 1 = Uppercase
 
+// What the keyboard is editing
+typedef enum {
+    KB_RENAME,  // Signal name (OK saves to flash)
+    KB_JUMP,    // First key press jumps the list to that letter
+    KB_SEARCH   // Each key press narrows the search results
+} KbTarget;
+static KbTarget kb_target = KB_RENAME;
+
+// --- TOUCH CALIBRATION ---
+// Targets spread across the panel so the solve is well conditioned
+static const uint16_t calib_targets[TOUCH_CALIB_POINTS][2] = {
+    {24, 48}, {216, 160}, {120, 296}
+};
+static uint16_t calib_raw[TOUCH_CALIB_POINTS][2];
+static uint8_t calib_step = 0;
+static uint8_t calib_failed = 0;
+static uint8_t calib_held = 0;   // Point recorded, waiting for that press to end
+
 // --- BUTTON DEFINITIONS ---
+// Geometry comes from the BTN_* macros of page_layouts.h, shared with the layouts
 // Main Menu
-ButtonDef btn_Tx     = {10, 80,  220, 50}; 
-ButtonDef btn_Rx     = {10, 150, 220, 50};
+ButtonDef btn_Tx     = {BTN_TX}; 
+ButtonDef btn_Rx     = {BTN_RX};
+ButtonDef btn_Cal    = {BTN_CAL};
+ButtonDef btn_Diag   = {BTN_DIAG};
 
-// List Slots
-ButtonDef btn_Slot1  = {5, 40,  230, 40};
-ButtonDef btn_Slot2  = {5, 90,  230, 40};
-ButtonDef btn_Slot3  = {5, 140, 230, 40};
+// List Page (bottom fixed area, below the scrolling rows)
+ButtonDef btn_List_Home = {BTN_LIST_HOME};
+ButtonDef btn_List_Jump = {BTN_LIST_JUMP};
+ButtonDef btn_List_Find = {BTN_LIST_FIND};
+ButtonDef btn_List_Play = {BTN_LIST_PLAY};
 
 // Navigation
-ButtonDef btn_Prev   = {5,   200, 60, 40}; 
-ButtonDef btn_Next   = {175, 200, 60, 40}; 
-ButtonDef btn_Back   = {60,  260, 120, 40};
+ButtonDef btn_Back   = {BTN_BACK};
 
 // Options Page
-ButtonDef btn_Opt_Tx     = {20, 75,  200, 50};
-ButtonDef btn_Opt_Rename = {20, 145, 90,  40};
-ButtonDef btn_Opt_Del    = {130, 145, 90, 40};
-ButtonDef btn_Opt_Back   = {60,  215, 120, 40};
+ButtonDef btn_Opt_Tx     = {BTN_OPT_TX};
+ButtonDef btn_Opt_Clone  = {BTN_OPT_CLONE};
+ButtonDef btn_Opt_Rename = {BTN_OPT_RENAME};
+ButtonDef btn_Opt_Del    = {BTN_OPT_DEL};
+ButtonDef btn_Opt_Queue  = {BTN_OPT_QUEUE};
+ButtonDef btn_Opt_Back   = {BTN_OPT_BACK};
 
 // Active Page Controls
-ButtonDef btn_Stop       = {20, 200, 200, 60}; 
+ButtonDef btn_Stop       = {BTN_STOP}; 
+ButtonDef btn_Pl_Repeat  = {BTN_PL_REPEAT};
+ButtonDef btn_Pl_Gap     = {BTN_PL_GAP};
 
 // Confirmation Page
-ButtonDef btn_Conf_No    = {20, 130, 90, 60};  // Red (Left)
-ButtonDef btn_Conf_Yes   = {130, 130, 90, 60}; // Green (Right)
+ButtonDef btn_Conf_No    = {BTN_CONF_NO};  // Red (Left)
+ButtonDef btn_Conf_Yes   = {BTN_CONF_YES}; // Green (Right)
 
 // Keyboard Buttons (5-Key Bottom Row)
-ButtonDef btn_Kb_Mode  = {2,   275, 45, 40}; // [123]
-ButtonDef btn_Kb_Shift = {50,  275, 45, 40}; // [SHF]
-ButtonDef btn_Kb_Space = {98,  275, 45, 40}; // [_]
-ButtonDef btn_Kb_Del   = {146, 275, 45, 40}; // [DEL]
-ButtonDef btn_Kb_Done  = {194, 275, 44, 40}; // [OK]
+ButtonDef btn_Kb_Mode  = {BTN_KB_MODE};  // [123]
+ButtonDef btn_Kb_Shift = {BTN_KB_SHIFT}; // [SHF]
+ButtonDef btn_Kb_Space = {BTN_KB_SPACE}; // [_]
+ButtonDef btn_Kb_Del   = {BTN_KB_DEL};   // [DEL]
+ButtonDef btn_Kb_Done  = {BTN_KB_DONE};  // [OK]
 
 // --- PRIVATE HELPERS ---
 
-/* Draw a hollow rectangle (Wireframe look) */
-static void UI_DrawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    LCD_FillRect(x, y, w, 1, color);       // Top
-    LCD_FillRect(x, y + h - 1, w, 1, color); // Bottom
-    LCD_FillRect(x, y, 1, h, color);       // Left
-    LCD_FillRect(x + w - 1, y, 1, h, color); // Right
-}
-
 /* Draws a styled "Hacker Terminal" button */
 static void Draw_Terminal_Button_State(ButtonDef *btn, const char* text, uint8_t is_alert, uint8_t is_active) {
     uint16_t color = is_alert ? COLOR_ALERT : COLOR_TERM_DIM; 
     uint16_t text_color = is_alert ? COLOR_ALERT : COLOR_TERM_TEXT; 
     uint16_t bg_color = COLOR_TERM_BG;
 
+    Gfx_Begin(); // Frame and label in one transaction
     if (is_active) {
         // Active/Toggled State
         LCD_FillRect(btn->x, btn->y, btn->width, btn->height, color);
         text_color = BLACK;
         bg_color = color;
     } else {
-        // Normal State
-        UI_DrawRect(btn->x, btn->y, btn->width, btn->height, color);
-        // Corner Glitch Accents
-        LCD_FillRect(btn->x, btn->y, 5, 5, color);
-        LCD_FillRect(btn->x + btn->width - 5, btn->y + btn->height - 5, 5, 5, color);
+        // Normal State (same look as LAYOUT_BUTTON)
+        Layout_ButtonFrame(btn->x, btn->y, btn->width, btn->height, color);
     }
 
-    char buf[30];
-    if (strlen(text) > 0) sprintf(buf, "%s", text);
-    else sprintf(buf, "---"); 
+    if (text[0] == '\0') text = "---";
 
     // Center Text
-    uint16_t text_len = strlen(buf) * 7;
+    uint16_t text_len = strlen(text) * 7;
     uint16_t x_pos = btn->x + (btn->width - text_len) / 2;
     uint16_t y_pos = btn->y + (btn->height - 10) / 2;
-    LCD_WriteString(buf, x_pos, y_pos, Font_7x10, text_color, bg_color);
+    LCD_WriteString(text, x_pos, y_pos, Font_7x10, text_color, bg_color);
+    Gfx_End();
 }
 
 // Wrapper for standard buttons
@@ -129,6 +173,332 @@ static void Flash_Button(ButtonDef *btn, const char* restore_text, uint8_t is_al
     }
 }
 
+// --- SNIFFER STATUS ---
+
+static SnifferStatus sniffer_status = { "LISTENING", 0, 0, 0 };
+
+/* Fixed-width lines, so a redraw overwrites the previous text in place */
+static void Draw_Sniffer_Status(void) {
+    char line[30];
+    Fmt f;
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "MODE : ");
+    Fmt_StrW(&f, sniffer_status.mode, -14);
+    LCD_WriteString(line, 20, 200, Font_7x10, COLOR_TERM_DIM, BLACK);
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "READS: ");
+    if (sniffer_status.reads) {
+        Fmt_UintW(&f, sniffer_status.reads, -2);
+        Fmt_Char(&f, ' ');
+        Fmt_StrW(&f, LF_Protocol_Name(sniffer_status.protocol), -11);
+    } else {
+        Fmt_StrW(&f, "-", -14);
+    }
+    LCD_WriteString(line, 20, 215, Font_7x10, COLOR_TERM_DIM, BLACK);
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "CONF : ");
+    Fmt_UintW(&f, sniffer_status.confidence, 3);
+    Fmt_Char(&f, '%');
+    LCD_WriteString(line, 20, 230, Font_7x10, COLOR_TERM_DIM, BLACK);
+
+    // Confidence bar, turns white once the capture is good enough to keep
+    uint16_t fill = sniffer_status.confidence * 120u / 100u;
+    uint16_t color = (sniffer_status.confidence >= LF_VOTE_COMMIT) ? COLOR_TERM_TEXT : COLOR_TERM_DIM;
+    LCD_FillRect(100, 231, fill, 8, color);
+    LCD_FillRect(100 + fill, 231, 120 - fill, 8, BLACK);
+}
+
+// --- CLONE STATUS ---
+
+static RfWriterStatus writer_shown;
+
+/* 1 if the slot holds an ID the writer can turn into a T5577 image */
+static uint8_t Can_Clone(int idx) {
+    const uint8_t *payload = signal_db[idx].payload;
+    if (payload == NULL || Payload_BitLen(payload) == 0) return 0;
+
+    const LfProtocol *p = LF_Protocol_Find(Payload_Protocol(payload));
+    return p && p->encode;
+}
+
+static void Draw_Writer_Status(void) {
+    static const char *states[] = { "STARTING", "WRITING", "VERIFYING", "DONE", "FAILED" };
+    const RfWriterStatus *st = &writer_shown;
+    char line[30];
+    Fmt f;
+    uint8_t ok = 0;
+
+    for (uint8_t b = 0; b < st->blocks; b++) ok += (st->verified >> b) & 1u;
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "STATE: ");
+    if (st->state == RF_WRITER_WRITING || st->state == RF_WRITER_VERIFYING) {
+        Fmt_StrW(&f, states[st->state], -9);
+        Fmt_Str(&f, " BLK ");
+        Fmt_Uint(&f, st->block);
+    } else {
+        Fmt_StrW(&f, states[st->state], -15);
+    }
+    LCD_WriteString(line, 20, 120, Font_7x10,
+                    (st->state == RF_WRITER_FAILED) ? COLOR_ALERT : COLOR_TERM_DIM, BLACK);
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "OK   : ");
+    Fmt_Uint(&f, ok);
+    Fmt_Char(&f, '/');
+    Fmt_Uint(&f, st->blocks);
+    Fmt_Str(&f, "  RETRY ");
+    Fmt_UintW(&f, st->retries, -4);
+    LCD_WriteString(line, 20, 135, Font_7x10, COLOR_TERM_DIM, BLACK);
+
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "TIME : ");
+    if (st->state == RF_WRITER_DONE || st->state == RF_WRITER_FAILED) {
+        Fmt_UintW(&f, st->elapsed_ms, -6);
+        Fmt_Str(&f, " MS");
+    } else {
+        Fmt_StrW(&f, "-", -9);
+    }
+    LCD_WriteString(line, 20, 150, Font_7x10, COLOR_TERM_DIM, BLACK);
+}
+
+// --- PLAYLIST ---
+
+static PlaylistProgress playlist_shown;
+
+/* Queued slots (slot order), or else every row of the list as shown (a FIND
+   narrows it to one site's fobs) */
+static void Playlist_From_List(void) {
+    tx_playlist.count = 0;
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        if (((tx_queue >> i) & 1u) && signal_db[i].is_active) tx_playlist.slots[tx_playlist.count++] = i;
+    }
+    if (tx_playlist.count == 0) {
+        memcpy(tx_playlist.slots, list_order, list_count);
+        tx_playlist.count = list_count;
+    }
+    tx_playlist.version++;
+}
+
+#define PLAYLIST_LABEL_LEN 12
+
+static void Playlist_Labels(char *repeat, char *gap) {
+    Fmt f;
+
+    Fmt_Init(&f, repeat, PLAYLIST_LABEL_LEN);
+    Fmt_Str(&f, "RPT x");
+    Fmt_Uint(&f, tx_playlist.repeats);
+
+    Fmt_Init(&f, gap, PLAYLIST_LABEL_LEN);
+    Fmt_Str(&f, "GAP ");
+    Fmt_Uint(&f, tx_playlist.gap_ms);
+    Fmt_Str(&f, "MS");
+}
+
+/* Next value of a setting, wrapping around its steps */
+static uint16_t Next_Step(const uint16_t *steps, uint8_t n, uint16_t current) {
+    for (uint8_t i = 0; i < n; i++) {
+        if (steps[i] == current) return steps[(i + 1) % n];
+    }
+    return steps[0];
+}
+
+static void Draw_Playlist_Progress(void) {
+    const PlaylistProgress *pr = &playlist_shown;
+    char line[30];
+    Fmt f;
+
+    LCD_FillRect(0, 100, 240, 10, BLACK);
+    Fmt_Init(&f, line, sizeof(line));
+    if (pr->count) {
+        const char *name = signal_db[pr->slot].name;
+        LCD_WriteString(name, (240 - strlen(name) * 7) / 2, 100, Font_7x10, COLOR_TERM_TEXT, BLACK);
+        Fmt_UintW(&f, pr->item + 1, 2);
+        Fmt_Char(&f, '/');
+        Fmt_UintW(&f, pr->count, -2);
+        Fmt_Str(&f, " PASS ");
+        Fmt_Uint(&f, pr->pass + 1);
+        Fmt_Char(&f, '/');
+        Fmt_Uint(&f, tx_playlist.repeats);
+        Fmt_Str(&f, " LOOP ");
+        Fmt_UintW(&f, pr->loops, -5);
+    } else {
+        Fmt_StrW(&f, "NOTHING TO EMULATE", -28);
+    }
+    LCD_WriteString(line, 15, 125, Font_7x10, pr->count ? COLOR_TERM_DIM : COLOR_ALERT, BLACK);
+}
+
+// --- DIAGNOSTICS ---
+
+#define DIAG_REFRESH_MS 1000
+
+static uint32_t diag_drawn_at;
+
+extern uint8_t _sramfunc[], _eramfunc[]; // Linker script
+
+/* Fixed-width lines, redrawn in place once a second */
+static void Draw_Diag(void) {
+    char line[34];
+    Fmt f;
+    WaveStats ws;
+    uint16_t y = 40;
+
+    Wave_Stats(&ws);
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "WAVE CACHE ");
+    Fmt_UintW(&f, ws.bytes_used, 5);
+    Fmt_Char(&f, '/');
+    Fmt_UintW(&f, ws.bytes_total, -5);
+    Fmt_Str(&f, "B ");
+    Fmt_Uint(&f, ws.entries);
+    Fmt_Char(&f, 'E');
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 15;
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "HIT ");
+    Fmt_UintW(&f, ws.hits, -5);
+    Fmt_Str(&f, " MISS ");
+    Fmt_UintW(&f, ws.misses, -4);
+    Fmt_Str(&f, " EVICT ");
+    Fmt_UintW(&f, ws.evictions, -3);
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 25;
+
+    LCD_WriteString("SECTION      LAST US   MAX US", 5, y, Font_7x10, COLOR_TERM_TEXT, BLACK);
+    y += 15;
+    for (ProfId id = 0; id < PROF_COUNT; id++) {
+        const ProfStat *st = Prof_Get(id);
+        Fmt_Init(&f, line, sizeof(line));
+        Fmt_StrW(&f, Prof_Name(id), -11);
+        Fmt_Char(&f, ' ');
+        Fmt_UintW(&f, st->last_us, 8);
+        Fmt_Char(&f, ' ');
+        Fmt_UintW(&f, st->max_us, 8);
+        LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+        y += 15;
+    }
+
+    // Run the same capture with HOT_CODE_IN_RAM=0 to compare against flash (arena.h)
+    const ProfStat *rf = Prof_Get(PROF_RF_BLOCK);
+    const ProfStat *dm = Prof_Get(PROF_DEMOD);
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "HOT CODE ");
+    Fmt_StrW(&f, HOT_CODE_IN_RAM ? "RAM" : "FLASH", -5);
+    Fmt_Char(&f, ' ');
+    Fmt_UintW(&f, (uint32_t)(_eramfunc - _sramfunc), 5);
+    Fmt_Char(&f, 'B');
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 15;
+    // Best cost + jitter, cycles: the two figures the RAM/flash comparison reads (arena.h)
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "CY RF ");
+    Fmt_UintW(&f, rf->min, 5);
+    Fmt_Char(&f, '+');
+    Fmt_UintW(&f, rf->max - rf->min, -5);
+    Fmt_Str(&f, " DM ");
+    Fmt_UintW(&f, dm->min, 5);
+    Fmt_Char(&f, '+');
+    Fmt_UintW(&f, dm->max - dm->min, -5);
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 15;
+
+    uint32_t events = 0;
+    for (EventType t = 0; t < EVT_TYPE_COUNT; t++) events += Events_Posted(t);
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "EVENTS ");
+    Fmt_UintW(&f, events, 7);
+    Fmt_Str(&f, " OVR ");
+    Fmt_UintW(&f, Events_Posted(EVT_RF_OVERRUN), 5);
+    Fmt_Str(&f, " DROP ");
+    Fmt_UintW(&f, Events_Dropped(), 3);
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 15;
+
+    // Residency over the last refresh period
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "CLOCK ");
+    Fmt_StrW(&f, Clock_Profile(Power_Profile())->name, -4);
+    Fmt_Char(&f, ' ');
+    Fmt_UintW(&f, Power_Tree()->hclk / 1000000u, 2);
+    Fmt_Str(&f, "MHZ  SLEEP ");
+    Fmt_UintW(&f, Power_Residency(), 3);
+    Fmt_Char(&f, '%');
+    LCD_WriteString(line, 5, y, Font_7x10, COLOR_TERM_DIM, BLACK);
+    y += 15;
+
+    // Measured peak / reserved bytes, static estimate of this image, guard hits.
+    // A peak above the estimate means a call path the .su analysis missed.
+    const StackStats *sk = Stack_Get();
+    uint32_t est = Stack_Budget()->worst;
+    Fmt_Init(&f, line, sizeof(line));
+    Fmt_Str(&f, "STACK ");
+    Fmt_UintW(&f, sk->peak, 5);
+    Fmt_Char(&f, '/');
+    Fmt_UintW(&f, sk->size, -5);
+    Fmt_Str(&f, " EST ");
+    if (est) Fmt_UintW(&f, est, 5);
+    else Fmt_StrW(&f, "?", 5); // Not patched: no figure to compare against
+    Fmt_Str(&f, " OV ");
+    Fmt_UintW(&f, sk->overflows, 2);
+    LCD_WriteString(line, 5, y, Font_7x10,
+                    (sk->overflows || (est && sk->peak > est)) ? COLOR_ALERT : COLOR_TERM_DIM, BLACK);
+    diag_drawn_at = HAL_GetTick();
+}
+
+// --- CALIBRATION LOGIC ---
+
+/* Draws a crosshair target centered on (x, y) */
+static void Draw_Crosshair(uint16_t x, uint16_t y, uint16_t color) {
+    Gfx_Begin();
+    Gfx_HLine(x - 10, y, 21, color);
+    Gfx_VLine(x, y - 10, 21, color);
+    Gfx_FillRect(x - 1, y - 1, 3, 3, color);
+    Gfx_End();
+}
+
+static void Start_Calibration(void) {
+    calib_step = 0;
+    calib_failed = 0;
+    calib_held = 0;
+    currentState = PAGE_CALIBRATE;
+    ui_needs_update = 1;
+}
+
+/* Records the raw reading for the current target at press-down */
+static void Calibration_Press(void) {
+    Touch_GetLastRaw(&calib_raw[calib_step][0], &calib_raw[calib_step][1]);
+
+    // Confirm the hit; the next target appears once this press ends
+    Draw_Crosshair(calib_targets[calib_step][0], calib_targets[calib_step][1], COLOR_TERM_DIM);
+    calib_held = 1;
+}
+
+/* One press = one point: moves on at its release, solves after the last one.
+   The release lands here, so it never reaches the next page as a tap. */
+static void Calibration_Release(void) {
+    calib_held = 0;
+    calib_step++;
+    if (calib_step < TOUCH_CALIB_POINTS) {
+        ui_needs_update = 1;
+        return;
+    }
+
+    TouchCalib cal;
+    if (Touch_SolveCalibration(calib_targets, calib_raw, &cal)) {
+        Touch_SetCalibration(&cal);
+        Storage_SaveCalibration();
+        currentState = PAGE_MAIN;
+    } else {
+        // Degenerate points (e.g. double tap on one target): start over
+        calib_step = 0;
+        calib_failed = 1;
+    }
+    ui_needs_update = 1;
+}
+
 // --- KEYBOARD LOGIC ---
 
 const char* kb_rows_lower[] = {"qwert", "yuiop", "asdfg", "hjklc", "zvbnm"};
@@ -136,13 +506,10 @@ const char* kb_rows_upper[] = {"QWERT", "YUIOP", "ASDFG", "HJKLC", "ZVBNM"};
 const char* kb_rows_num[]   = {"12345", "67890", "-+=@#", "$%&()", "!?:;/"};
 
 static void Draw_Keyboard_Static(void) {
-    LCD_WriteString("ENTER NAME:", 10, 10, Font_7x10, COLOR_TERM_DIM, BLACK);
-    UI_DrawRect(10, 25, 220, 30, COLOR_TERM_TEXT);
-    
-    uint16_t start_y = 65;
-    uint16_t btn_w = 40;
-    uint16_t btn_h = 35;
-    uint16_t gap = 5;
+    const char *title = (kb_target == KB_JUMP) ? "JUMP TO LETTER:" :
+                        (kb_target == KB_SEARCH) ? "FIND SIGNAL:" : "ENTER NAME:";
+    LCD_WriteString(title, 10, 10, Font_7x10, COLOR_TERM_DIM, BLACK);
+    Layout_Draw(layout_keyboard); // Input box, key frames, fixed keys
 
     // Determine current layout
     const char** current_rows;
@@ -150,25 +517,19 @@ static void Draw_Keyboard_Static(void) {
     else if (kb_shift == 1) current_rows = kb_rows_upper;
     else current_rows = kb_rows_lower;
 
-    // Draw Grid Keys
+    // Key labels (the one part that changes with mode and shift)
+    Gfx_Begin();
     for (int row = 0; row < 5; row++) {
         for (int col = 0; col < 5; col++) {
-            char key_char = current_rows[row][col];
-            uint16_t x = 10 + (col * (btn_w + gap));
-            uint16_t y = start_y + (row * (btn_h + gap));
-            
-            UI_DrawRect(x, y, btn_w, btn_h, COLOR_TERM_DIM);
-            char s[2] = {key_char, '\0'}; 
-            LCD_WriteString(s, x + 15, y + 10, Font_7x10, COLOR_TERM_TEXT, BLACK);
+            char s[2] = {current_rows[row][col], '\0'}; 
+            LCD_WriteString(s, KB_KEY_X(col) + 15, KB_KEY_Y(row) + 10, Font_7x10, COLOR_TERM_TEXT, BLACK);
         }
     }
+    Gfx_End();
     
     // Draw Function Keys
     Draw_Terminal_Button(&btn_Kb_Mode, (kb_mode==0)?"123":"ABC", 0);
     Draw_Terminal_Button_State(&btn_Kb_Shift, "SHF", 0, kb_shift); // Show Active state
-    Draw_Terminal_Button(&btn_Kb_Space, "_", 0);
-    Draw_Terminal_Button(&btn_Kb_Del, "DEL", 1);  // Red Alert
-    Draw_Terminal_Button(&btn_Kb_Done, "OK", 0);
 }
 
 static void Update_Input_Display(void) {
@@ -179,13 +540,21 @@ static void Update_Input_Display(void) {
     // Draw Cursor
     uint16_t cursor_x = 15 + (strlen(input_buffer) * 7);
     LCD_FillRect(cursor_x, 35, 7, 10, COLOR_TERM_TEXT);
+
+    // Live hit count while searching (right-aligned in the input box)
+    if (kb_target == KB_SEARCH) {
+        char hits[12];
+        Fmt f;
+        Fmt_Init(&f, hits, sizeof(hits));
+        Fmt_Uint(&f, Search_Count());
+        uint16_t len = Fmt_Str(&f, " HITS");
+        LCD_WriteString(hits, 225 - len * 7, 35, Font_7x10, COLOR_TERM_DIM, BLACK);
+    }
 }
 
 static char Check_Keyboard_Touch(uint16_t x, uint16_t y) {
-    uint16_t start_y = 65;
-    uint16_t btn_w = 40;
-    uint16_t btn_h = 35;
-    uint16_t gap = 5;
+    const uint16_t btn_w = KB_KEY_W;
+    const uint16_t btn_h = KB_KEY_H;
 
     const char** current_rows;
     if (kb_mode == 1) current_rows = kb_rows_num;
@@ -195,8 +564,8 @@ static char Check_Keyboard_Touch(uint16_t x, uint16_t y) {
     // Check Grid Presses
     for (int row = 0; row < 5; row++) {
         for (int col = 0; col < 5; col++) {
-            uint16_t key_x = 10 + (col * (btn_w + gap));
-            uint16_t key_y = start_y + (row * (btn_h + gap));
+            uint16_t key_x = KB_KEY_X(col);
+            uint16_t key_y = KB_KEY_Y(row);
             
             if (x >= key_x && x <= key_x + btn_w && y >= key_y && y <= key_y + btn_h) {
                 // Visual Flash
@@ -235,16 +604,111 @@ int Get_Total_Active_Signals(void) {
 void Delete_Signal(int idx) {
     if (idx < 0 || idx >= MAX_SLOTS) return;
     
-    // Shift remaining signals up to close the gap
-    for (int i = idx; i < MAX_SLOTS - 1; i++) {
-        signal_db[i] = signal_db[i+1];
-    }
-    // Clear the last slot
-    signal_db[MAX_SLOTS-1].is_active = 0;
-    memset(signal_db[MAX_SLOTS-1].name, 0, NAME_LEN);
+    // Slots stay where they are (the list is a sorted view), so a delete is one journal entry
+    signal_db[idx].is_active = 0;
+    memset(signal_db[idx].name, 0, NAME_LEN);
+    tx_queue &= ~(1u << idx);
     
-    // Save changes to Flash
-    Storage_SaveSignals();
+    // Committed to Flash in the background
+    Storage_SetPayload(idx, NULL, 0);
+}
+
+// --- LIST HELPERS ---
+
+static void List_Jump_To(char letter);
+
+/* Case-insensitive name order, ties broken by slot so the order is stable */
+static int List_Compare(uint8_t a, uint8_t b) {
+    const char *na = signal_db[a].name;
+    const char *nb = signal_db[b].name;
+    for (; *na && tolower((unsigned char)*na) == tolower((unsigned char)*nb); na++, nb++);
+    int diff = tolower((unsigned char)*na) - tolower((unsigned char)*nb);
+    return diff ? diff : (a - b);
+}
+
+/* Rebuilds the sorted index of active signals (insertion sort, MAX_SLOTS is small) */
+static void List_Rebuild_Index(void) {
+    list_count = 0;
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        if (!signal_db[i].is_active) continue;
+        int j = list_count++;
+        while (j > 0 && List_Compare(list_order[j - 1], i) > 0) {
+            list_order[j] = list_order[j - 1];
+            j--;
+        }
+        list_order[j] = i;
+    }
+
+    // Search results: best matches first, name order within each match quality
+    if (list_filtered) {
+        uint8_t ranked[MAX_SLOTS];
+        uint16_t n = 0;
+        for (uint8_t score = SEARCH_PREFIX; score > SEARCH_NONE; score--) {
+            for (uint16_t k = 0; k < list_count; k++) {
+                if (Search_Score(list_order[k]) == score) ranked[n++] = list_order[k];
+            }
+        }
+        memcpy(list_order, ranked, n);
+        list_count = n;
+    }
+
+    ListView_SetCount(&signal_list, list_count);
+}
+
+static const char* Search_Name(uint16_t index) {
+    return signal_db[index].is_active ? signal_db[index].name : NULL;
+}
+
+/* Opens the keyboard for the given purpose with an empty buffer */
+static void Open_Keyboard(KbTarget target) {
+    strcpy(input_buffer, "");
+    kb_target = target;
+    kb_mode = 0;
+    kb_shift = (target == KB_JUMP); // Jump letters read better in caps
+    currentState = PAGE_KEYBOARD;
+    ui_needs_update = 1;
+}
+
+/* Handles a character key for the current keyboard purpose */
+static void Keyboard_Input(char k) {
+    int len = strlen(input_buffer);
+
+    if (kb_target == KB_JUMP) {
+        List_Jump_To(k);
+        kb_target = KB_RENAME;
+        currentState = PAGE_TX_LIST;
+        ui_needs_update = 1;
+        return;
+    }
+    if (len >= NAME_LEN) return;
+    if (kb_target == KB_SEARCH && !Search_Push(k)) return;
+
+    input_buffer[len] = k;
+    input_buffer[len+1] = '\0';
+    Update_Input_Display();
+}
+
+static const char* List_Label(uint16_t index) {
+    return signal_db[list_order[index]].name;
+}
+
+/* Moves the list so the first name starting at or after 'letter' is on top */
+static void List_Jump_To(char letter) {
+    List_Rebuild_Index();
+    int c = tolower((unsigned char)letter);
+    uint16_t idx = 0;
+    while (idx < list_count && tolower((unsigned char)signal_db[list_order[idx]].name[0]) < c) idx++;
+    if (idx == list_count && idx > 0) idx--;
+    ListView_SetTop(&signal_list, idx);
+}
+
+/* Selects a list item with flash feedback and moves to the target page */
+static void List_Open_Item(int32_t item, AppState target) {
+    ListView_RedrawItem(&signal_list, (uint16_t)item, 1);
+    HAL_Delay(50);
+    selected_slot_idx = list_order[item];
+    currentState = target;
+    ui_needs_update = 1;
 }
 
 // --- PUBLIC UI FUNCTIONS ---
@@ -253,7 +717,8 @@ void UI_Init(void) {
     LCD_Init();
     LCD_FillColor(COLOR_TERM_BG);
     currentState = PAGE_BOOT;
-    Storage_LoadSignals(); // Load persistent data
+    ListView_Init(&signal_list, LIST_TOP, LIST_ROWS, List_Label);
+    Storage_Init(); // Load persistent data (signals + calibration)
 }
 
 void UI_Draw_Boot_Sequence(void) {
@@ -264,8 +729,13 @@ void UI_Draw_Boot_Sequence(void) {
     LCD_WriteString("SYSTEM READY", 70, 140, Font_7x10, COLOR_TERM_TEXT, BLACK);
     HAL_Delay(500);
     
-    currentState = PAGE_MAIN;
-    ui_needs_update = 1;
+    // First boot (no stored calibration): ask for one before anything else
+    if (Touch_IsCalibrated()) {
+        currentState = PAGE_MAIN;
+        ui_needs_update = 1;
+    } else {
+        Start_Calibration();
+    }
 }
 
 void UI_Refresh(void) {
@@ -273,6 +743,10 @@ void UI_Refresh(void) {
     if (!ui_needs_update && currentState != PAGE_KEYBOARD) return; 
     if (currentState == PAGE_KEYBOARD && !ui_needs_update) return;
 
+    // Only the list page uses hardware scrolling; everything else draws unscrolled
+    if (currentState != PAGE_TX_LIST) ListView_Release();
+
+    uint32_t t0 = Prof_Now();
     LCD_FillColor(COLOR_TERM_BG); 
     char slot_buf[30];
 
@@ -280,48 +754,46 @@ void UI_Refresh(void) {
         case PAGE_BOOT: break;
 
         case PAGE_MAIN:
-            LCD_WriteString("// ROOT_ACCESS", 5, 10, Font_7x10, COLOR_TERM_DIM, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_TERM_DIM);
-            Draw_Terminal_Button(&btn_Tx, "> EXECUTE_PAYLOAD", 0);
-            Draw_Terminal_Button(&btn_Rx, "> SNIFF_TRAFFIC", 0);
+            Layout_Draw(layout_main);
             break;
 
         case PAGE_TX_LIST:
         {
+            List_Rebuild_Index();
+
             char title[30];
-            sprintf(title, "// LIST [PG %d]", list_page + 1);
+            Fmt f;
+            Fmt_Init(&f, title, sizeof(title));
+            if (list_filtered) {
+                Fmt_Str(&f, "// FIND:");
+                Fmt_Str(&f, Search_Query());
+                Fmt_Str(&f, " [");
+            } else {
+                Fmt_Str(&f, "// LIST [");
+            }
+            Fmt_Uint(&f, list_count);
+            Fmt_Char(&f, ']');
+            if (tx_queue) {
+                Fmt_Str(&f, " QUEUE ");
+                Fmt_Uint(&f, __builtin_popcount(tx_queue));
+            }
             LCD_WriteString(title, 5, 10, Font_7x10, COLOR_TERM_DIM, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_TERM_DIM);
-            
-            int start_idx = list_page * SLOTS_PER_PAGE;
-            int total_signals = Get_Total_Active_Signals();
+            Layout_Draw(layout_list);
             
-            // Draw Slots
-            for (int i = 0; i < 3; i++) {
-                int db_idx = start_idx + i;
-                ButtonDef* btn = (i==0) ? &btn_Slot1 : (i==1) ? &btn_Slot2 : &btn_Slot3;
-                
-                if (db_idx < MAX_SLOTS && signal_db[db_idx].is_active) {
-                    sprintf(slot_buf, "> %s", signal_db[db_idx].name);
-                    Draw_Terminal_Button(btn, slot_buf, 0);
-                } else {
-                    Draw_Terminal_Button(btn, "", 0);
-                }
+            // Rows (only the visible ones are rendered)
+            ListView_Render(&signal_list);
+            if (list_count == 0) {
+                const char *empty = list_filtered ? "NO MATCHES" : "NO SAVED SIGNALS";
+                LCD_WriteString(empty, (240 - strlen(empty) * 7) / 2, LIST_TOP + 60, Font_7x10, COLOR_TERM_DIM, BLACK);
             }
             
-            // Draw Navigation
-            if (list_page > 0) Draw_Terminal_Button(&btn_Prev, "< PREV", 0);
-            if (total_signals > (start_idx + SLOTS_PER_PAGE)) Draw_Terminal_Button(&btn_Next, "NEXT >", 0);
-            Draw_Terminal_Button(&btn_Back, "< HOME", 1); 
+            Draw_Terminal_Button(&btn_List_Find, list_filtered ? "ALL" : "FIND", 0);
             break;
         }
 
         case PAGE_OPTIONS:
         {
-            LCD_WriteString("// SIGNAL OPT.", 5, 10, Font_7x10, COLOR_TERM_DIM, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_TERM_DIM);
-            
-            LCD_WriteString("SELECTED:", 88, 35, Font_7x10, COLOR_TERM_DIM, BLACK);
+            Layout_Draw(layout_options);
             
             // Centered Name
             char* name = signal_db[selected_slot_idx].name;
@@ -329,26 +801,44 @@ void UI_Refresh(void) {
             int name_x = (240 - name_width) / 2;
             LCD_WriteString(name, name_x, 55, Font_7x10, COLOR_TERM_TEXT, BLACK);
 
-            Draw_Terminal_Button(&btn_Opt_Tx, "TRANSMIT", 0);
-            Draw_Terminal_Button(&btn_Opt_Rename, "RENAME", 0);
-            Draw_Terminal_Button(&btn_Opt_Del, "DELETE", 1);
-            Draw_Terminal_Button(&btn_Opt_Back, "< BACK", 0);
+            // Decoded payload details, read in place
+            const uint8_t *payload = signal_db[selected_slot_idx].payload;
+            if (payload && Payload_BitLen(payload) == 0) {
+                uint16_t raw_len;
+                Payload_Raw(payload, &raw_len);
+                Fmt f;
+                Fmt_Init(&f, slot_buf, sizeof(slot_buf));
+                Fmt_Str(&f, "RAW TIMELINE ");
+                Fmt_Uint(&f, raw_len);
+                uint16_t len = Fmt_Char(&f, 'B');
+                LCD_WriteString(slot_buf, (240 - len * 7) / 2, 270, Font_7x10, COLOR_TERM_DIM, BLACK);
+            }
+            else if (payload) {
+                char id_hex[17];
+                Payload_IdHex(payload, id_hex, sizeof(id_hex));
+                Fmt f;
+                Fmt_Init(&f, slot_buf, sizeof(slot_buf));
+                Fmt_Str(&f, LF_Protocol_Name(Payload_Protocol(payload)));
+                Fmt_Char(&f, ' ');
+                Fmt_Uint(&f, Payload_BitLen(payload));
+                Fmt_Str(&f, "b ");
+                uint16_t len = Fmt_Str(&f, id_hex);
+                LCD_WriteString(slot_buf, (240 - len * 7) / 2, 270, Font_7x10, COLOR_TERM_DIM, BLACK);
+            }
+
+            if (Can_Clone(selected_slot_idx)) Draw_Terminal_Button(&btn_Opt_Clone, "CLONE", 0);
+            Draw_Terminal_Button_State(&btn_Opt_Queue, "QUEUE", 0, (tx_queue >> selected_slot_idx) & 1u);
             break;
         }
 
         case PAGE_CONFIRM_DELETE:
         {
-            LCD_WriteString("// WARNING", 5, 10, Font_7x10, COLOR_ALERT, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_ALERT);
-            LCD_WriteString("CONFIRM DELETE?", 67, 50, Font_7x10, COLOR_TERM_TEXT, BLACK);
+            Layout_Draw(layout_confirm_delete);
             
             char* name = signal_db[selected_slot_idx].name;
             int name_width = strlen(name) * 7;
             int name_x = (240 - name_width) / 2;
             LCD_WriteString(name, name_x, 70, Font_7x10, COLOR_TERM_DIM, BLACK);
-            
-            Draw_Terminal_Button(&btn_Conf_No, "NO", 1); 
-            Draw_Terminal_Button(&btn_Conf_Yes, "YES", 0); 
             break;
         }
 
@@ -359,27 +849,100 @@ void UI_Refresh(void) {
 
         case PAGE_TRANSMITTING:
         {
-            LCD_WriteString("// TRANSMITTING", 5, 10, Font_7x10, COLOR_TERM_TEXT, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_TERM_TEXT);
-            LCD_WriteString("SENDING:", 92, 80, Font_7x10, COLOR_TERM_DIM, BLACK);
+            Layout_Draw(layout_transmitting);
+
+            if (tx_playlist.count) {
+                char repeat[PLAYLIST_LABEL_LEN], gap[PLAYLIST_LABEL_LEN];
+                Fmt f;
+                Fmt_Init(&f, slot_buf, sizeof(slot_buf));
+                Fmt_Str(&f, "PLAYLIST: ");
+                Fmt_Uint(&f, tx_playlist.count);
+                uint16_t len = Fmt_Str(&f, " SIGNALS");
+                LCD_WriteString(slot_buf, (240 - len * 7) / 2, 50, Font_7x10, COLOR_TERM_DIM, BLACK);
+                Draw_Playlist_Progress();
+                Playlist_Labels(repeat, gap);
+                Draw_Terminal_Button(&btn_Pl_Repeat, repeat, 0);
+                Draw_Terminal_Button(&btn_Pl_Gap, gap, 0);
+                break;
+            }
             
             char* name = signal_db[selected_slot_idx].name;
             int name_width = strlen(name) * 7;
             int name_x = (240 - name_width) / 2;
             LCD_WriteString(name, name_x, 100, Font_7x10, COLOR_TERM_TEXT, BLACK);
-            
-            Draw_Terminal_Button(&btn_Stop, "[ STOP SIGNAL ]", 1);
+
+            // Decoded IDs are re-modulated, unknown fobs replay their raw timeline
+            const uint8_t *payload = signal_db[selected_slot_idx].payload;
+            Fmt f;
+            uint16_t len;
+            Fmt_Init(&f, slot_buf, sizeof(slot_buf));
+            if (!Wave_CanPlay(payload)) {
+                len = Fmt_Str(&f, "NOTHING TO EMULATE");
+            } else if (Payload_BitLen(payload) == 0) {
+                len = Fmt_Str(&f, "RAW REPLAY");
+            } else {
+                Fmt_Str(&f, "EMULATING ");
+                len = Fmt_Str(&f, LF_Protocol_Name(Payload_Protocol(payload)));
+            }
+            LCD_WriteString(slot_buf, (240 - len * 7) / 2, 130, Font_7x10,
+                            Wave_CanPlay(payload) ? COLOR_TERM_DIM : COLOR_ALERT, BLACK);
+            break;
+        }
+
+        case PAGE_WRITING:
+        {
+            Layout_Draw(layout_writing);
+
+            char* name = signal_db[selected_slot_idx].name;
+            LCD_WriteString(name, (240 - strlen(name) * 7) / 2, 80, Font_7x10, COLOR_TERM_TEXT, BLACK);
+
+            writer_shown = *RF_Writer_Status();
+            Draw_Writer_Status();
             break;
         }
 
         case PAGE_RX_SENSING:
-            LCD_WriteString("// SNIFFER_ACTIVE", 5, 10, Font_7x10, COLOR_ALERT, BLACK);
-            LCD_FillRect(0, 25, 240, 1, COLOR_ALERT);
-            LCD_WriteString("WAITING FOR SIGNAL...", 20, 100, Font_7x10, COLOR_TERM_TEXT, BLACK);
-            Draw_Terminal_Button(&btn_Back, "< STOP", 1); 
+            Layout_Draw(layout_rx_sensing);
+            Draw_Sniffer_Status();
+            break;
+
+        case PAGE_CALIBRATE:
+        {
+            Layout_Draw(layout_calibrate);
+
+            Fmt f;
+            Fmt_Init(&f, slot_buf, sizeof(slot_buf));
+            Fmt_Str(&f, "TAP THE TARGET (");
+            Fmt_Uint(&f, calib_step + 1);
+            Fmt_Char(&f, '/');
+            Fmt_Uint(&f, TOUCH_CALIB_POINTS);
+            Fmt_Char(&f, ')');
+            LCD_WriteString(slot_buf, 50, 140, Font_7x10, COLOR_TERM_TEXT, BLACK);
+            if (calib_failed) {
+                LCD_WriteString("BAD POINTS - RETRY", 57, 160, Font_7x10, COLOR_ALERT, BLACK);
+            }
+
+            Draw_Crosshair(calib_targets[calib_step][0], calib_targets[calib_step][1], COLOR_TERM_TEXT);
+            break;
+        }
+
+        case PAGE_DIAG:
+            Layout_Draw(layout_diag);
+            Draw_Diag();
             break;
     }
     ui_needs_update = 0;
+    Prof_Record(PROF_UI_FRAME, t0);
+}
+
+/* xorshift32 for the hex rain: newlib-nano's rand() allocates its state
+   on the heap at first use */
+static uint32_t Rain_Rand(void) {
+    static uint32_t s = 0x2545F491u;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
 }
 
 void UI_Update_Dynamic_Elements(void) {
@@ -388,48 +951,79 @@ void UI_Update_Dynamic_Elements(void) {
         uint16_t cursor_x = 15 + (strlen(input_buffer) * 7);
         if ((HAL_GetTick() / 500) % 2) LCD_FillRect(cursor_x, 35, 7, 10, COLOR_TERM_TEXT);
         else LCD_FillRect(cursor_x, 35, 7, 10, BLACK);
+        Power_WakeBy(HAL_GetTick() / 500 * 500 + 500);
     }
     
-    // 2. Matrix Animation (Only during active operations)
+    // 2. Clone progress (redrawn only when it changes)
+    if (currentState == PAGE_WRITING && !ui_needs_update &&
+        memcmp(RF_Writer_Status(), &writer_shown, sizeof(writer_shown)) != 0) {
+        writer_shown = *RF_Writer_Status();
+        Draw_Writer_Status();
+    }
+
+    // 3. Live statistics
+    if (currentState == PAGE_DIAG && !ui_needs_update && HAL_GetTick() - diag_drawn_at >= DIAG_REFRESH_MS) {
+        Draw_Diag();
+    }
+    if (currentState == PAGE_DIAG) Power_WakeBy(diag_drawn_at + DIAG_REFRESH_MS);
+
+    // 4. Matrix Animation (Only during active operations)
     if (currentState == PAGE_TRANSMITTING || currentState == PAGE_RX_SENSING) {
         if ((HAL_GetTick() % 10) == 0) { 
             char hex[3];
-            sprintf(hex, "%02X", rand() % 255);
-            uint16_t x = 200 + (rand() % 30);
-            uint16_t y = 280 + (rand() % 30);
+            Fmt f;
+            Fmt_Init(&f, hex, sizeof(hex));
+            Fmt_Hex(&f, Rain_Rand() % 255, 2);
+            uint16_t x = 200 + (Rain_Rand() % 30);
+            uint16_t y = 280 + (Rain_Rand() % 30);
             
             if (currentState == PAGE_RX_SENSING) {
-                 x = 100 + (rand() % 40);
-                 y = 140 + (rand() % 40);
+                 x = 100 + (Rain_Rand() % 40);
+                 y = 140 + (Rain_Rand() % 40);
             }
             LCD_WriteString(hex, x, y, Font_7x10, COLOR_TERM_DIM, BLACK);
         }
+        Power_WakeBy(HAL_GetTick() / 10 * 10 + 10);
     }
-    
-    // 3. Mock Sniffer Logic (Simulate Finding Signal)
-    if (currentState == PAGE_RX_SENSING) {
-        static uint32_t sniff_start = 0;
-        if (sniff_start == 0) sniff_start = HAL_GetTick();
-        
-        if (HAL_GetTick() - sniff_start > 3000) {
-            sniff_start = 0;
-            int new_slot = Find_Free_Slot();
-            if (new_slot != -1) {
-                selected_slot_idx = new_slot;
-                signal_db[new_slot].is_active = 1; 
-                strcpy(input_buffer, ""); 
-                kb_mode = 0; kb_shift = 0; // Default to lowercase alpha
-                currentState = PAGE_KEYBOARD;
-                ui_needs_update = 1;
-            }
-        }
+}
+
+void UI_Sniffer_Status(const SnifferStatus *status) {
+    if (memcmp(status, &sniffer_status, sizeof(sniffer_status)) == 0) return;
+    sniffer_status = *status;
+    if (currentState == PAGE_RX_SENSING && !ui_needs_update) Draw_Sniffer_Status();
+}
+
+void UI_Playlist_Progress(const PlaylistProgress *progress) {
+    if (memcmp(progress, &playlist_shown, sizeof(playlist_shown)) == 0) return;
+    playlist_shown = *progress;
+    if (currentState == PAGE_TRANSMITTING && tx_playlist.count && !ui_needs_update) Draw_Playlist_Progress();
+}
+
+void UI_Signal_Captured(const LfFrame *frame, const uint8_t *raw, uint16_t raw_len) {
+    // Static: a raw capture is too large for the stack; Storage copies it
+    static uint8_t payload[PAYLOAD_SMALL_MAX + RAWCAP_MAX_BYTES] ARENA_UI;
+
+    if (currentState != PAGE_RX_SENSING) return;
+
+    int new_slot = Find_Free_Slot();
+    if (new_slot == -1) return; // Database full: keep sniffing
+
+    uint16_t len = Payload_Build(payload, sizeof(payload), frame, raw, raw_len);
+    if (len == 0) return;
+
+    signal_db[new_slot].is_active = 1;
+    if (!Storage_SetPayload(new_slot, payload, len)) {
+        signal_db[new_slot].is_active = 0; // Too large to stage
+        return;
     }
+    selected_slot_idx = new_slot;
+    strcpy(input_buffer, "");
+    kb_mode = 0; kb_shift = 0; // Default to lowercase alpha
+    currentState = PAGE_KEYBOARD;
+    ui_needs_update = 1;
 }
 
 void UI_Handle_Touch(uint16_t x, uint16_t y) {
-    int start_idx = list_page * SLOTS_PER_PAGE;
-    int total_signals = Get_Total_Active_Signals();
-
     switch (currentState) {
         case PAGE_BOOT: break;
 
@@ -437,43 +1031,63 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
             if (Button_IsPressed(btn_Tx, x, y)) {
                 Flash_Button(&btn_Tx, "> EXECUTE_PAYLOAD", 0);
                 currentState = PAGE_TX_LIST;
-                list_page = 0; ui_needs_update = 1;
+                ListView_SetTop(&signal_list, 0); ui_needs_update = 1;
             }
             if (Button_IsPressed(btn_Rx, x, y)) {
                 Flash_Button(&btn_Rx, "> SNIFF_TRAFFIC", 0);
                 currentState = PAGE_RX_SENSING;
                 ui_needs_update = 1;
             }
+            if (Button_IsPressed(btn_Cal, x, y)) {
+                Flash_Button(&btn_Cal, "> CALIBRATE_TOUCH", 0);
+                Start_Calibration();
+            }
+            if (Button_IsPressed(btn_Diag, x, y)) {
+                Flash_Button(&btn_Diag, "> DIAGNOSTICS", 0);
+                currentState = PAGE_DIAG;
+                ui_needs_update = 1;
+            }
             break;
 
         case PAGE_TX_LIST:
-            // Prev Page
-            if (list_page > 0 && Button_IsPressed(btn_Prev, x, y)) {
-                Flash_Button(&btn_Prev, "< PREV", 0); list_page--; ui_needs_update = 1;
+            // Home
+            if (Button_IsPressed(btn_List_Home, x, y)) {
+                Flash_Button(&btn_List_Home, "< HOME", 1); list_filtered = 0;
+                currentState = PAGE_MAIN; ui_needs_update = 1;
             }
-            // Next Page
-            else if ((total_signals > (start_idx + SLOTS_PER_PAGE)) && Button_IsPressed(btn_Next, x, y)) {
-                Flash_Button(&btn_Next, "NEXT >", 0); list_page++; ui_needs_update = 1;
+            // Jump by first letter (reuses the keyboard)
+            else if (Button_IsPressed(btn_List_Jump, x, y)) {
+                Flash_Button(&btn_List_Jump, "A-Z", 0);
+                Open_Keyboard(KB_JUMP);
             }
-            // Home
-            else if (Button_IsPressed(btn_Back, x, y)) {
-                Flash_Button(&btn_Back, "< HOME", 1); currentState = PAGE_MAIN; ui_needs_update = 1;
+            // Search (or clear the active search)
+            else if (Button_IsPressed(btn_List_Find, x, y)) {
+                Flash_Button(&btn_List_Find, list_filtered ? "ALL" : "FIND", 0);
+                if (list_filtered) {
+                    list_filtered = 0;
+                    ListView_SetTop(&signal_list, 0); ui_needs_update = 1;
+                } else {
+                    Search_Begin(Search_Name, MAX_SLOTS);
+                    Open_Keyboard(KB_SEARCH);
+                }
+            }
+            // Playlist: the queue, or everything listed
+            else if (Button_IsPressed(btn_List_Play, x, y)) {
+                Flash_Button(&btn_List_Play, "PLAY", 0);
+                Playlist_From_List();
+                if (tx_playlist.count) {
+                    memset(&playlist_shown, 0, sizeof(playlist_shown));
+                    selected_slot_idx = tx_playlist.slots[0];
+                    currentState = PAGE_TRANSMITTING;
+                    ui_needs_update = 1;
+                }
             }
-            // Slot Selection
+            // Row Selection: tap fires the signal, long-press opens its options
             else {
-                char slot_buf[30];
-                for (int i=0; i<3; i++) {
-                    int db_idx = start_idx + i;
-                    ButtonDef* btn = (i==0) ? &btn_Slot1 : (i==1) ? &btn_Slot2 : &btn_Slot3;
-                    if (Button_IsPressed(*btn, x, y)) {
-                        if (db_idx < MAX_SLOTS && signal_db[db_idx].is_active) {
-                            sprintf(slot_buf, "> %s", signal_db[db_idx].name);
-                            Flash_Button(btn, slot_buf, 0);
-                            selected_slot_idx = db_idx;
-                            currentState = PAGE_OPTIONS; 
-                            ui_needs_update = 1;
-                        }
-                    }
+                int32_t item = ListView_ItemAt(&signal_list, y);
+                if (item >= 0) {
+                    tx_playlist.count = 0;
+                    List_Open_Item(item, PAGE_TRANSMITTING);
                 }
             }
             break;
@@ -481,9 +1095,15 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
         case PAGE_OPTIONS:
             if (Button_IsPressed(btn_Opt_Tx, x, y)) {
                 Flash_Button(&btn_Opt_Tx, "TRANSMIT", 0);
+                tx_playlist.count = 0;
                 currentState = PAGE_TRANSMITTING;
                 ui_needs_update = 1;
             }
+            else if (Button_IsPressed(btn_Opt_Clone, x, y) && Can_Clone(selected_slot_idx)) {
+                Flash_Button(&btn_Opt_Clone, "CLONE", 0);
+                currentState = PAGE_WRITING;
+                ui_needs_update = 1;
+            }
             else if (Button_IsPressed(btn_Opt_Rename, x, y)) {
                 Flash_Button(&btn_Opt_Rename, "RENAME", 0);
                 strcpy(input_buffer, signal_db[selected_slot_idx].name);
@@ -496,6 +1116,11 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
                 currentState = PAGE_CONFIRM_DELETE; 
                 ui_needs_update = 1;
             }
+            else if (Button_IsPressed(btn_Opt_Queue, x, y)) {
+                tx_queue ^= 1u << selected_slot_idx;
+                Flash_Button(&btn_Opt_Queue, NULL, 0);
+                Draw_Terminal_Button_State(&btn_Opt_Queue, "QUEUE", 0, (tx_queue >> selected_slot_idx) & 1u);
+            }
             else if (Button_IsPressed(btn_Opt_Back, x, y)) {
                 Flash_Button(&btn_Opt_Back, "< BACK", 0);
                 currentState = PAGE_TX_LIST;
@@ -507,11 +1132,8 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
             if (Button_IsPressed(btn_Conf_Yes, x, y)) {
                 Flash_Button(&btn_Conf_Yes, "YES", 0); 
                 Delete_Signal(selected_slot_idx);
-                // Fix pagination if page becomes empty
-                int new_total = Get_Total_Active_Signals();
-                if ((list_page * SLOTS_PER_PAGE) >= new_total && list_page > 0) {
-                    list_page--;
-                }
+                list_filtered = 0; // Entry removed, the search index is stale
+                // Scroll position is clamped when the list index is rebuilt
                 currentState = PAGE_TX_LIST; 
                 ui_needs_update = 1;
             }
@@ -523,11 +1145,21 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
             break;
 
         case PAGE_KEYBOARD:
-            if (Button_IsPressed(btn_Kb_Done, x, y)) {
+            if (Button_IsPressed(btn_Kb_Done, x, y) && kb_target != KB_RENAME) {
+                // Jump cancelled / search confirmed (an empty query shows everything)
+                Flash_Button(&btn_Kb_Done, "OK", 0);
+                list_filtered = (kb_target == KB_SEARCH && input_buffer[0] != '\0');
+                kb_target = KB_RENAME;
+                ListView_SetTop(&signal_list, 0);
+                currentState = PAGE_TX_LIST;
+                ui_needs_update = 1;
+            }
+            else if (Button_IsPressed(btn_Kb_Done, x, y)) {
                 Flash_Button(&btn_Kb_Done, "OK", 0);
                 strcpy(signal_db[selected_slot_idx].name, input_buffer);
                 signal_db[selected_slot_idx].is_active = 1;
-                Storage_SaveSignals();
+                Storage_UpdateSignal(selected_slot_idx);
+                list_filtered = 0; // Names changed, the search index is stale
                 currentState = PAGE_TX_LIST; 
                 ui_needs_update = 1; 
             }
@@ -535,16 +1167,12 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
                 Flash_Button(&btn_Kb_Del, "DEL", 1); 
                 int len = strlen(input_buffer);
                 if (len > 0) input_buffer[len-1] = '\0';
+                if (len > 0 && kb_target == KB_SEARCH) Search_Pop();
                 Update_Input_Display(); 
             }
             else if (Button_IsPressed(btn_Kb_Space, x, y)) {
                 Flash_Button(&btn_Kb_Space, "_", 0);
-                int len = strlen(input_buffer);
-                if (len < NAME_LEN) {
-                    input_buffer[len] = '_';
-                    input_buffer[len+1] = '\0';
-                }
-                Update_Input_Display(); 
+                Keyboard_Input('_');
             }
             else if (Button_IsPressed(btn_Kb_Mode, x, y)) {
                 kb_mode = !kb_mode; 
@@ -559,25 +1187,39 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
             }
             else {
                 char k = Check_Keyboard_Touch(x, y);
-                if (k != 0) {
-                    int len = strlen(input_buffer);
-                    if (len < NAME_LEN) {
-                        input_buffer[len] = k;
-                        input_buffer[len+1] = '\0';
-                    }
-                    Update_Input_Display(); 
-                }
+                if (k != 0) Keyboard_Input(k);
             }
             break;
 
         case PAGE_TRANSMITTING:
-            if (Button_IsPressed(btn_Stop, x, y)) {
+            if (tx_playlist.count && (Button_IsPressed(btn_Pl_Repeat, x, y) || Button_IsPressed(btn_Pl_Gap, x, y))) {
+                char repeat[PLAYLIST_LABEL_LEN], gap[PLAYLIST_LABEL_LEN];
+                if (Button_IsPressed(btn_Pl_Repeat, x, y)) {
+                    tx_playlist.repeats = (uint8_t)Next_Step(repeat_steps, sizeof(repeat_steps) / sizeof(repeat_steps[0]),
+                                                              tx_playlist.repeats);
+                } else {
+                    tx_playlist.gap_ms = Next_Step(gap_steps, sizeof(gap_steps) / sizeof(gap_steps[0]), tx_playlist.gap_ms);
+                }
+                tx_playlist.version++; // Player restarts with the new schedule
+                Playlist_Labels(repeat, gap);
+                Flash_Button(&btn_Pl_Repeat, repeat, 0);
+                Flash_Button(&btn_Pl_Gap, gap, 0);
+            }
+            else if (Button_IsPressed(btn_Stop, x, y)) {
                 Flash_Button(&btn_Stop, "[ STOP SIGNAL ]", 1);
                 currentState = PAGE_TX_LIST;
                 ui_needs_update = 1;
             }
             break;
 
+        case PAGE_WRITING:
+            if (Button_IsPressed(btn_Stop, x, y)) {
+                Flash_Button(&btn_Stop, "[ CLOSE ]", 1);
+                currentState = PAGE_OPTIONS;
+                ui_needs_update = 1;
+            }
+            break;
+
         case PAGE_RX_SENSING:
             if (Button_IsPressed(btn_Back, x, y)) {
                 Flash_Button(&btn_Back, "< STOP", 1); 
@@ -585,5 +1227,56 @@ void UI_Handle_Touch(uint16_t x, uint16_t y) {
                 ui_needs_update = 1;
             }
             break;
+
+        case PAGE_CALIBRATE:
+            // Handled on press-down in UI_Handle_Gesture
+            break;
+
+        case PAGE_DIAG:
+            if (Button_IsPressed(btn_Back, x, y)) {
+                Flash_Button(&btn_Back, "< BACK", 0);
+                currentState = PAGE_MAIN;
+                ui_needs_update = 1;
+            }
+            break;
+    }
+}
+
+void UI_Handle_Gesture(const GestureEvent *ev) {
+    if (currentState == PAGE_CALIBRATE) {
+        // Coordinates from the old matrix are meaningless here; use the raw reading
+        if (ev->type == GESTURE_DOWN) Calibration_Press();
+        else if (calib_held && Gesture_IsRelease(ev->type)) Calibration_Release();
+        return;
+    }
+
+    switch (ev->type) {
+        case GESTURE_TAP:
+            UI_Handle_Touch(ev->x, ev->y);
+            break;
+
+        case GESTURE_LONG_PRESS:
+            if (currentState == PAGE_TX_LIST) {
+                int32_t item = ListView_ItemAt(&signal_list, ev->y);
+                if (item >= 0) List_Open_Item(item, PAGE_OPTIONS);
+            }
+            break;
+
+        case GESTURE_DRAG:
+            // Content follows the finger
+            if (currentState == PAGE_TX_LIST) ListView_ScrollBy(&signal_list, -ev->dy);
+            break;
+
+        case GESTURE_SWIPE_UP:
+            // Fling: advance almost a full screen, keeping one row for context
+            if (currentState == PAGE_TX_LIST) ListView_ScrollBy(&signal_list, (LIST_ROWS - 1) * LIST_ROW_H);
+            break;
+
+        case GESTURE_SWIPE_DOWN:
+            if (currentState == PAGE_TX_LIST) ListView_ScrollBy(&signal_list, -(LIST_ROWS - 1) * LIST_ROW_H);
+            break;
+
+        default:
+            break;
     }
 }
\ No newline at end of file
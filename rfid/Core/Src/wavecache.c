@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    wavecache.c
+  * @brief   Emulation timeline synthesis and the LRU timeline pool.
+  *
+  * A timeline is built in two passes over the same expander: the first only
+  * counts runs so the pool space can be reserved, the second writes the ARR
+  * values in place. Pieces of equal level are merged into one run, since the
+  * switch toggles on every timer period. A loop must alternate levels across
+  * the wrap too, so an odd run count means the first and last runs have the
+  * same level and they are merged.
+  *
+  * The pool is first-fit over the gaps between live entries; when nothing
+  * fits, the least recently used unlocked entry goes. Sixteen entries over
+  * 12 KB keep the scan trivial.
+  ******************************************************************************
+  */
+
+#include "wavecache.h"
+#include "payload.h"
+#include "rawcap.h"
+#include "lf_protocols.h"
+#include "arena.h"
+#include <stddef.h>
+#include <string.h>
+
+#define MAX_RUN_CYCLES  (0xFFFFu / WAVE_TICKS_PER_CYCLE) // Longest run one period can hold
+
+typedef struct {
+    uint32_t key;           // Payload hash, 0 = free
+    uint32_t used;          // LRU stamp
+    uint16_t start;         // First pool word
+    uint16_t runs;
+    uint8_t first_level;
+    uint8_t locked;         // Being played: never evicted
+} WaveEntry;
+
+// Collects pieces of the envelope into runs (counts only while 'dst' is NULL)
+typedef struct {
+    uint16_t *dst;
+    uint16_t n;             // Runs closed so far
+    uint32_t pend;          // Cycles of the run being built
+    uint8_t level;
+    uint8_t first_level;
+} Emitter;
+
+static uint16_t pool[WAVE_POOL_WORDS] ARENA_WAVE;
+static WaveEntry entries[WAVE_MAX_ENTRIES] ARENA_WAVE;
+static uint32_t lru_clock;
+static uint32_t hits, misses, evictions;
+
+// --- EXPANSION ---
+
+static void Emit_Flush(Emitter *e) {
+    if (e->pend == 0) return;
+    uint32_t cycles = (e->pend > MAX_RUN_CYCLES) ? MAX_RUN_CYCLES : e->pend;
+    if (e->dst) e->dst[e->n] = (uint16_t)(cycles * WAVE_TICKS_PER_CYCLE - 1);
+    e->n++;
+    e->pend = 0;
+}
+
+static void Emit(Emitter *e, uint8_t level, uint16_t cycles) {
+    if (e->pend && level != e->level) Emit_Flush(e);
+    if (e->n == 0 && e->pend == 0) e->first_level = level;
+    e->level = level;
+    e->pend += cycles;
+}
+
+static void Expand_Raw(Emitter *e, const uint8_t *raw, uint16_t len) {
+    RawReader r;
+    uint8_t level;
+    uint16_t cycles;
+
+    if (!Rawcap_Open(&r, raw, len)) return;
+    while (Rawcap_Next(&r, &level, &cycles)) Emit(e, level, cycles ? cycles : 1);
+}
+
+/* Re-modulates the raw frame of an ID the way the tag would load the field */
+static void Expand_Id(Emitter *e, const LfProtocol *p, const uint8_t *bits, uint8_t len) {
+    uint32_t t = 0, bit_end = 0; // FSK: cycles emitted / where the bit grid says we should be
+    uint8_t phase = 0;           // PSK: reversals so far, mod 2
+
+    for (uint8_t i = 0; i < len; i++) {
+        switch (p->modulation) {
+            case LF_MOD_ASK_MANCHESTER:
+                Emit(e, bits[i], p->bit_cycles / 2);
+                Emit(e, !bits[i], p->bit_cycles - p->bit_cycles / 2);
+                break;
+
+            case LF_MOD_FSK: {
+                // Whole subcarrier periods; the rounding keeps the bit grid on average
+                uint8_t period = bits[i] ? p->sub_b : p->sub_a;
+                bit_end += p->bit_cycles;
+                uint32_t count = (bit_end - t + period / 2) / period;
+                for (uint32_t k = 0; k < count; k++) {
+                    Emit(e, 1, period / 2);
+                    Emit(e, 0, period - period / 2);
+                }
+                t += count * period;
+                break;
+            }
+
+            case LF_MOD_PSK1: {
+                // A bit change reverses the subcarrier: two equal halves merge
+                uint8_t half = p->sub_a / 2;
+                if (i > 0 && bits[i] != bits[i - 1]) phase ^= 1;
+                for (uint16_t k = 0; k < p->bit_cycles / half; k++) Emit(e, !((k & 1) ^ phase), half);
+                break;
+            }
+        }
+    }
+}
+
+/* Runs the payload through the matching expander; 0 if it has nothing to play */
+static uint8_t Expand(Emitter *e, const uint8_t *payload) {
+    uint16_t raw_len;
+    const uint8_t *raw = Payload_Raw(payload, &raw_len);
+    const LfProtocol *p = LF_Protocol_Find(Payload_Protocol(payload));
+    uint8_t bits[LF_MAX_FRAME_BITS];
+    uint8_t len = 0;
+
+    if (p && p->encode && Payload_BitLen(payload)) {
+        LfFrame id;
+        Payload_ToFrame(payload, &id);
+        len = p->encode(&id, bits);
+    }
+
+    if (len) Expand_Id(e, p, bits, len);
+    else if (raw) Expand_Raw(e, raw, raw_len);
+    Emit_Flush(e);
+
+    if (e->n & 1) {
+        // Same level at both ends: the last run continues into the first
+        e->n--;
+        if (e->dst) {
+            uint32_t ticks = (uint32_t)e->dst[0] + e->dst[e->n] + 1;
+            e->dst[0] = (ticks > 0xFFFF) ? 0xFFFF : (uint16_t)ticks;
+        }
+    }
+    return e->n >= 2;
+}
+
+// --- POOL ---
+
+static uint32_t Hash(const uint8_t *payload) {
+    uint32_t h = 2166136261u; // FNV-1a
+    for (uint16_t i = 0; i < Payload_Length(payload); i++) h = (h ^ payload[i]) * 16777619u;
+    return h ? h : 1;
+}
+
+static WaveEntry* Find(uint32_t key) {
+    for (uint8_t i = 0; i < WAVE_MAX_ENTRIES; i++) {
+        if (entries[i].key == key) return &entries[i];
+    }
+    return NULL;
+}
+
+static void To_Timeline(WaveEntry *en, WaveTimeline *out) {
+    en->used = ++lru_clock;
+    out->arr = &pool[en->start];
+    out->runs = en->runs;
+    out->first_level = en->first_level;
+}
+
+/* First free range of 'need' words between live entries */
+static uint8_t Find_Gap(uint16_t need, uint16_t *start) {
+    for (int8_t c = -1; c < WAVE_MAX_ENTRIES; c++) {
+        uint32_t pos = 0;
+        if (c >= 0) {
+            if (entries[c].key == 0) continue;
+            pos = entries[c].start + entries[c].runs; // Right after an entry
+        }
+        if (pos + need > WAVE_POOL_WORDS) continue;
+
+        uint8_t clear = 1;
+        for (uint8_t i = 0; i < WAVE_MAX_ENTRIES && clear; i++) {
+            if (entries[i].key == 0) continue;
+            if (pos < entries[i].start + entries[i].runs && entries[i].start < pos + need) clear = 0;
+        }
+        if (clear) {
+            *start = (uint16_t)pos;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Drops the least recently used entry that is not playing */
+static uint8_t Evict(void) {
+    WaveEntry *victim = NULL;
+    for (uint8_t i = 0; i < WAVE_MAX_ENTRIES; i++) {
+        WaveEntry *en = &entries[i];
+        if (en->key == 0 || en->locked) continue;
+        if (victim == NULL || en->used < victim->used) victim = en;
+    }
+    if (victim == NULL) return 0;
+    victim->key = 0;
+    evictions++;
+    return 1;
+}
+
+// --- PUBLIC FUNCTIONS ---
+
+uint8_t Wave_Lookup(const uint8_t *payload, WaveTimeline *out) {
+    WaveEntry *en = payload ? Find(Hash(payload)) : NULL;
+    if (en == NULL) {
+        misses++;
+        return 0;
+    }
+    hits++;
+    To_Timeline(en, out);
+    return 1;
+}
+
+uint8_t Wave_Build(const uint8_t *payload, WaveTimeline *out) {
+    Emitter e;
+    uint16_t start;
+
+    if (payload == NULL) return 0;
+    uint32_t key = Hash(payload);
+    WaveEntry *en = Find(key);
+    if (en) {
+        To_Timeline(en, out);
+        return 1;
+    }
+
+    // Pass 1: size
+    memset(&e, 0, sizeof(e));
+    if (!Expand(&e, payload) || e.n > WAVE_POOL_WORDS) return 0;
+    uint16_t need = e.n;
+
+    // Room for the entry and its runs
+    while ((en = Find(0)) == NULL) {
+        if (!Evict()) return 0;
+    }
+    while (!Find_Gap(need, &start)) {
+        if (!Evict()) return 0;
+    }
+
+    // Pass 2: write in place
+    memset(&e, 0, sizeof(e));
+    e.dst = &pool[start];
+    Expand(&e, payload);
+
+    en->key = key;
+    en->locked = 0;
+    en->start = start;
+    en->runs = need;
+    en->first_level = e.first_level;
+    To_Timeline(en, out);
+    return 1;
+}
+
+uint8_t Wave_CanPlay(const uint8_t *payload) {
+    uint16_t raw_len;
+    if (payload == NULL) return 0;
+    if (Payload_Raw(payload, &raw_len)) return 1;
+
+    const LfProtocol *p = LF_Protocol_Find(Payload_Protocol(payload));
+    return p && p->encode && Payload_BitLen(payload);
+}
+
+void Wave_Lock(const WaveTimeline *tl) {
+    for (uint8_t i = 0; i < WAVE_MAX_ENTRIES; i++) {
+        if (tl == NULL) entries[i].locked = 0;
+        else if (entries[i].key && &pool[entries[i].start] == tl->arr) entries[i].locked = 1;
+    }
+}
+
+void Wave_Stats(WaveStats *out) {
+    memset(out, 0, sizeof(*out));
+    for (uint8_t i = 0; i < WAVE_MAX_ENTRIES; i++) {
+        if (entries[i].key == 0) continue;
+        out->entries++;
+        out->bytes_used += entries[i].runs * sizeof(uint16_t);
+    }
+    out->bytes_total = sizeof(pool);
+    out->hits = hits;
+    out->misses = misses;
+    out->evictions = evictions;
+}
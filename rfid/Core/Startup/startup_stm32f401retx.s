@@ -79,6 +79,23 @@ LoopCopyDataInit:
   adds r4, r0, r3
   cmp r4, r1
   bcc CopyDataInit
+
+/* Copy the RAM functions from flash to SRAM */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  movs r3, #0
+  b LoopCopyRamFunc
+
+CopyRamFunc:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRamFunc:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRamFunc
   
 /* Zero fill the bss segment. */
   ldr r2, =_sbss
@@ -93,6 +110,34 @@ FillZerobss:
 LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
+
+/* Zero fill the subsystem arenas (arena.h). */
+  ldr r2, =_sarena
+  ldr r4, =_earena
+  movs r3, #0
+  b LoopFillZeroArena
+
+FillZeroArena:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroArena:
+  cmp r2, r4
+  bcc FillZeroArena
+
+/* Paint the unused stack for the high-water mark (STACK_PAINT in stack.h). */
+  ldr r2, =_sstack
+  mov r4, sp
+  ldr r3, =0xA5A5A5A5
+  b LoopPaintStack
+
+PaintStack:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintStack:
+  cmp r2, r4
+  bcc PaintStack
  
 /* Call static constructors */
     bl __libc_init_array
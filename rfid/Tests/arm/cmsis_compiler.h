@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    cmsis_compiler.h
+  * @brief   Host models of the Cortex-M4 SIMD intrinsics used by dsp.c.
+  * Written from the ARMv7-M ARM pseudocode (QADD16, QSUB16, SMLAD), so dsp.c
+  * built with __ARM_FEATURE_DSP runs its intrinsic path on the host. Only
+  * on the include path of the DSP test.
+  ******************************************************************************
+  */
+
+#ifndef TEST_CMSIS_COMPILER_H
+#define TEST_CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+static inline int32_t Model_SignedSat16(int32_t v) {
+    return (v > 32767) ? 32767 : (v < -32768) ? -32768 : v;
+}
+
+/* Lane i of a word as SInt() */
+static inline int32_t Model_Lane(uint32_t w, int i) {
+    return (int16_t)(uint16_t)(w >> (16 * i));
+}
+
+static inline uint32_t __QADD16(uint32_t op1, uint32_t op2) {
+    uint32_t lo = (uint16_t)Model_SignedSat16(Model_Lane(op1, 0) + Model_Lane(op2, 0));
+    uint32_t hi = (uint16_t)Model_SignedSat16(Model_Lane(op1, 1) + Model_Lane(op2, 1));
+    return lo | hi << 16;
+}
+
+static inline uint32_t __QSUB16(uint32_t op1, uint32_t op2) {
+    uint32_t lo = (uint16_t)Model_SignedSat16(Model_Lane(op1, 0) - Model_Lane(op2, 0));
+    uint32_t hi = (uint16_t)Model_SignedSat16(Model_Lane(op1, 1) - Model_Lane(op2, 1));
+    return lo | hi << 16;
+}
+
+/* Rd = Ra + lo*lo + hi*hi, kept to 32 bits (the Q flag is not modelled) */
+static inline uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3) {
+    int64_t sum = (int64_t)Model_Lane(op1, 0) * Model_Lane(op2, 0) +
+                  (int64_t)Model_Lane(op1, 1) * Model_Lane(op2, 1) + (int32_t)op3;
+    return (uint32_t)sum;
+}
+
+#endif // TEST_CMSIS_COMPILER_H
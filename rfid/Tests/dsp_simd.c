@@ -0,0 +1,20 @@
+/**
+  ******************************************************************************
+  * @file    dsp_simd.c
+  * @brief   dsp.c as the target builds it (__ARM_FEATURE_DSP), with the
+  * intrinsics from arm/cmsis_compiler.h and every entry point renamed
+  * Simd_*, so test_dsp links both paths side by side.
+  ******************************************************************************
+  */
+
+#define __ARM_FEATURE_DSP 1
+
+#define Dsp_Run             Simd_Run
+#define Dsp_DcBlock_Init    Simd_DcBlock_Init
+#define Dsp_DcBlock         Simd_DcBlock
+#define Dsp_Decimator_Init  Simd_Decimator_Init
+#define Dsp_Decimate        Simd_Decimate
+#define Dsp_Slicer_Init     Simd_Slicer_Init
+#define Dsp_Slice           Simd_Slice
+
+#include "../Core/Src/dsp.c"
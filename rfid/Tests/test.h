@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    test.h
+  * @brief   Minimal assertions for the host unit tests.
+  * A failed CHECK prints its location and the test carries on, so one run
+  * reports every broken case; TEST_END() turns the count into the exit code.
+  * Random cases come from one xorshift32 stream per test, seeded by
+  * Test_Seed() at the top of main(), so every run sees the same cases.
+  ******************************************************************************
+  */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+static int test_checks, test_failures;
+static uint32_t test_rng = 1;
+
+#define CHECK(cond) do { \
+    test_checks++; \
+    if (!(cond)) { \
+        test_failures++; \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+// Same, with a printf-style note (the values involved)
+#define CHECKF(cond, ...) do { \
+    test_checks++; \
+    if (!(cond)) { \
+        test_failures++; \
+        printf("%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+    } \
+} while (0)
+
+// --- RANDOM ---
+
+static inline void Test_Seed(uint32_t seed) {
+    test_rng = seed ? seed : 1; // Zero is xorshift's fixed point
+}
+
+static inline uint32_t Rand(void) {
+    test_rng ^= test_rng << 13;
+    test_rng ^= test_rng >> 17;
+    test_rng ^= test_rng << 5;
+    return test_rng;
+}
+
+#define TEST_END() do { \
+    printf("%s: %d checks, %d failed\n", __FILE__, test_checks, test_failures); \
+    return test_failures != 0; \
+} while (0)
+
+#endif // TEST_H
@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    test_clocks.c
+  * @brief   Clock tree derivation against a simulated RCC.
+  * A profile is programmed into a model of the RCC registers with the HAL
+  * encodings (PLLCFGR, CFGR prescalers, flash latency, regulator scale), and
+  * the model computes the clocks back from the register fields the way the
+  * reference manual describes them. Clock_Derive() must give the same bus
+  * and timer clocks, the minimum flash wait states, a 1 MHz timer prescaler
+  * and the fastest SPI dividers within the LCD and touch limits, and accept
+  * exactly the trees the device limits allow. Swept over the profile table,
+  * the boot configuration and a grid of PLL and bus settings.
+  * The tickless sleep is then simulated cycle by cycle for each profile: the
+  * HAL tick must not drift from real time over an hour of sleeps.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "clocks.h"
+#include "rf_frontend.h"
+#include "stm32f4xx_hal.h"
+
+// --- SIMULATED RCC ---
+
+typedef struct {
+    uint32_t pllcfgr;
+    uint32_t cfgr;         // SW, HPRE, PPRE1, PPRE2
+    uint32_t latency;      // FLASH_ACR.LATENCY
+    uint8_t vos;
+} Rcc;
+
+// Prescaler shifts by field value (RM0368 6.3.3, as in system_stm32f4xx.c)
+static const uint8_t ahb_shift[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9 };
+static const uint8_t apb_shift[8] = { 0, 0, 0, 0, 1, 2, 3, 4 };
+
+static uint32_t Ahb_Div(uint16_t div) {
+    switch (div) {
+        case 1: return RCC_SYSCLK_DIV1;
+        case 2: return RCC_SYSCLK_DIV2;
+        case 4: return RCC_SYSCLK_DIV4;
+        case 8: return RCC_SYSCLK_DIV8;
+        case 16: return RCC_SYSCLK_DIV16;
+        case 64: return RCC_SYSCLK_DIV64;
+        case 128: return RCC_SYSCLK_DIV128;
+        case 256: return RCC_SYSCLK_DIV256;
+        default: return RCC_SYSCLK_DIV512;
+    }
+}
+
+static uint32_t Apb_Div(uint8_t div) {
+    switch (div) {
+        case 1: return RCC_HCLK_DIV1;
+        case 2: return RCC_HCLK_DIV2;
+        case 4: return RCC_HCLK_DIV4;
+        case 8: return RCC_HCLK_DIV8;
+        default: return RCC_HCLK_DIV16;
+    }
+}
+
+/* What HAL_RCC_OscConfig / HAL_RCC_ClockConfig leave in the registers */
+static void Program(Rcc *r, const ClockProfile *p, uint32_t latency) {
+    r->pllcfgr = RCC_PLLSOURCE_HSI |
+                 (uint32_t)p->pll_m << RCC_PLLCFGR_PLLM_Pos |
+                 (uint32_t)p->pll_n << RCC_PLLCFGR_PLLN_Pos |
+                 (((uint32_t)p->pll_p >> 1) - 1) << RCC_PLLCFGR_PLLP_Pos |
+                 (uint32_t)p->pll_q << RCC_PLLCFGR_PLLQ_Pos;
+    r->cfgr = (p->use_pll ? RCC_SYSCLKSOURCE_PLLCLK : RCC_SYSCLKSOURCE_HSI) |
+              Ahb_Div(p->ahb_div) | Apb_Div(p->apb1_div) | (Apb_Div(p->apb2_div) << 3);
+    r->latency = latency;
+    r->vos = p->vos;
+}
+
+static uint32_t Field(uint32_t reg, uint32_t msk, uint32_t pos) {
+    return (reg & msk) >> pos;
+}
+
+static uint32_t Vco_In(const Rcc *r) {
+    return CLOCK_HSI_HZ / Field(r->pllcfgr, RCC_PLLCFGR_PLLM_Msk, RCC_PLLCFGR_PLLM_Pos);
+}
+
+static uint32_t Vco_Out(const Rcc *r) {
+    return Vco_In(r) * Field(r->pllcfgr, RCC_PLLCFGR_PLLN_Msk, RCC_PLLCFGR_PLLN_Pos);
+}
+
+static uint32_t Sysclk(const Rcc *r) {
+    if ((r->cfgr & RCC_CFGR_SW) != RCC_SYSCLKSOURCE_PLLCLK) return CLOCK_HSI_HZ;
+    uint32_t p = (Field(r->pllcfgr, RCC_PLLCFGR_PLLP_Msk, RCC_PLLCFGR_PLLP_Pos) + 1) * 2;
+    return Vco_Out(r) / p;
+}
+
+static uint32_t Hclk(const Rcc *r) {
+    return Sysclk(r) >> ahb_shift[Field(r->cfgr, RCC_CFGR_HPRE_Msk, RCC_CFGR_HPRE_Pos)];
+}
+
+static uint32_t Pclk(const Rcc *r, uint32_t msk, uint32_t pos) {
+    return Hclk(r) >> apb_shift[Field(r->cfgr, msk, pos)];
+}
+
+/* Timers run at twice a divided APB clock (TIMPRE = 0) */
+static uint32_t Timer_Clk(const Rcc *r, uint32_t msk, uint32_t pos) {
+    uint32_t pclk = Pclk(r, msk, pos);
+    return (pclk == Hclk(r)) ? pclk : 2 * pclk;
+}
+
+/* Fewest wait states for HCLK up to 84 MHz at 2.7-3.6 V (RM0368 table 6) */
+static uint32_t Min_Latency(uint32_t hclk) {
+    return (hclk <= 30000000u) ? 0 : (hclk <= 60000000u) ? 1 : 2;
+}
+
+/* Every device limit Clock_Derive() is responsible for */
+static uint8_t Allowed(const Rcc *r) {
+    uint32_t pclk1 = Pclk(r, RCC_CFGR_PPRE1_Msk, RCC_CFGR_PPRE1_Pos);
+    if (Hclk(r) > ((r->vos == 3) ? 60000000u : 84000000u)) return 0;
+    if (pclk1 > 42000000u) return 0;
+    if (Pclk(r, RCC_CFGR_PPRE2_Msk, RCC_CFGR_PPRE2_Pos) > 84000000u) return 0;
+    return (pclk1 >> 8) <= CLOCK_TOUCH_SPI_MAX_HZ; // SPI divider tops out at 256
+}
+
+/* Smallest divider keeping SCK under the limit, from first principles */
+static uint8_t Fastest_Br(uint32_t pclk, uint32_t max_hz) {
+    for (uint8_t br = 0; br < 7; br++) {
+        if ((pclk >> (br + 1)) <= max_hz) return br;
+    }
+    return 7;
+}
+
+// --- CHECKS ---
+
+static void Check_Tree(const char *what, const ClockProfile *p, uint8_t expect_ok) {
+    ClockTree t;
+    Rcc r;
+
+    uint8_t ok = Clock_Derive(p, &t);
+    Program(&r, p, t.flash_ws);
+
+    uint32_t pclk1 = Pclk(&r, RCC_CFGR_PPRE1_Msk, RCC_CFGR_PPRE1_Pos);
+    uint32_t pclk2 = Pclk(&r, RCC_CFGR_PPRE2_Msk, RCC_CFGR_PPRE2_Pos);
+    CHECKF(t.sysclk == Sysclk(&r) && t.hclk == Hclk(&r), "%s: sysclk %u hclk %u, RCC %u %u",
+           what, (unsigned)t.sysclk, (unsigned)t.hclk, (unsigned)Sysclk(&r), (unsigned)Hclk(&r));
+    CHECKF(t.pclk1 == pclk1 && t.pclk2 == pclk2, "%s: pclk %u/%u, RCC %u/%u",
+           what, (unsigned)t.pclk1, (unsigned)t.pclk2, (unsigned)pclk1, (unsigned)pclk2);
+    CHECKF(t.tim3_clk == Timer_Clk(&r, RCC_CFGR_PPRE1_Msk, RCC_CFGR_PPRE1_Pos) &&
+           t.tim1_clk == Timer_Clk(&r, RCC_CFGR_PPRE2_Msk, RCC_CFGR_PPRE2_Pos),
+           "%s: timer clocks %u/%u", what, (unsigned)t.tim3_clk, (unsigned)t.tim1_clk);
+    CHECKF(Hclk(&r) > 84000000u || r.latency == Min_Latency(Hclk(&r)), "%s: %u wait states at %u Hz",
+           what, t.flash_ws, (unsigned)Hclk(&r));
+    CHECKF(ok == Allowed(&r), "%s: derive says %u", what, ok);
+    if (expect_ok) CHECKF(ok, "%s: rejected", what);
+    if (!ok) return;
+
+    // Whole-MHz timer clocks give an exact microsecond tick
+    CHECKF(t.tim3_clk % 1000000u || t.tim3_clk / (t.us_psc + 1u) == 1000000u,
+           "%s: prescaler %u", what, t.us_psc);
+    CHECKF(t.lcd_br == Fastest_Br(pclk2, CLOCK_LCD_SPI_MAX_HZ), "%s: LCD BR %u", what, t.lcd_br);
+    CHECKF(t.touch_br == Fastest_Br(pclk1, CLOCK_TOUCH_SPI_MAX_HZ) &&
+           (pclk1 >> (t.touch_br + 1)) <= CLOCK_TOUCH_SPI_MAX_HZ, "%s: touch BR %u", what, t.touch_br);
+}
+
+/* The table's own profiles: valid trees, and PLL settings inside the VCO ranges */
+static void Check_Profiles(void) {
+    for (int id = 0; id < CLOCK_PROFILE_COUNT; id++) {
+        const ClockProfile *p = Clock_Profile(id);
+        Rcc r;
+        Check_Tree(p->name, p, 1);
+        if (!p->use_pll) continue;
+        Program(&r, p, 0);
+        CHECKF(Vco_In(&r) >= 1000000u && Vco_In(&r) <= 2000000u, "%s: VCO in %u", p->name, (unsigned)Vco_In(&r));
+        CHECKF(Vco_Out(&r) >= 192000000u && Vco_Out(&r) <= 432000000u, "%s: VCO %u", p->name, (unsigned)Vco_Out(&r));
+        CHECKF(Vco_Out(&r) / p->pll_q <= 48000000u, "%s: PLL48CK %u", p->name, (unsigned)(Vco_Out(&r) / p->pll_q));
+    }
+    CHECK(Clock_Profile(CLOCK_PROFILE_COUNT) == NULL);
+}
+
+/* CLOCK_FULL is the tree SystemClock_Config boots into, and the RF timing's */
+static void Check_Boot(void) {
+    const ClockProfile boot = { "boot", 1, 16, 4, 7, 336, 1, 2, 1, 2 }; // main.c SystemClock_Config
+    ClockTree full;
+    Rcc a, b;
+
+    Clock_Derive(Clock_Profile(CLOCK_FULL), &full);
+    Program(&a, Clock_Profile(CLOCK_FULL), full.flash_ws);
+    Program(&b, &boot, FLASH_LATENCY_2);
+    CHECK(a.pllcfgr == b.pllcfgr && a.cfgr == b.cfgr && a.latency == b.latency);
+    CHECK(full.tim3_clk == RF_TIMER_CLK);
+    CHECK(full.pclk2 >> (full.lcd_br + 1) == CLOCK_LCD_SPI_MAX_HZ); // The link keeps its 42 MHz
+}
+
+static void Check_Grid(void) {
+    static const uint16_t ns[] = { 192, 240, 288, 336, 384, 432 };
+    static const uint16_t ahbs[] = { 1, 2, 4, 8, 16, 64, 512 };
+    static const uint8_t apbs[] = { 1, 2, 4, 8, 16 };
+    char what[48];
+    uint32_t trees = 0;
+
+    for (uint8_t use_pll = 0; use_pll <= 1; use_pll++)
+    for (unsigned n = 0; n < (use_pll ? sizeof(ns) / sizeof(ns[0]) : 1); n++)
+    for (uint8_t pll_p = 2; pll_p <= (use_pll ? 8 : 2); pll_p += 2)
+    for (unsigned h = 0; h < sizeof(ahbs) / sizeof(ahbs[0]); h++)
+    for (unsigned a1 = 0; a1 < sizeof(apbs); a1++)
+    for (unsigned a2 = 0; a2 < sizeof(apbs); a2++)
+    for (uint8_t vos = 2; vos <= 3; vos++) {
+        ClockProfile p = { "grid", use_pll, 16, pll_p, 7, ns[n], ahbs[h], apbs[a1], apbs[a2], vos };
+        snprintf(what, sizeof(what), "%s N%u P%u /%u /%u /%u scale %u", use_pll ? "PLL" : "HSI",
+                 p.pll_n, p.pll_p, p.ahb_div, p.apb1_div, p.apb2_div, vos);
+        Check_Tree(what, &p, 0);
+        trees++;
+    }
+    printf("clocks: %u trees checked against the RCC model\n", (unsigned)trees);
+}
+
+// --- TICKLESS SLEEP ---
+
+/*
+ * Power_Idle() at core clock cycle resolution: the SysTick runs while awake,
+ * TIM5 counts the sleep, and the hand-overs between them lose 'handover'
+ * cycles each way. The HAL tick must never run ahead of real time, must reach
+ * the deadline whenever TIM5 ends the sleep, and may only fall behind by the
+ * hand-overs and the nanosecond rounding.
+ */
+static void Check_Drift(ClockProfileId id, uint32_t awake_max_us, uint32_t sleep_max_ms,
+                        uint32_t handover, uint32_t seconds) {
+    const char *name = Clock_Profile(id)->name;
+    ClockTree t;
+    Clock_Derive(Clock_Profile(id), &t);
+    CHECKF(t.tim3_clk == t.hclk, "%s: TIM5 clock %u, HCLK %u", name, (unsigned)t.tim3_clk, (unsigned)t.hclk);
+
+    const uint64_t per_ms = t.hclk / 1000u, end = (uint64_t)t.hclk * seconds;
+    uint64_t real = 0, phase = 0, sleeps = 0;
+    uint32_t tick = 0, carry_ns = 0;
+    uint8_t ahead = 0, short_wake = 0;
+
+    while (real < end) {
+        // Awake: the SysTick counts whole periods
+        uint64_t awake = Rand() % (awake_max_us * (t.hclk / 1000000u) + 1);
+        real += awake;
+        phase += awake;
+        tick += (uint32_t)(phase / per_ms);
+        phase %= per_ms;
+
+        // Power_Idle: the deadline counts from the start of the tick period
+        uint32_t ms = 1 + Rand() % sleep_max_ms, due = tick + ms;
+        uint32_t tim_per_ms = t.tim3_clk / 1000u;
+        uint32_t partial_ns = Clock_Ns((uint32_t)phase, t.hclk);
+        uint32_t target = ms * tim_per_ms - (uint32_t)((uint64_t)partial_ns * tim_per_ms / 1000000u);
+        real += handover;
+
+        // Woken by the compare (plus exit latency), or early by another interrupt
+        uint8_t by_timer = Rand() % 4 != 0;
+        uint32_t slept = by_timer ? target + Rand() % 24 : Rand() % target;
+        real += slept + handover;
+        tick += Clock_TickCatchUp(partial_ns, Clock_Ns(slept, t.tim3_clk), &carry_ns);
+        phase = 0;
+        sleeps++;
+
+        ahead |= tick > real / per_ms;
+        short_wake |= by_timer && (int32_t)(tick - due) < 0;
+    }
+
+    // Rounding loses under 2 ns per sleep
+    uint64_t behind = real / per_ms - tick;
+    uint64_t allowed = 1 + (sleeps * (2 * handover * 1000000000ull / t.hclk + 2)) / 1000000u;
+    CHECKF(!ahead, "%s: tick ran ahead of real time", name);
+    CHECKF(!short_wake, "%s: tick short of the deadline after a timer wakeup", name);
+    CHECKF(behind <= allowed, "%s: %u ms behind after %u s, allowed %u", name,
+           (unsigned)behind, seconds, (unsigned)allowed);
+    printf("clocks: %s, %u s, %u sleeps, %u-cycle hand-overs: tick %u ms behind\n", name, seconds,
+           (unsigned)sleeps, (unsigned)handover, (unsigned)behind);
+}
+
+int main(void) {
+    Test_Seed(0x165667B1u);
+    Check_Profiles();
+    Check_Boot();
+    Check_Grid();
+    for (int id = 0; id < CLOCK_PROFILE_COUNT; id++) {
+        Check_Drift(id, 3000, 20, 0, 3600);   // UI passes, short deadlines
+        Check_Drift(id, 50, 1, 0, 600);       // Back-to-back 1 ms sleeps
+        Check_Drift(id, 3000, 1000, 8, 3600); // With the hand-over cost
+    }
+    TEST_END();
+}
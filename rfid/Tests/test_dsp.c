@@ -0,0 +1,197 @@
+/**
+  ******************************************************************************
+  * @file    test_dsp.c
+  * @brief   Bit-exactness of the SIMD and plain C paths of dsp.c, and a
+  * host benchmark of the stages.
+  * dsp_simd.c builds the intrinsic path against models of QADD16, QSUB16 and
+  * SMLAD; both paths get the same blocks (ADC-like, full-scale noise,
+  * saturating steps, odd lengths) and must leave identical samples and
+  * identical stage state, block after block.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "dsp.h"
+#include <string.h>
+#include <time.h>
+
+// The intrinsic build (dsp_simd.c)
+uint16_t Simd_Run(const DspStage *stages, uint8_t count, int16_t *buf, uint16_t n);
+void Simd_DcBlock_Init(DspDcBlock *s, uint8_t shift, int16_t initial);
+uint16_t Simd_DcBlock(void *ctx, int16_t *buf, uint16_t n);
+void Simd_Decimator_Init(DspDecimator *s, uint8_t log2_factor);
+uint16_t Simd_Decimate(void *ctx, int16_t *buf, uint16_t n);
+void Simd_Slicer_Init(DspSlicer *s, int16_t decay, int16_t min_span);
+uint16_t Simd_Slice(void *ctx, int16_t *buf, uint16_t n);
+
+#define BLOCK   256
+#define BLOCKS  200
+
+typedef enum { SIG_ADC, SIG_NOISE, SIG_RAILS, SIG_KINDS } Signal;
+static const char *sig_names[SIG_KINDS] = { "adc", "full-scale noise", "rail steps" };
+
+/* Next block of a test signal; 't' runs on across blocks */
+static void Fill(Signal sig, int16_t *buf, uint16_t n, uint32_t *t) {
+    for (uint16_t i = 0; i < n; i++, (*t)++) {
+        switch (sig) {
+            case SIG_ADC: // 12-bit ADC around mid-scale, 8-cycle modulation, noise
+                buf[i] = (int16_t)(2048 + (((*t / 8) & 1) ? 90 : -90) + (int)(Rand() % 31) - 15);
+                break;
+            case SIG_NOISE:
+                buf[i] = (int16_t)Rand();
+                break;
+            default: // Long runs at the rails drive every lane into saturation
+                buf[i] = ((*t / 37) & 1) ? 32767 : -32768;
+                if (Rand() % 16 == 0) buf[i] = (int16_t)Rand();
+                break;
+        }
+    }
+}
+
+// --- BIT EXACTNESS ---
+
+static void Check_DcBlock(Signal sig, uint8_t shift, int16_t initial) {
+    static int16_t a[BLOCK + 1] __attribute__((aligned(4)));
+    static int16_t b[BLOCK + 1] __attribute__((aligned(4)));
+    DspDcBlock sa, sb;
+    uint32_t t = 0;
+    int bad = 0;
+
+    Dsp_DcBlock_Init(&sa, shift, initial);
+    Simd_DcBlock_Init(&sb, shift, initial);
+    for (int blk = 0; blk < BLOCKS && !bad; blk++) {
+        uint16_t n = (blk % 3 == 2) ? BLOCK - 1 : BLOCK; // Odd blocks take the scalar tail
+        Fill(sig, a, n, &t);
+        memcpy(b, a, sizeof(a));
+        uint16_t na = Dsp_DcBlock(&sa, a, n);
+        uint16_t nb = Simd_DcBlock(&sb, b, n);
+        bad = na != nb || memcmp(a, b, na * 2) || sa.dc != sb.dc;
+    }
+    CHECKF(!bad, "DcBlock %s shift %u initial %d: paths differ", sig_names[sig], shift, initial);
+}
+
+static void Check_Decimate(Signal sig, uint8_t log2) {
+    static int16_t a[BLOCK] __attribute__((aligned(4)));
+    static int16_t b[BLOCK] __attribute__((aligned(4)));
+    DspDecimator sa, sb;
+    uint32_t t = 0;
+    int bad = 0;
+
+    Dsp_Decimator_Init(&sa, log2);
+    Simd_Decimator_Init(&sb, log2);
+    for (int blk = 0; blk < BLOCKS && !bad; blk++) {
+        Fill(sig, a, BLOCK, &t);
+        memcpy(b, a, sizeof(a));
+        uint16_t na = Dsp_Decimate(&sa, a, BLOCK);
+        uint16_t nb = Simd_Decimate(&sb, b, BLOCK);
+        bad = na != nb || na != BLOCK >> log2 || memcmp(a, b, na * 2);
+    }
+    CHECKF(!bad, "Decimate %s 2^%u: paths differ", sig_names[sig], log2);
+}
+
+static void Check_Slice(Signal sig, int16_t decay, int16_t min_span) {
+    static int16_t a[BLOCK] __attribute__((aligned(4)));
+    static int16_t b[BLOCK] __attribute__((aligned(4)));
+    DspSlicer sa, sb;
+    uint32_t t = 0;
+    int bad = 0;
+
+    Dsp_Slicer_Init(&sa, decay, min_span);
+    Simd_Slicer_Init(&sb, decay, min_span);
+    for (int blk = 0; blk < BLOCKS && !bad; blk++) {
+        Fill(sig, a, BLOCK, &t);
+        memcpy(b, a, sizeof(a));
+        uint16_t na = Dsp_Slice(&sa, a, BLOCK);
+        uint16_t nb = Simd_Slice(&sb, b, BLOCK);
+        bad = na != nb || memcmp(a, b, na * 2) ||
+              sa.hi != sb.hi || sa.lo != sb.lo || sa.level != sb.level;
+    }
+    CHECKF(!bad, "Slice %s decay %d span %d: paths differ", sig_names[sig], decay, min_span);
+}
+
+/* The front end's chain, end to end */
+static void Check_Chain(Signal sig) {
+    static int16_t a[BLOCK] __attribute__((aligned(4)));
+    static int16_t b[BLOCK] __attribute__((aligned(4)));
+    DspDcBlock dca, dcb;
+    DspDecimator da, db;
+    DspSlicer sa, sb;
+    const DspStage ca[] = { { Dsp_DcBlock, &dca }, { Dsp_Decimate, &da }, { Dsp_Slice, &sa } };
+    const DspStage cb[] = { { Simd_DcBlock, &dcb }, { Simd_Decimate, &db }, { Simd_Slice, &sb } };
+    uint32_t t = 0;
+    int bad = 0;
+
+    Dsp_DcBlock_Init(&dca, 10, 2000);
+    Simd_DcBlock_Init(&dcb, 10, 2000);
+    Dsp_Decimator_Init(&da, 1);
+    Simd_Decimator_Init(&db, 1);
+    Dsp_Slicer_Init(&sa, 1, 24);
+    Simd_Slicer_Init(&sb, 1, 24);
+    for (int blk = 0; blk < BLOCKS && !bad; blk++) {
+        Fill(sig, a, BLOCK, &t);
+        memcpy(b, a, sizeof(a));
+        uint16_t na = Dsp_Run(ca, 3, a, BLOCK);
+        uint16_t nb = Simd_Run(cb, 3, b, BLOCK);
+        bad = na != nb || memcmp(a, b, na * 2);
+    }
+    CHECKF(!bad, "chain %s: paths differ", sig_names[sig]);
+}
+
+// --- BENCHMARK (host, C path) ---
+
+static double Now_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void Bench(const char *name, DspProcessFn fn, void *ctx) {
+    static int16_t src[BLOCK] __attribute__((aligned(4)));
+    static int16_t buf[BLOCK] __attribute__((aligned(4)));
+    const int reps = 20000;
+    uint32_t t = 0;
+    double spent = 0;
+
+    Fill(SIG_ADC, src, BLOCK, &t);
+    for (int r = 0; r < reps; r++) {
+        memcpy(buf, src, sizeof(buf));
+        double t0 = Now_Ns();
+        fn(ctx, buf, BLOCK);
+        spent += Now_Ns() - t0;
+    }
+    printf("dsp: %-12s %6.2f ns/sample (host)\n", name, spent / reps / BLOCK);
+}
+
+static void Benchmark(void) {
+    DspDcBlock dc;
+    DspDecimator dec;
+    DspSlicer sl;
+
+    Dsp_DcBlock_Init(&dc, 10, 2000);
+    Dsp_Decimator_Init(&dec, 1);
+    Dsp_Slicer_Init(&sl, 1, 24);
+    Bench("Dsp_DcBlock", Dsp_DcBlock, &dc);
+    Bench("Dsp_Decimate", Dsp_Decimate, &dec);
+    Bench("Dsp_Slice", Dsp_Slice, &sl);
+}
+
+int main(void) {
+    Test_Seed(0x9E3779B9u);
+    static const int16_t initials[] = { 0, 2048, -32768, 32767 };
+
+    for (int sig = 0; sig < SIG_KINDS; sig++) {
+        for (uint8_t shift = 1; shift <= 14; shift += 3) {
+            for (unsigned k = 0; k < sizeof(initials) / sizeof(initials[0]); k++) {
+                Check_DcBlock(sig, shift, initials[k]);
+            }
+        }
+        for (uint8_t log2 = 1; log2 <= 4; log2++) Check_Decimate(sig, log2);
+        Check_Slice(sig, 1, 24);
+        Check_Slice(sig, 300, 0);
+        Check_Slice(sig, 32767, 100);
+        Check_Slice(sig, -300, 100);
+        Check_Chain(sig);
+    }
+    Benchmark();
+    TEST_END();
+}
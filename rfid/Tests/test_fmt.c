@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    test_fmt.c
+  * @brief   Fixed-buffer formatter against the C library's snprintf.
+  * Every appender is compared with the printf conversion it replaces over
+  * edge values and widths from -12 to 12 (strings to 30), along with the
+  * returned length. Truncation must match snprintf for every capacity
+  * without writing past it, and random diagnostics lines must render byte
+  * for byte. A timing run compares one line built both ways, and a stack
+  * run compares the -fstack-usage frames of the Fmt chain with the peak of
+  * each way, measured on a painted stack.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "fmt.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#if !defined(__SANITIZE_ADDRESS__)
+#include <ucontext.h>
+#endif
+
+#define LINE_CAP   34   // The diagnostics line buffer
+#define LINES      200000
+#define BENCH_RUNS 50000
+#define PAINT_SIZE 65536
+#define PAINT      0xA5
+
+static const uint32_t edges[] = {
+    0, 1, 7, 9, 10, 42, 99, 100, 12345, 65535, 99999, 100000, 2147483648u, 4294967295u
+};
+#define EDGES (sizeof(edges) / sizeof(edges[0]))
+
+/* Same text and the returned length is its strlen */
+static int Same(const char *want, const char *got, uint16_t len) {
+    return strcmp(want, got) == 0 && strlen(want) == len;
+}
+
+// --- CONVERSIONS ---
+
+static void Check_Uint(void) {
+    char want[64], got[64];
+    Fmt f;
+
+    for (unsigned i = 0; i < EDGES; i++) {
+        for (int w = -12; w <= 12; w++) {
+            Fmt_Init(&f, got, sizeof(got));
+            uint16_t n = Fmt_UintW(&f, edges[i], (int8_t)w);
+            snprintf(want, sizeof(want), "%*lu", w, (unsigned long)edges[i]);
+            CHECKF(Same(want, got, n), "%%%dlu of %lu: '%s' (%u), want '%s'", w,
+                   (unsigned long)edges[i], got, n, want);
+        }
+        Fmt_Init(&f, got, sizeof(got));
+        uint16_t n = Fmt_Uint(&f, edges[i]);
+        snprintf(want, sizeof(want), "%lu", (unsigned long)edges[i]);
+        CHECKF(Same(want, got, n), "%%lu of %lu: '%s'", (unsigned long)edges[i], got);
+    }
+}
+
+static void Check_Int(void) {
+    static const int32_t vals[] = { 0, 1, -1, -42, 2147483647, -2147483647 - 1 };
+    char want[16], got[16];
+    Fmt f;
+
+    for (unsigned i = 0; i < sizeof(vals) / sizeof(vals[0]); i++) {
+        Fmt_Init(&f, got, sizeof(got));
+        uint16_t n = Fmt_Int(&f, vals[i]);
+        snprintf(want, sizeof(want), "%ld", (long)vals[i]);
+        CHECKF(Same(want, got, n), "%%ld of %ld: '%s'", (long)vals[i], got);
+    }
+}
+
+static void Check_Hex(void) {
+    char want[16], got[16];
+    Fmt f;
+
+    for (unsigned i = 0; i < EDGES; i++) {
+        for (uint8_t digits = 0; digits <= 9; digits++) {
+            // Only the low 'digits' nibbles are printed, capped at 8
+            uint8_t d = digits > 8 ? 8 : digits;
+            uint32_t v = (d == 8) ? edges[i] : edges[i] & ((1u << (4 * d)) - 1);
+            Fmt_Init(&f, got, sizeof(got));
+            uint16_t n = Fmt_Hex(&f, edges[i], digits);
+            if (d) snprintf(want, sizeof(want), "%0*lX", d, (unsigned long)v);
+            else want[0] = '\0';
+            CHECKF(Same(want, got, n), "%%0%uX of %08lX: '%s'", digits, (unsigned long)edges[i], got);
+        }
+    }
+}
+
+static void Check_Str(void) {
+    static const char *strs[] = { "", "A", "LISTENING", "NOTHING TO EMULATE" };
+    char want[64], got[64];
+    Fmt f;
+
+    for (unsigned i = 0; i < sizeof(strs) / sizeof(strs[0]); i++) {
+        for (int w = -30; w <= 30; w++) {
+            Fmt_Init(&f, got, sizeof(got));
+            uint16_t n = Fmt_StrW(&f, strs[i], (int8_t)w);
+            snprintf(want, sizeof(want), "%*s", w, strs[i]);
+            CHECKF(Same(want, got, n), "%%%ds of '%s': '%s'", w, strs[i], got);
+        }
+    }
+    Fmt_Init(&f, got, sizeof(got));
+    Fmt_Str(&f, "RSSI ");
+    Fmt_Int(&f, -73);
+    CHECK(Same("RSSI -73!", got, Fmt_Char(&f, '!')));
+}
+
+// --- TRUNCATION ---
+
+static void Check_Truncation(void) {
+    char want[48], got[48];
+    Fmt f;
+
+    for (uint16_t cap = 1; cap < 40; cap++) {
+        memset(got, 'Z', sizeof(got));
+        Fmt_Init(&f, got, cap);
+        Fmt_Str(&f, "EVENTS ");
+        Fmt_UintW(&f, 1234567, 7);
+        Fmt_Str(&f, " OVR ");
+        Fmt_Hex(&f, 0xBEEF, 4);
+        uint16_t n = Fmt_StrW(&f, "!", -3);
+        snprintf(want, cap, "EVENTS %7lu OVR %04X%-3s", 1234567ul, 0xBEEFu, "!");
+        CHECKF(Same(want, got, n), "cap %u: '%s' (%u), want '%s'", cap, got, n, want);
+        CHECKF(got[cap] == 'Z', "cap %u: written past the buffer", cap);
+    }
+}
+
+/* The HIT/MISS/EVICT line, both ways */
+static uint16_t Line_Fmt(char *buf, uint32_t hit, uint32_t miss, uint32_t evict) {
+    Fmt f;
+    Fmt_Init(&f, buf, LINE_CAP);
+    Fmt_Str(&f, "HIT ");
+    Fmt_UintW(&f, hit, -5);
+    Fmt_Str(&f, " MISS ");
+    Fmt_UintW(&f, miss, -4);
+    Fmt_Str(&f, " EVICT ");
+    return Fmt_UintW(&f, evict, -3);
+}
+
+static void Line_Printf(char *buf, uint32_t hit, uint32_t miss, uint32_t evict) {
+    snprintf(buf, LINE_CAP, "HIT %-5lu MISS %-4lu EVICT %-3lu",
+             (unsigned long)hit, (unsigned long)miss, (unsigned long)evict);
+}
+
+static void Check_Lines(void) {
+    char want[LINE_CAP], got[LINE_CAP];
+    uint32_t bad = 0;
+
+    for (uint32_t k = 0; k < LINES; k++) {
+        // Mostly counter-sized values, some long enough to truncate the line
+        uint32_t hit = (Rand() % 4) ? Rand() % 100000 : Rand();
+        uint32_t miss = Rand() % 100000, evict = Rand() % 1000;
+        uint16_t n = Line_Fmt(got, hit, miss, evict);
+        Line_Printf(want, hit, miss, evict);
+        if (!Same(want, got, n)) {
+            if (!bad) printf("fmt: '%s' vs snprintf '%s'\n", got, want);
+            bad++;
+        }
+    }
+    CHECKF(bad == 0, "%u of %u lines differ", bad, LINES);
+}
+
+// --- TIMING ---
+
+static double Now_Ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void Bench(void) {
+    static volatile uint32_t hit = 123456, miss = 999, evict = 42;
+    char buf[LINE_CAP];
+    double best_printf = 1e30, best_fmt = 1e30;
+
+    // Best of several batches: the least disturbed run of each
+    for (int batch = 0; batch < 5; batch++) {
+        double t0 = Now_Ns();
+        for (int r = 0; r < BENCH_RUNS; r++) {
+            Line_Printf(buf, hit, miss, evict);
+            __asm__ volatile("" : : "r"(buf) : "memory");
+        }
+        double t1 = Now_Ns();
+        for (int r = 0; r < BENCH_RUNS; r++) {
+            Line_Fmt(buf, hit, miss, evict);
+            __asm__ volatile("" : : "r"(buf) : "memory");
+        }
+        double t2 = Now_Ns();
+        if ((t1 - t0) / BENCH_RUNS < best_printf) best_printf = (t1 - t0) / BENCH_RUNS;
+        if ((t2 - t1) / BENCH_RUNS < best_fmt) best_fmt = (t2 - t1) / BENCH_RUNS;
+    }
+    printf("fmt: one diag line, snprintf %.0f ns, Fmt %.0f ns (%.1fx)\n",
+           best_printf, best_fmt, best_printf / best_fmt);
+}
+
+// --- STACK ---
+// Not under ASan: its redzones and fake stacks are not the program's frames
+
+#if !defined(__SANITIZE_ADDRESS__)
+
+static ucontext_t paint_main, paint_ctx;
+static uint8_t *paint_stack;
+static void (*paint_fn)(void);
+
+static void Paint_Entry(void) {
+    paint_fn();
+}
+
+/* Deepest byte 'fn' wrote below the top of a painted stack */
+static uint32_t Painted_Peak(void (*fn)(void)) {
+    memset(paint_stack, PAINT, PAINT_SIZE);
+    paint_fn = fn;
+    getcontext(&paint_ctx);
+    paint_ctx.uc_stack.ss_sp = paint_stack;
+    paint_ctx.uc_stack.ss_size = PAINT_SIZE;
+    paint_ctx.uc_link = &paint_main;
+    makecontext(&paint_ctx, Paint_Entry, 0);
+    swapcontext(&paint_main, &paint_ctx);
+
+    uint32_t low = 0;
+    while (low < PAINT_SIZE && paint_stack[low] == PAINT) low++;
+    return PAINT_SIZE - low;
+}
+
+static void Nothing(void) {
+    __asm__ volatile("" : : : "memory");
+}
+
+static void One_Line_Printf(void) {
+    static volatile uint32_t hit = 123456, miss = 999, evict = 42;
+    char buf[LINE_CAP];
+    Line_Printf(buf, hit, miss, evict);
+    __asm__ volatile("" : : "r"(buf) : "memory");
+}
+
+static void One_Line_Fmt(void) {
+    static volatile uint32_t hit = 123456, miss = 999, evict = 42;
+    char buf[LINE_CAP];
+    Line_Fmt(buf, hit, miss, evict);
+    __asm__ volatile("" : : "r"(buf) : "memory");
+}
+
+/* Frame of 'func' in a .su file; 0 if the compiler inlined it away */
+static uint32_t Su_Frame(const char *path, const char *func) {
+    char line[256];
+    uint32_t size = 0;
+    FILE *f = fopen(path, "r");
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f)) {
+        // fmt.c:72:10:Fmt_UintW<TAB>48<TAB>static
+        char *tab = strchr(line, '\t');
+        char *name = tab;
+        if (!tab) continue;
+        while (name > line && name[-1] != ':') name--;
+        if ((size_t)(tab - name) == strlen(func) && strncmp(name, func, tab - name) == 0) {
+            size = (uint32_t)strtoul(tab + 1, NULL, 10);
+        }
+    }
+    fclose(f);
+    return size;
+}
+
+static void Stack(const char *exe) {
+    // The build writes <exe>-<source>.su next to the binary
+    char fmt_su[256], test_su[256];
+    snprintf(fmt_su, sizeof(fmt_su), "%s-fmt.su", exe);
+    snprintf(test_su, sizeof(test_su), "%s-test_fmt.su", exe);
+    FILE *probe = fopen(fmt_su, "r");
+    CHECKF(probe != NULL, "no %s: build with -fstack-usage", fmt_su);
+    if (!probe) return;
+    fclose(probe);
+
+    // Static: the line builder plus its deepest path into fmt.c
+    static const char *const chain[] = {"Fmt_UintW", "Field", "Fill", "Put"};
+    uint32_t estimate = Su_Frame(test_su, "One_Line_Fmt") + Su_Frame(test_su, "Line_Fmt");
+    for (uint32_t i = 0; i < sizeof(chain) / sizeof(chain[0]); i++) {
+        estimate += Su_Frame(fmt_su, chain[i]);
+    }
+
+    // Measured: each way on a painted stack, less the cost of getting there
+    paint_stack = malloc(PAINT_SIZE);
+    uint32_t base = Painted_Peak(Nothing);
+    uint32_t peak_printf = Painted_Peak(One_Line_Printf) - base;
+    uint32_t peak_fmt = Painted_Peak(One_Line_Fmt) - base;
+    free(paint_stack);
+
+    CHECKF(peak_fmt <= estimate, "Fmt used %u bytes, -fstack-usage says %u", peak_fmt, estimate);
+    CHECKF(peak_fmt < peak_printf, "Fmt %u bytes, snprintf %u", peak_fmt, peak_printf);
+    printf("fmt: one diag line, stack snprintf %u bytes, Fmt %u bytes (-fstack-usage %u; host libc)\n",
+           peak_printf, peak_fmt, estimate);
+}
+
+#else
+
+static void Stack(const char *exe) {}
+
+#endif
+
+int main(int argc, char **argv) {
+    Test_Seed(0x3C6EF372u);
+    Check_Uint();
+    Check_Int();
+    Check_Hex();
+    Check_Str();
+    Check_Truncation();
+    Check_Lines();
+    Bench();
+    Stack(argv[0]);
+    TEST_END();
+}
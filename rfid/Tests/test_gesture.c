@@ -0,0 +1,166 @@
+/**
+  ******************************************************************************
+  * @file    test_gesture.c
+  * @brief   Trace fixtures for the gesture recognizer.
+  * Each fixture is a touch trace (legs of contact or no contact, sampled every
+  * 10 ms like the main loop) and the GestureEvent sequence it must produce,
+  * with the sample time of each event. Consecutive DRAG events are summed
+  * into one, since how a movement splits across samples is not part of the
+  * contract; their total is.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "gesture.h"
+#include <string.h>
+
+#define SAMPLE_MS   10
+#define MAX_EVENTS  16
+
+/* Samples from the previous leg's end until 'until_ms', moving linearly
+ * from (x0, y0) to (x1, y1); position is ignored without contact */
+typedef struct {
+    uint32_t until_ms;
+    uint8_t pressed;
+    uint16_t x0, y0, x1, y1;
+} Leg;
+
+typedef struct {
+    uint32_t at_ms;
+    GestureEvent ev;
+} Expect;
+
+typedef struct {
+    const char *name;
+    Leg legs[6];
+    Expect want[MAX_EVENTS];
+} Fixture;
+
+#define UP(t)                    { (t), 0, 0, 0, 0, 0 }
+#define HOLD(t, x, y)            { (t), 1, (x), (y), (x), (y) }
+#define MOVE(t, x0, y0, x1, y1)  { (t), 1, (x0), (y0), (x1), (y1) }
+#define EV(t, type, x, y, dx, dy) { (t), { GESTURE_##type, (x), (y), (dx), (dy) } }
+
+static const Fixture fixtures[] = {
+    { "tap",
+      { HOLD(150, 100, 100), UP(300) },
+      { EV(20, DOWN, 100, 100, 0, 0), EV(180, TAP, 100, 100, 0, 0) } },
+
+    { "tap with jitter and a 20 ms dropout",
+      { HOLD(60, 80, 200), HOLD(100, 84, 197), UP(120), HOLD(200, 78, 203), UP(400) },
+      { EV(20, DOWN, 80, 200, 0, 0), EV(230, TAP, 80, 200, 0, 0) } },
+
+    { "bounce shorter than the debounce",
+      { HOLD(20, 50, 50), UP(100), HOLD(110, 60, 60), UP(200) },
+      { { 0 } } },
+
+    { "long-press",
+      { HOLD(1000, 120, 160), UP(1200) },
+      { EV(20, DOWN, 120, 160, 0, 0), EV(620, LONG_PRESS, 120, 160, 0, 0),
+        EV(1030, LONG_END, 120, 160, 0, 0) } },
+
+    { "long-press ignores movement after it fires",
+      { HOLD(700, 120, 160), MOVE(900, 120, 160, 200, 160), UP(1100) },
+      { EV(20, DOWN, 120, 160, 0, 0), EV(620, LONG_PRESS, 120, 160, 0, 0),
+        EV(930, LONG_END, 120, 160, 0, 0) } },
+
+    { "slow drag",
+      { HOLD(100, 50, 50), MOVE(900, 50, 50, 150, 60), HOLD(1000, 150, 60), UP(1200) },
+      { EV(20, DOWN, 50, 50, 0, 0), EV(190, DRAG, 50, 50, 100, 10),
+        EV(1030, DRAG_END, 50, 50, 100, 10) } },
+
+    { "swipe left",
+      { HOLD(40, 200, 160), MOVE(200, 200, 160, 100, 165), UP(400) },
+      { EV(20, DOWN, 200, 160, 0, 0), EV(60, DRAG, 200, 160, -100, 5),
+        EV(230, SWIPE_LEFT, 200, 160, -100, 5) } },
+
+    { "swipe right",
+      { HOLD(40, 40, 100), MOVE(200, 40, 100, 200, 90), UP(400) },
+      { EV(20, DOWN, 40, 100, 0, 0), EV(60, DRAG, 40, 100, 160, -10),
+        EV(230, SWIPE_RIGHT, 40, 100, 160, -10) } },
+
+    { "swipe up",
+      { HOLD(40, 120, 280), MOVE(300, 120, 280, 110, 80), UP(400) },
+      { EV(20, DOWN, 120, 280, 0, 0), EV(60, DRAG, 120, 280, -10, -200),
+        EV(330, SWIPE_UP, 120, 280, -10, -200) } },
+
+    { "swipe down",
+      { HOLD(40, 120, 40), MOVE(140, 120, 40, 125, 200), UP(300) },
+      { EV(20, DOWN, 120, 40, 0, 0), EV(50, DRAG, 120, 40, 5, 160),
+        EV(170, SWIPE_DOWN, 120, 40, 5, 160) } },
+
+    { "fast flick shorter than a swipe",
+      { HOLD(40, 100, 100), MOVE(100, 100, 100, 130, 100), UP(300) },
+      { EV(20, DOWN, 100, 100, 0, 0), EV(60, DRAG, 100, 100, 30, 0),
+        EV(130, DRAG_END, 100, 100, 30, 0) } },
+
+    { "long swipe too slow to count",
+      { HOLD(40, 20, 160), MOVE(600, 20, 160, 220, 160), UP(800) },
+      { EV(20, DOWN, 20, 160, 0, 0), EV(80, DRAG, 20, 160, 200, 0),
+        EV(630, DRAG_END, 20, 160, 200, 0) } },
+};
+
+// --- TRACE PLAYBACK ---
+
+/* Plays a fixture; returns the number of (merged) events in 'got' */
+static int Play(const Fixture *fx, Expect *got) {
+    int n = 0;
+    uint32_t t = 0;
+
+    Gesture_Reset();
+    for (const Leg *leg = fx->legs; leg->until_ms; leg++) {
+        uint32_t from = t;
+        for (; t < leg->until_ms; t += SAMPLE_MS) {
+            uint32_t span = leg->until_ms - SAMPLE_MS - from;
+            uint32_t k = t - from;
+            uint16_t x = (uint16_t)(leg->x0 + (span ? ((int32_t)leg->x1 - leg->x0) * (int32_t)k / (int32_t)span : 0));
+            uint16_t y = (uint16_t)(leg->y0 + (span ? ((int32_t)leg->y1 - leg->y0) * (int32_t)k / (int32_t)span : 0));
+            GestureEvent ev;
+
+            if (!Gesture_Feed(leg->pressed, x, y, t, &ev)) continue;
+            if (ev.type == GESTURE_DRAG && n > 0 && got[n - 1].ev.type == GESTURE_DRAG) {
+                got[n - 1].ev.dx += ev.dx;
+                got[n - 1].ev.dy += ev.dy;
+                continue;
+            }
+            if (n < MAX_EVENTS) {
+                got[n].at_ms = t;
+                got[n].ev = ev;
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+static void Check_Fixture(const Fixture *fx) {
+    Expect got[MAX_EVENTS];
+    int want_n = 0;
+    int n = Play(fx, got);
+
+    while (want_n < MAX_EVENTS && fx->want[want_n].ev.type != GESTURE_NONE) want_n++;
+    CHECKF(n == want_n, "%s: %d events, want %d", fx->name, n, want_n);
+
+    for (int i = 0; i < n && i < want_n; i++) {
+        const Expect *w = &fx->want[i];
+        const Expect *g = &got[i];
+        CHECKF(g->at_ms == w->at_ms && !memcmp(&g->ev, &w->ev, sizeof(g->ev)),
+               "%s: event %d is type %d at %u ms (%u,%u %+d,%+d), want type %d at %u ms (%u,%u %+d,%+d)",
+               fx->name, i, g->ev.type, (unsigned)g->at_ms, g->ev.x, g->ev.y, g->ev.dx, g->ev.dy,
+               w->ev.type, (unsigned)w->at_ms, w->ev.x, w->ev.y, w->ev.dx, w->ev.dy);
+    }
+
+    // A press ends with exactly one release event, and it is the last one
+    int releases = 0;
+    for (int i = 0; i < n; i++) releases += Gesture_IsRelease(got[i].ev.type);
+    int pressed = n > 0 && got[0].ev.type == GESTURE_DOWN;
+    CHECKF(releases == pressed, "%s: %d release events", fx->name, releases);
+    if (pressed) CHECKF(Gesture_IsRelease(got[n - 1].ev.type), "%s: no release at the end", fx->name);
+}
+
+int main(void) {
+    for (unsigned i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+        Check_Fixture(&fixtures[i]);
+    }
+    TEST_END();
+}
@@ -0,0 +1,313 @@
+/**
+  ******************************************************************************
+  * @file    test_layout.c
+  * @brief   Host test of the precompiled page layouts.
+  * Draws the static part of every page twice into a stub ILI9341: once as
+  * the pages did before the layout tables (run-time centering, one
+  * transaction per button) and once with Layout_Draw() on the tables of
+  * page_layouts.c. The two frames must match pixel for pixel, the tables
+  * must cost no more on the link, and the per-page SPI bytes, address
+  * windows and CS transactions of both are reported.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "page_layouts.h"
+#include "ui.h"
+#include "gfx.h"
+#include "clocks.h"
+#include <string.h>
+
+// --- STUB PANEL ---
+// Counts what the real driver would put on SPI1 (ili9341.c): a window is
+// 11 bytes of commands, a pixel 2 bytes. Outside LCD_Select() every command
+// and data byte of a window toggles CS on its own.
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t windows;
+    uint32_t cs;       // CS low periods
+} LinkCost;
+
+static uint16_t fb[ILI9341_HEIGHT][ILI9341_WIDTH];
+static LinkCost link;
+static uint16_t win_x0, win_x1, win_y0, win_y1, cur_x, cur_y;
+static uint8_t depth;
+
+void LCD_SetAddress(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    link.windows++;
+    link.bytes += 11;
+    if (depth == 0) link.cs += 11;
+    win_x0 = cur_x = x1;
+    win_y0 = cur_y = y1;
+    win_x1 = x2;
+    win_y1 = y2;
+}
+
+static void Put(uint16_t color) {
+    if (cur_x < ILI9341_WIDTH && cur_y < ILI9341_HEIGHT) fb[cur_y][cur_x] = color;
+    if (++cur_x > win_x1) {
+        cur_x = win_x0;
+        if (++cur_y > win_y1) cur_y = win_y0;
+    }
+}
+
+void LCD_PushColor(uint16_t color, uint32_t count) {
+    if (count == 0) return;
+    link.bytes += 2 * count;
+    if (depth == 0) link.cs++;
+    while (count--) Put(color);
+}
+
+void LCD_WriteData16(uint16_t data) {
+    link.bytes += 2;
+    if (depth == 0) link.cs++;
+    Put(data);
+}
+
+void LCD_Select(void) {
+    if (depth++ == 0) link.cs++;
+}
+
+void LCD_Deselect(void) {
+    if (depth > 0) depth--;
+}
+
+void LCD_DrawPixel(uint16_t x, uint16_t y, uint16_t color) {
+    if (x >= ILI9341_WIDTH || y >= ILI9341_HEIGHT) return;
+    LCD_SetAddress(x, y, x, y);
+    LCD_WriteData16(color);
+}
+
+void LCD_FillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    if ((x + w) > ILI9341_WIDTH) w = ILI9341_WIDTH - x;
+    if ((y + h) > ILI9341_HEIGHT) h = ILI9341_HEIGHT - y;
+    if (w == 0 || h == 0) return;
+    LCD_SetAddress(x, y, x + w - 1, y + h - 1);
+    LCD_PushColor(color, (uint32_t)w * h);
+}
+
+// --- PAGES BEFORE THE TABLES ---
+// The static calls of UI_Refresh and Draw_Keyboard_Static as they were
+
+typedef struct {
+    uint16_t x, y, width, height;
+} Btn;
+
+static void Old_Button(Btn b, const char *text, uint8_t is_alert) {
+    uint16_t color = is_alert ? COLOR_ALERT : COLOR_TERM_DIM;
+    uint16_t text_color = is_alert ? COLOR_ALERT : COLOR_TERM_TEXT;
+    char buf[30];
+
+    Gfx_Begin();
+    Gfx_Rect(b.x, b.y, b.width, b.height, color);
+    Gfx_FillRect(b.x, b.y, 5, 5, color);
+    Gfx_FillRect(b.x + b.width - 5, b.y + b.height - 5, 5, 5, color);
+    if (strlen(text) > 0) sprintf(buf, "%s", text);
+    else sprintf(buf, "---");
+    uint16_t text_len = strlen(buf) * 7;
+    uint16_t x_pos = b.x + (b.width - text_len) / 2;
+    uint16_t y_pos = b.y + (b.height - 10) / 2;
+    LCD_WriteString(buf, x_pos, y_pos, Font_7x10, text_color, COLOR_TERM_BG);
+    Gfx_End();
+}
+
+static void Old_Title(const char *title, uint16_t color) {
+    LCD_WriteString(title, 5, 10, Font_7x10, color, BLACK);
+    LCD_FillRect(0, 25, 240, 1, color);
+}
+
+static void Old_Main(void) {
+    Old_Title("// ROOT_ACCESS", COLOR_TERM_DIM);
+    Old_Button((Btn){BTN_TX}, "> EXECUTE_PAYLOAD", 0);
+    Old_Button((Btn){BTN_RX}, "> SNIFF_TRAFFIC", 0);
+    Old_Button((Btn){BTN_CAL}, "> CALIBRATE_TOUCH", 0);
+    Old_Button((Btn){BTN_DIAG}, "> DIAGNOSTICS", 0);
+}
+
+static void Old_List(void) {
+    LCD_FillRect(0, 25, 240, 1, COLOR_TERM_DIM);
+    Old_Button((Btn){BTN_LIST_HOME}, "< HOME", 1);
+    Old_Button((Btn){BTN_LIST_JUMP}, "A-Z", 0);
+    Old_Button((Btn){BTN_LIST_PLAY}, "PLAY", 0);
+}
+
+static void Old_Options(void) {
+    Old_Title("// SIGNAL OPT.", COLOR_TERM_DIM);
+    LCD_WriteString("SELECTED:", 88, 35, Font_7x10, COLOR_TERM_DIM, BLACK);
+    Old_Button((Btn){BTN_OPT_TX}, "TRANSMIT", 0);
+    Old_Button((Btn){BTN_OPT_RENAME}, "RENAME", 0);
+    Old_Button((Btn){BTN_OPT_DEL}, "DELETE", 1);
+    Old_Button((Btn){BTN_OPT_BACK}, "< BACK", 0);
+}
+
+static void Old_Confirm_Delete(void) {
+    Old_Title("// WARNING", COLOR_ALERT);
+    LCD_WriteString("CONFIRM DELETE?", 67, 50, Font_7x10, COLOR_TERM_TEXT, BLACK);
+    Old_Button((Btn){BTN_CONF_NO}, "NO", 1);
+    Old_Button((Btn){BTN_CONF_YES}, "YES", 0);
+}
+
+static const char *const kb_rows[5] = {"abcde", "fghij", "klmno", "pqrst", "uvwxy"};
+
+static void Old_Keyboard(void) {
+    Gfx_Rect(10, 25, 220, 30, COLOR_TERM_TEXT);
+    for (int row = 0; row < 5; row++) {
+        for (int col = 0; col < 5; col++) {
+            uint16_t x = 10 + (col * (40 + 5));
+            uint16_t y = 65 + (row * (35 + 5));
+            char s[2] = {kb_rows[row][col], '\0'};
+            Gfx_Begin();
+            Gfx_Rect(x, y, 40, 35, COLOR_TERM_DIM);
+            LCD_WriteString(s, x + 15, y + 10, Font_7x10, COLOR_TERM_TEXT, BLACK);
+            Gfx_End();
+        }
+    }
+    Old_Button((Btn){BTN_KB_SPACE}, "_", 0);
+    Old_Button((Btn){BTN_KB_DEL}, "DEL", 1);
+    Old_Button((Btn){BTN_KB_DONE}, "OK", 0);
+}
+
+static void Old_Transmitting(void) {
+    Old_Title("// TRANSMITTING", COLOR_TERM_TEXT);
+    LCD_WriteString("SENDING:", 92, 80, Font_7x10, COLOR_TERM_DIM, BLACK);
+    Old_Button((Btn){BTN_STOP}, "[ STOP SIGNAL ]", 1);
+}
+
+static void Old_Writing(void) {
+    Old_Title("// CLONE_T5577", COLOR_TERM_TEXT);
+    LCD_WriteString("HOLD BLANK ON COIL:", 54, 60, Font_7x10, COLOR_TERM_DIM, BLACK);
+    Old_Button((Btn){BTN_STOP}, "[ CLOSE ]", 1);
+}
+
+static void Old_Rx_Sensing(void) {
+    Old_Title("// SNIFFER_ACTIVE", COLOR_ALERT);
+    LCD_WriteString("WAITING FOR SIGNAL...", 20, 100, Font_7x10, COLOR_TERM_TEXT, BLACK);
+    Old_Button((Btn){BTN_BACK}, "< STOP", 1);
+}
+
+static void Old_Calibrate(void) {
+    Old_Title("// TOUCH_CALIBRATION", COLOR_TERM_DIM);
+}
+
+static void Old_Diag(void) {
+    Old_Title("// DIAGNOSTICS", COLOR_TERM_DIM);
+    Old_Button((Btn){BTN_BACK}, "< BACK", 0);
+}
+
+/* Draw_Keyboard_Static after the tables: the labels are the page's part */
+static void New_Keyboard_Labels(void) {
+    Gfx_Begin();
+    for (int row = 0; row < 5; row++) {
+        for (int col = 0; col < 5; col++) {
+            char s[2] = {kb_rows[row][col], '\0'};
+            LCD_WriteString(s, KB_KEY_X(col) + 15, KB_KEY_Y(row) + 10, Font_7x10, COLOR_TERM_TEXT, BLACK);
+        }
+    }
+    Gfx_End();
+}
+
+typedef struct {
+    const char *name;
+    void (*before)(void);
+    const LayoutCmd *table;
+    void (*after_extra)(void);   // Static part the page code still draws itself
+} Page;
+
+static const Page pages[] = {
+    {"MAIN", Old_Main, layout_main, NULL},
+    {"LIST", Old_List, layout_list, NULL},
+    {"OPTIONS", Old_Options, layout_options, NULL},
+    {"CONFIRM", Old_Confirm_Delete, layout_confirm_delete, NULL},
+    {"KEYBOARD", Old_Keyboard, layout_keyboard, New_Keyboard_Labels},
+    {"TRANSMIT", Old_Transmitting, layout_transmitting, NULL},
+    {"WRITING", Old_Writing, layout_writing, NULL},
+    {"SNIFFER", Old_Rx_Sensing, layout_rx_sensing, NULL},
+    {"CALIBRATE", Old_Calibrate, layout_calibrate, NULL},
+    {"DIAG", Old_Diag, layout_diag, NULL},
+};
+#define PAGE_COUNT (sizeof(pages) / sizeof(pages[0]))
+
+static uint16_t fb_before[ILI9341_HEIGHT][ILI9341_WIDTH];
+
+static void Clear(void) {
+    memset(fb, 0, sizeof(fb)); // COLOR_TERM_BG, as after the page clear
+    memset(&link, 0, sizeof(link));
+    depth = 0;
+}
+
+/* Microseconds on the link at the CLOCK_FULL SPI1 rate */
+static double Link_Us(const LinkCost *c, uint32_t sck_hz) {
+    return (double)c->bytes * 8.0 * 1e6 / sck_hz;
+}
+
+// --- TESTS ---
+
+static void Check_Pages(void) {
+    ClockTree tree;
+    Clock_Derive(Clock_Profile(CLOCK_FULL), &tree);
+    uint32_t sck_hz = tree.pclk2 / (2u << tree.lcd_br);
+    LinkCost total_before = {0}, total_after = {0};
+
+    printf("layout: static part per page, before -> after (SPI1 at %u kHz)\n", sck_hz / 1000u);
+    printf("  %-10s %15s %11s %13s %15s\n", "PAGE", "BYTES", "WINDOWS", "CS", "LINK US");
+    for (uint32_t i = 0; i < PAGE_COUNT; i++) {
+        const Page *p = &pages[i];
+
+        Clear();
+        p->before();
+        LinkCost before = link;
+        memcpy(fb_before, fb, sizeof(fb));
+        CHECKF(depth == 0, "%s: unbalanced select before", p->name);
+
+        Clear();
+        Layout_Draw(p->table);
+        if (p->after_extra) p->after_extra();
+        LinkCost after = link;
+        CHECKF(depth == 0, "%s: unbalanced select after", p->name);
+
+        // Same pixels, and the table replay is never the dearer path
+        CHECKF(memcmp(fb_before, fb, sizeof(fb)) == 0, "%s: frames differ", p->name);
+        CHECKF(after.bytes <= before.bytes, "%s: %u > %u bytes", p->name, after.bytes, before.bytes);
+        CHECKF(after.windows <= before.windows, "%s: %u > %u windows", p->name, after.windows,
+               before.windows);
+        CHECKF(after.cs <= before.cs, "%s: %u > %u CS", p->name, after.cs, before.cs);
+
+        printf("  %-10s %6u -> %6u %4u -> %4u %5u -> %5u %6.0f -> %6.0f\n", p->name,
+               before.bytes, after.bytes, before.windows, after.windows, before.cs, after.cs,
+               Link_Us(&before, sck_hz), Link_Us(&after, sck_hz));
+        total_before.bytes += before.bytes;
+        total_before.windows += before.windows;
+        total_before.cs += before.cs;
+        total_after.bytes += after.bytes;
+        total_after.windows += after.windows;
+        total_after.cs += after.cs;
+    }
+    printf("  %-10s %6u -> %6u %4u -> %4u %5u -> %5u\n", "ALL", total_before.bytes,
+           total_after.bytes, total_before.windows, total_after.windows, total_before.cs,
+           total_after.cs);
+    // What every full redraw costs before any of it: the page clear
+    printf("layout: page clear %u bytes (%.0f us)\n", 2u * ILI9341_WIDTH * ILI9341_HEIGHT,
+           2.0 * ILI9341_WIDTH * ILI9341_HEIGHT * 8.0 * 1e6 / sck_hz);
+}
+
+/* Button labels in the tables sit where the run-time formula put them */
+static void Check_Centering(void) {
+    const LayoutCmd *tables[] = {layout_main, layout_list, layout_options, layout_confirm_delete,
+                                 layout_keyboard, layout_transmitting, layout_writing,
+                                 layout_rx_sensing, layout_calibrate, layout_diag};
+    for (uint32_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+        for (const LayoutCmd *c = tables[t]; c->op != LAYOUT_END; c++) {
+            if (c->op != LAYOUT_BUTTON) continue;
+            uint16_t text_len = strlen(c->text) * LAYOUT_CHAR_W;
+            CHECKF(c->tx == (uint16_t)(c->x + (c->w - text_len) / 2), "'%s' at %u", c->text, c->tx);
+            CHECKF(c->ty == c->y + (c->h - LAYOUT_CHAR_H) / 2, "'%s' at row %u", c->text, c->ty);
+        }
+    }
+}
+
+int main(void) {
+    Check_Pages();
+    Check_Centering();
+    TEST_END();
+}
@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    test_playlist.c
+  * @brief   Playlist timeline concatenation against a reference expansion.
+  * Random timelines (either first level, runs up to the timer limit) are
+  * queued with every repeat count and gap; the reference writes out each
+  * pass and gap in order, wraps the list, and merges equal neighbouring
+  * levels. Playlist_Next() must hand out exactly that run sequence over
+  * several wraps, starting at the level Playlist_Rewind() reports, with the
+  * cursor and wrap counter tracking it. Unusable timelines, a full list,
+  * an empty list and the schedule limits are checked on their own.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "playlist.h"
+#include <string.h>
+
+#define LOOPS      3
+#define MAX_RUNS   24
+#define MAX_PIECES (LOOPS * PLAYLIST_MAX * (8 * MAX_RUNS + 1) + 1)
+#define GAP_TICKS(ms) ((uint32_t)(ms) * 125 * WAVE_TICKS_PER_CYCLE)
+
+static uint16_t arrs[PLAYLIST_MAX][MAX_RUNS];
+static WaveTimeline timelines[PLAYLIST_MAX];
+
+static void Make_Timelines(uint8_t count) {
+    for (uint8_t t = 0; t < count; t++) {
+        timelines[t].runs = (uint16_t)(2 + 2 * (Rand() % (MAX_RUNS / 2)));
+        timelines[t].first_level = Rand() & 1;
+        timelines[t].arr = arrs[t];
+        for (uint16_t i = 0; i < timelines[t].runs; i++) {
+            // Mostly carrier-scale runs, now and then one near the timer limit
+            arrs[t][i] = (Rand() % 8) ? (uint16_t)(15 + Rand() % 500) : (uint16_t)(0xF000 + Rand() % 0x1000);
+        }
+    }
+}
+
+// --- REFERENCE ---
+
+static uint8_t ref_level[MAX_PIECES];
+static uint32_t ref_ticks[MAX_PIECES];
+
+/* Every piece of LOOPS wraps in order, equal levels merged; returns runs */
+static uint32_t Expand(uint8_t count, uint8_t repeats, uint32_t gap_ticks) {
+    uint32_t n = 0;
+
+    for (uint8_t loop = 0; loop < LOOPS; loop++) {
+        for (uint8_t t = 0; t < count; t++) {
+            const WaveTimeline *tl = &timelines[t];
+            for (uint16_t k = 0; k < repeats * tl->runs + (gap_ticks ? 1 : 0); k++) {
+                uint8_t level = (k < repeats * tl->runs) ? tl->first_level ^ (k & 1u) : 1;
+                uint32_t ticks = (k < repeats * tl->runs) ? tl->arr[k % tl->runs] + 1u : gap_ticks;
+                if (n && ref_level[n - 1] == level) {
+                    ref_ticks[n - 1] += ticks;
+                } else {
+                    ref_level[n] = level;
+                    ref_ticks[n++] = ticks;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+// --- CHECKS ---
+
+static void Check_Sequence(uint8_t count, uint8_t repeats, uint16_t gap_ms) {
+    Playlist pl;
+    uint32_t wraps = 0;
+
+    Make_Timelines(count);
+    Playlist_Init(&pl, repeats, gap_ms);
+    for (uint8_t t = 0; t < count; t++) CHECK(Playlist_Add(&pl, &timelines[t], (uint8_t)(100 + t)));
+    CHECK(pl.count == count && pl.ids[count - 1] == 100 + count - 1);
+
+    // The last merged run may still grow into the next wrap: not compared
+    uint32_t n = Expand(count, repeats, GAP_TICKS(gap_ms)) - 1;
+    uint8_t level = Playlist_Rewind(&pl);
+    CHECKF(level == ref_level[0], "%u items x%u gap %u: first level %u", count, repeats, gap_ms, level);
+
+    uint32_t bad = n;
+    for (uint32_t i = 0; i < n && bad == n; i++) {
+        uint16_t want = (ref_ticks[i] > 0x10000) ? 0xFFFF : (uint16_t)(ref_ticks[i] - 1);
+        if (Playlist_Next(&pl) != want) bad = i;
+        // The cursor is one piece ahead: never past the list, wraps one at a time
+        if (pl.item >= count || pl.pass >= pl.repeats || pl.loops > wraps + 1) bad = i;
+        wraps = pl.loops;
+    }
+    CHECKF(bad == n, "%u items x%u gap %u: run %u of %u differs", count, repeats, gap_ms,
+           (unsigned)bad, (unsigned)n);
+    CHECKF(wraps == LOOPS - 1 || wraps == LOOPS, "%u items x%u gap %u: %u wraps",
+           count, repeats, gap_ms, (unsigned)wraps);
+}
+
+static void Check_Limits(void) {
+    Playlist pl;
+    uint16_t arr[3] = { 100, 100, 100 };
+    WaveTimeline odd = { arr, 3, 0 }, single = { arr, 1, 0 }, ok = { arr, 2, 0 };
+
+    // Schedule limits
+    Playlist_Init(&pl, 0, 1000);
+    CHECK(pl.repeats == 1);
+    CHECK(pl.gap_ticks == GAP_TICKS(PLAYLIST_GAP_MAX_MS) && pl.gap_ticks <= 0x10000);
+
+    // Empty: an unloaded field forever
+    CHECK(Playlist_Rewind(&pl) == 1);
+    CHECK(Playlist_Next(&pl) == 0xFFFF);
+
+    // Timelines must alternate back to their first level; the list has a size
+    CHECK(!Playlist_Add(&pl, &odd, 0));
+    CHECK(!Playlist_Add(&pl, &single, 0));
+    for (uint8_t i = 0; i < PLAYLIST_MAX; i++) CHECK(Playlist_Add(&pl, &ok, i));
+    CHECK(!Playlist_Add(&pl, &ok, PLAYLIST_MAX));
+    CHECK(pl.count == PLAYLIST_MAX);
+
+    // A lone timeline with no gap joins onto itself: plain alternation
+    Playlist_Init(&pl, 2, 0);
+    Playlist_Add(&pl, &ok, 0);
+    CHECK(Playlist_Rewind(&pl) == 0);
+    for (int i = 0; i < 10; i++) CHECK(Playlist_Next(&pl) == 100);
+}
+
+int main(void) {
+    Test_Seed(0x27D4EB2Fu);
+    static const uint16_t gaps[] = { 0, 1, 50, 250 };
+
+    for (uint8_t count = 1; count <= PLAYLIST_MAX; count = (uint8_t)(count * 2 + 1)) {
+        for (uint8_t repeats = 1; repeats <= 8; repeats = (uint8_t)(repeats * 2 + 1)) {
+            for (unsigned g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++) {
+                Check_Sequence(count, repeats, gaps[g]);
+            }
+        }
+    }
+    Check_Sequence(PLAYLIST_MAX, 8, 250);
+    Check_Limits();
+    TEST_END();
+}
@@ -0,0 +1,302 @@
+/**
+  ******************************************************************************
+  * @file    test_protocols.c
+  * @brief   Protocol corpus through the receive path, and time to first read.
+  * Card IDs (H10301, H10304, EM4100, Indala) are encoded with the protocol
+  * table, modulated into one envelope sample per carrier cycle with noise,
+  * and run through the front end's DSP chain and run tracking into the
+  * decoder, starting anywhere in the frame. Every card must read back as the
+  * same ID; the time to the first valid read is reported. Indala (PSK at
+  * RF/2, below RF_MIN_SUBCARRIER) is received at full rate, as the sniffer
+  * does once the classifier reports PSK, and the other cards must read at
+  * full rate too (the classifier's window is replayed from it). Frames that
+  * break parity, a field with no tag, and Indala behind the decimator must
+  * give no read.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "dsp.h"
+#include "lf_protocols.h"
+#include "rf_frontend.h"
+#include <string.h>
+
+// Same chain settings as rf_frontend.c
+#define DC_SHIFT        10
+#define SLICE_DECAY     1
+#define SLICE_MIN_SPAN  24
+
+#define TRIALS      40
+#define SWING_GOOD  120   // ADC codes of load modulation (half depth)
+#define SWING_WEAK  50
+#define LIMIT_MS    400   // Give up on a card after this long in the field
+#define CYCLES_MS   (RF_CARRIER_HZ / 1000)
+
+// --- CARD IDS ---
+
+static void Put_Bits(LfFrame *f, uint64_t v, uint8_t n) {
+    while (n--) LF_Frame_PutBit(f, (v >> n) & 1u);
+}
+
+static uint8_t Parity(uint64_t v, uint8_t from, uint8_t to) {
+    uint8_t p = 0;
+    for (uint8_t i = from; i <= to; i++) p ^= (v >> i) & 1u;
+    return p;
+}
+
+/* H10301: even parity, 8-bit facility, 16-bit card number, odd parity */
+static LfFrame H10301(uint8_t facility, uint16_t card) {
+    LfFrame f = { 0 };
+    uint64_t v = ((uint64_t)facility << 17) | ((uint64_t)card << 1);
+    v |= (uint64_t)Parity(v, 13, 24) << 25;
+    v |= !Parity(v, 1, 12);
+    Put_Bits(&f, v, 26);
+    return f;
+}
+
+/* H10304: even parity, 16-bit facility, 19-bit card number, odd parity */
+static LfFrame H10304(uint16_t facility, uint32_t card) {
+    LfFrame f = { 0 };
+    uint64_t v = ((uint64_t)facility << 20) | ((uint64_t)(card & 0x7FFFF) << 1);
+    v |= (uint64_t)Parity(v, 18, 35) << 36;
+    v |= !Parity(v, 1, 18);
+    Put_Bits(&f, v, 37);
+    return f;
+}
+
+/* EM4100: 8-bit version / customer, 32-bit ID */
+static LfFrame Em4100(uint8_t version, uint32_t id) {
+    LfFrame f = { 0 };
+    Put_Bits(&f, ((uint64_t)version << 32) | id, 40);
+    return f;
+}
+
+// --- TAG MODEL ---
+
+typedef struct {
+    const LfProtocol *p;
+    uint8_t bits[LF_MAX_FRAME_BITS];
+    uint8_t n;
+    uint32_t t;             // Carrier cycle within the repeated frame
+    uint32_t phase;         // FSK: subcarrier phase, in 1/40 cycles (LCM of the periods)
+} Tag;
+
+/* Load state (1 = high envelope) for the next carrier cycle */
+static uint8_t Tag_Level(Tag *tag) {
+    const LfProtocol *p = tag->p;
+    uint32_t in_bit = tag->t % p->bit_cycles;
+    uint8_t b = tag->bits[(tag->t / p->bit_cycles) % tag->n];
+    uint8_t level;
+
+    tag->t++;
+    switch (p->modulation) {
+        case LF_MOD_ASK_MANCHESTER: // 1 = high-to-low
+            return (in_bit < p->bit_cycles / 2u) ? b : !b;
+        case LF_MOD_FSK: { // Continuous phase across bit changes
+            uint32_t period = b ? p->sub_b : p->sub_a;
+            level = tag->phase < 20;
+            tag->phase = (tag->phase + 40 / period) % 40;
+            return level;
+        }
+        default: // PSK1: the subcarrier phase is the bit value
+            return ((tag->t % p->sub_a) < p->sub_a / 2u) ^ b;
+    }
+}
+
+/* Reader side: envelope ADC codes around the field's DC level */
+typedef struct {
+    int16_t dc;
+    int16_t swing;          // Half the load modulation depth; 0 = no tag
+    int16_t noise;          // Uniform, +-
+} Field;
+
+static int16_t Sample(const Field *fld, Tag *tag) {
+    int16_t v = fld->dc + (int16_t)(Rand() % (2u * fld->noise + 1)) - fld->noise;
+    if (tag) v += Tag_Level(tag) ? fld->swing : -fld->swing;
+    return v;
+}
+
+// --- RECEIVE PATH ---
+
+/* Runs the field through the chain (as the DMA ISR) and the decoder (as the
+   main loop) until a frame validates or 'limit_ms' passes; returns 1 on a read */
+static uint8_t Receive(const Field *fld, Tag *tag, uint8_t full_rate, uint32_t limit_ms, LfFrame *out) {
+    static int16_t block[RF_BLOCK] __attribute__((aligned(4)));
+    DspDcBlock dc;
+    DspDecimator dec;
+    DspSlicer sl;
+    const DspStage chain[] = { { Dsp_DcBlock, &dc }, { Dsp_Decimate, &dec }, { Dsp_Slice, &sl } };
+    const DspStage chain_full_rate[] = { { Dsp_DcBlock, &dc }, { Dsp_Slice, &sl } };
+    const uint32_t cycles_per_sample = full_rate ? 1u : 1u << RF_DECIM_LOG2;
+    int16_t run_level = DSP_SLICE_LOW;
+    uint32_t run_cycles = 0;
+    uint8_t seeded = 0;
+
+    Dsp_Decimator_Init(&dec, RF_DECIM_LOG2);
+    Dsp_Slicer_Init(&sl, SLICE_DECAY, SLICE_MIN_SPAN);
+    LF_Decoder_Reset();
+    for (uint32_t t = 0; t < limit_ms * CYCLES_MS; t += RF_BLOCK) {
+        int32_t sum = 0;
+        for (uint16_t i = 0; i < RF_BLOCK; i++) sum += block[i] = Sample(fld, tag);
+        if (!seeded) {
+            Dsp_DcBlock_Init(&dc, DC_SHIFT, (int16_t)(sum / RF_BLOCK));
+            seeded = 1;
+        }
+
+        // Track_Runs, feeding each run as the main loop would read it
+        uint16_t n = full_rate ? Dsp_Run(chain_full_rate, 2, block, RF_BLOCK)
+                               : Dsp_Run(chain, 3, block, RF_BLOCK);
+        for (uint16_t i = 0; i < n; i++) {
+            uint8_t got = 0;
+            if (block[i] != run_level) {
+                got = LF_Decoder_Feed(run_level > 0, (uint16_t)run_cycles, out);
+                run_level = block[i];
+                run_cycles = 0;
+            }
+            run_cycles += cycles_per_sample;
+            if (run_cycles >= RF_EDGE_CYCLES) {
+                got |= LF_Decoder_Feed(run_level > 0, RF_EDGE_CYCLES, out);
+                run_cycles -= RF_EDGE_CYCLES;
+            }
+            if (got) return 1;
+        }
+    }
+    return 0;
+}
+
+static Tag Tag_Make(const LfProtocol *p, const LfFrame *id) {
+    Tag tag = { p, { 0 }, 0, 0, 0 };
+    tag.n = p->encode(id, tag.bits);
+    tag.t = Rand() % (tag.n * p->bit_cycles); // Card enters the field mid-frame
+    tag.phase = Rand() % 40;
+    return tag;
+}
+
+/* 'swing' and up to 50% more, noise +-20 codes */
+static Field Field_Make(int16_t swing) {
+    Field fld = { (int16_t)(1900 + Rand() % 300), (int16_t)(swing + Rand() % (swing / 2 + 1)), 20 };
+    return fld;
+}
+
+// --- CORPUS ---
+
+typedef enum { CARD_H10301, CARD_H10304, CARD_EM4100, CARD_INDALA, CARD_KINDS } Card;
+static const char *card_names[CARD_KINDS] = { "H10301", "H10304", "EM4100", "INDALA" };
+
+/* Indala: a 31-bit ID after the 33-bit preamble, no parity */
+static LfFrame Indala(uint32_t id) {
+    LfFrame f = { 0 };
+    Put_Bits(&f, id & 0x7FFFFFFFu, 31);
+    return f;
+}
+
+static LfFrame Card_Id(Card c, const LfProtocol **p) {
+    switch (c) {
+        case CARD_H10301:
+            *p = LF_Protocol_Find(LF_PROTO_HID);
+            return H10301((uint8_t)Rand(), (uint16_t)Rand());
+        case CARD_H10304:
+            *p = LF_Protocol_Find(LF_PROTO_HID);
+            return H10304((uint16_t)Rand(), Rand());
+        case CARD_EM4100:
+            *p = LF_Protocol_Find(LF_PROTO_EM4100);
+            return Em4100((uint8_t)Rand(), Rand());
+        default:
+            *p = LF_Protocol_Find(LF_PROTO_INDALA);
+            return Indala(Rand());
+    }
+}
+
+/* A good coupling must read every card within two frames (three when the
+   frame must repeat); a weak one may miss cards but must never report a
+   wrong ID */
+static void Check_Corpus(Card c, int16_t swing, uint8_t full_rate, uint8_t weak) {
+    uint32_t reads = 0, wrong = 0, best = UINT32_MAX, worst = 0;
+    uint64_t total = 0;
+    uint32_t frame_cycles = 0, frames = 2;
+
+    for (int trial = 0; trial < TRIALS; trial++) {
+        const LfProtocol *p;
+        LfFrame id = Card_Id(c, &p), got;
+        Tag tag = Tag_Make(p, &id);
+        Field fld = Field_Make(swing);
+
+        frame_cycles = tag.n * p->bit_cycles;
+        frames = (p->flags & LF_FLAG_REPEAT) ? 3 : 2;
+        if (!Receive(&fld, &tag, full_rate, LIMIT_MS, &got)) continue;
+        reads++;
+        if (got.protocol != p->id || got.bit_len != id.bit_len ||
+            memcmp(got.data, id.data, sizeof(id.data))) {
+            wrong++;
+            continue;
+        }
+        total += got.cycles;
+        if (got.cycles < best) best = got.cycles;
+        if (got.cycles > worst) worst = got.cycles;
+    }
+    CHECKF(wrong == 0, "%s swing %d: %u wrong IDs", card_names[c], swing, (unsigned)wrong);
+    if (!weak) {
+        CHECKF(reads == TRIALS, "%s%s: %u of %u cards read", card_names[c], full_rate ? " full rate" : "",
+               (unsigned)reads, TRIALS);
+        // Wherever the card starts: the rest of one frame, the whole frames the
+        // decoder needs, and the first block that seeds the DC tracker
+        CHECKF(worst <= frames * frame_cycles + RF_BLOCK, "%s: first read after %u cycles, frame is %u",
+               card_names[c], (unsigned)worst, (unsigned)frame_cycles);
+    }
+    if (reads > wrong) {
+        printf("protocols: %-7s %s swing %3d: %2u/%u read, first valid read %5.1f ms min, %5.1f mean, "
+               "%5.1f max (frame %.1f ms)\n", card_names[c], full_rate ? "full" : "decim", swing,
+               (unsigned)(reads - wrong), TRIALS, (double)best / CYCLES_MS,
+               (double)total / (reads - wrong) / CYCLES_MS, (double)worst / CYCLES_MS,
+               (double)frame_cycles / CYCLES_MS);
+    }
+}
+
+// --- NO READ ---
+
+/* One raw bit flipped (a parity error the preamble check lets through) */
+static void Check_Corrupted(Card c, uint8_t bit) {
+    const LfProtocol *p;
+    LfFrame id = Card_Id(c, &p), got;
+    Tag tag = Tag_Make(p, &id);
+    Field fld = Field_Make(SWING_GOOD);
+
+    tag.bits[bit] ^= 1;
+    if (p->id == LF_PROTO_HID) tag.bits[bit ^ 1] ^= 1; // Keep the Manchester pair valid
+    CHECKF(!Receive(&fld, &tag, 0, LIMIT_MS, &got), "%s with raw bit %u flipped read as %s",
+           card_names[c], bit, LF_Protocol_Name(got.protocol));
+}
+
+static void Check_No_Tag(void) {
+    LfFrame got;
+    Field fld = { 2048, 0, 20 };
+    CHECK(!Receive(&fld, NULL, 0, 1000, &got));
+    CHECK(!Receive(&fld, NULL, 1, 1000, &got));
+}
+
+/* Why the sniffer leaves the decimator out for PSK: RF/2 averages away */
+static void Check_Indala_Decimated(void) {
+    const LfProtocol *p;
+    LfFrame id = Card_Id(CARD_INDALA, &p), got;
+    Tag tag = Tag_Make(p, &id);
+    Field fld = Field_Make(SWING_GOOD);
+
+    CHECK(p->sub_a < RF_MIN_SUBCARRIER);
+    CHECK(!Receive(&fld, &tag, 0, LIMIT_MS, &got));
+}
+
+int main(void) {
+    Test_Seed(0x6C078965u);
+    for (int c = 0; c < CARD_KINDS; c++) {
+        uint8_t psk = (c == CARD_INDALA); // Below RF_MIN_SUBCARRIER: full rate only
+        Check_Corpus(c, SWING_GOOD, psk, 0);
+        Check_Corpus(c, SWING_WEAK, psk, 1);
+        if (!psk) Check_Corpus(c, SWING_GOOD, 1, 0);
+    }
+    for (uint8_t bit = 10; bit < 60; bit += 7) Check_Corrupted(CARD_EM4100, bit);
+    for (uint8_t bit = 44; bit < 96; bit += 10) Check_Corrupted(CARD_H10301, bit); // Card data and parity
+    for (uint8_t bit = 24; bit < 96; bit += 10) Check_Corrupted(CARD_H10304, bit);
+    Check_No_Tag();
+    Check_Indala_Decimated();
+    TEST_END();
+}
@@ -0,0 +1,371 @@
+/**
+  ******************************************************************************
+  * @file    test_rawcap.c
+  * @brief   Raw edge-timing capture: round trip, size and replay timing.
+  * Synthetic fobs (EM4100 ASK, HID FSK, EM4100 with edge jitter, and runs of
+  * random width) are turned into edge times, moved onto the front end's
+  * 2-cycle grid and fed to Rawcap_Feed() after an idle field. Rawcap_Next()
+  * must give back exactly the runs that were fed, the capture must end on
+  * its window, a full buffer or the tag leaving, and the bytes per run are
+  * reported and bounded. Truncated blobs must read as a prefix of the
+  * capture and malformed ones must stop cleanly (make rawcap-asan checks
+  * that no read goes past the blob). Finally the blob goes through
+  * Wave_Build() as a raw payload: the emulation timeline must hold the same
+  * runs, and its edges are compared with the fob's ideal edges.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "rawcap.h"
+#include "payload.h"
+#include "wavecache.h"
+#include "lf_protocols.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_EDGES   12000
+#define SPAN        48000  // Cycles of signal synthesized per capture (past RAWCAP_WINDOW)
+#define LEAD_IN     5000   // Idle field before the tag arrives
+#define GRID        2      // Front end resolution (cycles per processed sample)
+#define US_PER_CYCLE 8.0
+#define FUZZ_BLOBS  20000
+#define RANDOM_MAX  512    // Widest random run (cycles)
+
+typedef enum { FOB_EM4100, FOB_HID, FOB_JITTER, FOB_RANDOM, FOB_KINDS } Fob;
+
+typedef struct {
+    const char *name;
+    uint8_t jitter;         // +- cycles added to every edge
+    float max_bytes_per_run;
+} FobSpec;
+
+static const FobSpec fobs[FOB_KINDS] = {
+    { "EM4100",        0, 1.0f },
+    { "HID",           0, 1.0f },
+    { "EM4100 jitter", 3, 1.0f },
+    { "random widths", 0, 2.0f }, // Deltas past 63 cycles: never worse than 16-bit runs
+};
+
+typedef struct {
+    uint32_t ideal[MAX_EDGES];  // Edge times of the fob
+    uint32_t seen[MAX_EDGES];   // As the front end reports them: jittered, on its grid
+    uint16_t n;
+    uint8_t first_level;        // Level after the first edge
+} Edges;
+
+// --- SYNTHETIC FOBS ---
+
+/* Envelope level of a tag for carrier cycle t (phase continuous FSK) */
+static uint8_t Tag_Level(const LfProtocol *p, const uint8_t *bits, uint8_t n, uint32_t t, uint32_t *phase) {
+    uint32_t in_bit = t % p->bit_cycles;
+    uint8_t b = bits[(t / p->bit_cycles) % n];
+
+    if (p->modulation == LF_MOD_ASK_MANCHESTER) return (in_bit < p->bit_cycles / 2u) ? b : !b;
+
+    uint32_t period = b ? p->sub_b : p->sub_a; // 1/40 cycle steps: both periods divide 40
+    uint8_t level = *phase < 20;
+    *phase = (*phase + 40 / period) % 40;
+    return level;
+}
+
+static uint8_t Fob_Bits(Fob f, const LfProtocol **p, uint8_t *bits) {
+    LfFrame id;
+    memset(&id, 0, sizeof(id));
+    if (f == FOB_HID) {
+        *p = LF_Protocol_Find(LF_PROTO_HID);
+        for (int i = 0; i < 26; i++) LF_Frame_PutBit(&id, Rand() & 1u);
+    } else {
+        *p = LF_Protocol_Find(LF_PROTO_EM4100);
+        for (int i = 0; i < 40; i++) LF_Frame_PutBit(&id, Rand() & 1u);
+    }
+    return (*p)->encode(&id, bits);
+}
+
+static void Synthesize(Fob f, Edges *e) {
+    const uint8_t jitter = fobs[f].jitter;
+    e->n = 0;
+
+    if (f == FOB_RANDOM) {
+        uint32_t t = 0;
+        e->first_level = Rand() & 1u;
+        while (t < SPAN && e->n < MAX_EDGES) {
+            e->ideal[e->n++] = t;
+            t += GRID * (1 + Rand() % (RANDOM_MAX / GRID)); // Enough runs for the window
+        }
+    } else {
+        const LfProtocol *p;
+        uint8_t bits[LF_MAX_FRAME_BITS];
+        uint8_t n = Fob_Bits(f, &p, bits);
+        uint32_t phase = 0, start = Rand() % (n * p->bit_cycles); // Arrives mid-frame
+        uint8_t level = Tag_Level(p, bits, n, start, &phase);
+
+        e->first_level = level;
+        e->ideal[e->n++] = 0;
+        for (uint32_t t = 1; t < SPAN && e->n < MAX_EDGES; t++) {
+            uint8_t next = Tag_Level(p, bits, n, start + t, &phase);
+            if (next != level) e->ideal[e->n++] = t;
+            level = next;
+        }
+    }
+
+    // Jitter, then the nearest sample of the grid
+    for (uint16_t i = 0; i < e->n; i++) {
+        int32_t t = (int32_t)e->ideal[i] + LEAD_IN;
+        if (jitter && i) t += (int32_t)(Rand() % (2u * jitter + 1)) - jitter;
+        e->seen[i] = (uint32_t)((t + GRID / 2) / GRID * GRID) - LEAD_IN;
+    }
+    for (uint16_t i = 1; i < e->n; i++) CHECK(e->seen[i] > e->seen[i - 1]);
+}
+
+static uint8_t Level(const Edges *e, uint16_t run) {
+    return e->first_level ^ (run & 1u);
+}
+
+static uint16_t Width(const Edges *e, uint16_t run) {
+    return (uint16_t)(e->seen[run + 1] - e->seen[run]);
+}
+
+/* Idle field, then the fob's runs until the capture completes; returns the
+   runs fed (the last one may have completed it without being recorded) */
+static uint16_t Feed(RawCapture *rc, const Edges *e, uint16_t runs, uint8_t tag_leaves) {
+    Rawcap_Begin(rc);
+    Rawcap_Feed(rc, !e->first_level, LEAD_IN);
+    for (uint16_t k = 0; k < runs; k++) {
+        if (Rawcap_Feed(rc, Level(e, k), Width(e, k))) return k + 1;
+    }
+    if (tag_leaves) Rawcap_Feed(rc, Level(e, runs), LEAD_IN);
+    return runs;
+}
+
+/* Reads a whole blob; returns the run count (0 on a header error) */
+static uint16_t Read_All(const uint8_t *blob, uint16_t len, uint8_t *levels, uint16_t *widths, uint16_t cap) {
+    RawReader r;
+    uint16_t n = 0;
+    if (!Rawcap_Open(&r, blob, len)) return 0;
+    while (n < cap && Rawcap_Next(&r, &levels[n], &widths[n])) n++;
+    return n;
+}
+
+// --- ROUND TRIP AND SIZE ---
+
+static uint8_t levels[MAX_EDGES];
+static uint16_t widths[MAX_EDGES];
+
+static void Check_Round_Trip(Fob f, Edges *e, RawCapture *rc) {
+    uint16_t len, fed = Feed(rc, e, e->n - 1, 0);
+    const uint8_t *blob = Rawcap_Blob(rc, &len);
+    uint16_t n = Read_All(blob, len, levels, widths, MAX_EDGES);
+    uint32_t cycles = 0, bad = 0;
+
+    CHECKF(Rawcap_IsDone(rc), "%s: capture not finished after %u runs", fobs[f].name, fed);
+    CHECKF(n == rc->runs && n == (blob[2] | blob[3] << 8), "%s: %u runs read, %u recorded",
+           fobs[f].name, n, rc->runs);
+    for (uint16_t k = 0; k < n; k++) {
+        if (levels[k] != Level(e, k) || widths[k] != Width(e, k)) bad++;
+        cycles += widths[k];
+    }
+    CHECKF(bad == 0, "%s: %u of %u runs differ", fobs[f].name, bad, n);
+    CHECK(len <= RAWCAP_MAX_BYTES);
+
+    // It ends on the window or on a full buffer, never early
+    uint8_t full = len + 3 > RAWCAP_MAX_BYTES;
+    uint8_t window = n < fed && cycles + Width(e, n) >= RAWCAP_WINDOW;
+    CHECKF(full || window, "%s: stopped after %u runs, %lu cycles, %u bytes", fobs[f].name, n,
+           (unsigned long)cycles, len);
+
+    // Same again read twice: Rewind starts over
+    RawReader r;
+    uint8_t lv;
+    uint16_t w, again = 0;
+    Rawcap_Open(&r, blob, len);
+    while (Rawcap_Next(&r, &lv, &w)) again++;
+    Rawcap_Rewind(&r);
+    CHECK(Rawcap_Next(&r, &lv, &w) && lv == levels[0] && w == widths[0] && again == n);
+
+    float per_run = (float)(len - RAWCAP_HEADER_LEN) / n;
+    CHECKF(per_run <= fobs[f].max_bytes_per_run, "%s: %.2f bytes per run", fobs[f].name, per_run);
+    printf("rawcap: %-13s %4u runs in %4u bytes, %.2f bytes/run (%.1fx vs 16-bit runs), %5.1f ms held%s\n",
+           fobs[f].name, n, len, per_run, 2.0f / per_run, cycles * US_PER_CYCLE / 1000,
+           full ? " (buffer full)" : "");
+}
+
+/* The tag leaving ends the capture with everything it sent; noise is dropped */
+static void Check_Endings(void) {
+    static RawCapture rc;
+    static Edges e;
+    uint16_t len;
+
+    Synthesize(FOB_EM4100, &e);
+    Feed(&rc, &e, 100, 1);
+    CHECK(Rawcap_IsDone(&rc) && rc.runs == 100);
+    const uint8_t *blob = Rawcap_Blob(&rc, &len);
+    CHECK(Read_All(blob, len, levels, widths, MAX_EDGES) == 100 && widths[99] == Width(&e, 99));
+
+    // Fewer than RAWCAP_MIN_RUNS: keeps waiting, and the next tag is captured whole
+    Feed(&rc, &e, RAWCAP_MIN_RUNS - 2, 1);
+    CHECK(!Rawcap_IsDone(&rc));
+    for (uint16_t k = 0; k < 50; k++) Rawcap_Feed(&rc, Level(&e, k), Width(&e, k));
+    Rawcap_Feed(&rc, Level(&e, 50), LEAD_IN);
+    CHECK(Rawcap_IsDone(&rc) && rc.runs == 50);
+
+    // Two runs of the same level are one run
+    Rawcap_Begin(&rc);
+    for (uint16_t k = 0; k < 40; k++) Rawcap_Feed(&rc, k & 1u, 30);
+    Rawcap_Feed(&rc, 1, 30);
+    Rawcap_Feed(&rc, 0, LEAD_IN);
+    blob = Rawcap_Blob(&rc, &len);
+    uint16_t n = Read_All(blob, len, levels, widths, MAX_EDGES);
+    CHECK(n == 40 && widths[38] == 30 && widths[39] == 60 && levels[39] == 1);
+}
+
+// --- DAMAGED BLOBS ---
+
+/* Every cut of a real blob reads as a prefix of it, then stops */
+static void Check_Truncated(const uint8_t *blob, uint16_t len) {
+    static uint8_t ref_levels[MAX_EDGES];
+    static uint16_t ref_widths[MAX_EDGES];
+    uint16_t total = Read_All(blob, len, ref_levels, ref_widths, MAX_EDGES);
+    uint32_t bad = 0;
+
+    for (uint16_t cut = 0; cut < len; cut++) {
+        uint8_t *copy = malloc(cut ? cut : 1); // Exact size: ASan sees any read past the cut
+        memcpy(copy, blob, cut);
+        uint16_t n = Read_All(copy, cut, levels, widths, MAX_EDGES);
+        if (cut < RAWCAP_HEADER_LEN && n) bad++;
+        if (n >= total) bad++;
+        for (uint16_t k = 0; k < n; k++) {
+            if (levels[k] != ref_levels[k] || widths[k] != ref_widths[k]) {
+                bad++;
+                break;
+            }
+        }
+        free(copy);
+    }
+    CHECKF(bad == 0, "%lu truncated blobs read wrong", (unsigned long)bad);
+}
+
+static void Check_Malformed(void) {
+    static const struct {
+        const char *what;
+        uint8_t bytes[12];
+        uint8_t len;
+        uint8_t opens, reads;
+    } cases[] = {
+        { "short header",        { RAWCAP_FORMAT, 0, 1 },                            3, 0, 0 },
+        { "unknown format",      { RAWCAP_FORMAT + 1, 0, 1, 0, 0x40 },               5, 0, 0 },
+        { "no runs",             { RAWCAP_FORMAT, 0, 0, 0, 0x40 },                   5, 0, 0 },
+        { "varint too long",     { RAWCAP_FORMAT, 0, 1, 0, 0x80, 0x80, 0x80, 0x80, 0x01 }, 9, 1, 0 },
+        { "zero width",          { RAWCAP_FORMAT, 0, 2, 0, 0x40, 0x00 },             6, 1, 1 },
+        { "negative width",      { RAWCAP_FORMAT, 0, 3, 0, 0x40, 0x40, 0x81, 0x01 }, 8, 1, 2 },
+        { "width over 16 bits",  { RAWCAP_FORMAT, 1, 1, 0, 0xC0, 0xC5, 0x08 },       7, 1, 0 },
+        { "count past the data", { RAWCAP_FORMAT, 1, 9, 0, 0x40, 0x40 },             6, 1, 2 },
+    };
+    RawReader r;
+    uint8_t lv;
+    uint16_t w;
+
+    CHECK(!Rawcap_Open(&r, NULL, 10));
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint8_t *copy = malloc(cases[i].len);
+        memcpy(copy, cases[i].bytes, cases[i].len);
+        uint8_t opens = Rawcap_Open(&r, copy, cases[i].len), reads = 0;
+        if (opens) {
+            while (Rawcap_Next(&r, &lv, &w)) reads++;
+        }
+        CHECKF(opens == cases[i].opens && reads == cases[i].reads, "%s: open %u, %u runs read",
+               cases[i].what, opens, reads);
+        free(copy);
+    }
+
+    // Random bytes behind a valid header: bounded, sane widths, repeatable
+    uint32_t bad = 0;
+    for (uint32_t k = 0; k < FUZZ_BLOBS; k++) {
+        uint16_t len = RAWCAP_HEADER_LEN + Rand() % 60;
+        uint8_t *blob = malloc(len);
+        blob[0] = RAWCAP_FORMAT;
+        for (uint16_t i = 1; i < len; i++) blob[i] = (uint8_t)Rand();
+        blob[3] = 0;
+        if (Rawcap_Open(&r, blob, len)) {
+            uint16_t n = 0;
+            uint32_t sum = 0;
+            while (Rawcap_Next(&r, &lv, &w)) {
+                if (w == 0 || lv != ((blob[1] ^ n) & 1u)) bad++;
+                sum += w;
+                n++;
+            }
+            if (n > r.total) bad++;
+            Rawcap_Rewind(&r);
+            while (Rawcap_Next(&r, &lv, &w)) sum -= w;
+            if (sum) bad++;
+        }
+        free(blob);
+    }
+    CHECKF(bad == 0, "%lu random blobs misread", (unsigned long)bad);
+}
+
+// --- REPLAY TIMELINE ---
+
+/* The emulation timeline of the capture: same runs, and edges where the fob had them */
+static void Check_Replay(Fob f, const Edges *e, const RawCapture *rc) {
+    static uint8_t payload[PAYLOAD_HEADER_LEN + RAWCAP_MAX_BYTES];
+    LfFrame none;
+    WaveTimeline tl;
+    uint16_t len;
+    const uint8_t *blob = Rawcap_Blob(rc, &len);
+    uint16_t n = Read_All(blob, len, levels, widths, MAX_EDGES);
+
+    memset(&none, 0, sizeof(none));
+    CHECK(Payload_Build(payload, sizeof(payload), &none, blob, len));
+    CHECKF(Wave_Build(payload, &tl), "%s: no timeline", fobs[f].name);
+    if (!tl.runs) return;
+
+    // An odd capture loops with its last run merged into the first
+    uint16_t merged = (n & 1u) ? widths[n - 1] : 0;
+    CHECKF(tl.runs == (n & ~1u) && tl.first_level == levels[0], "%s: %u timeline runs for %u captured",
+           fobs[f].name, tl.runs, n);
+    uint32_t bad = 0;
+    for (uint16_t i = 0; i < tl.runs; i++) {
+        uint32_t want = (uint32_t)(widths[i] + (i ? 0 : merged)) * WAVE_TICKS_PER_CYCLE;
+        if (tl.arr[i] + 1u != want) bad++;
+    }
+    CHECKF(bad == 0, "%s: %u timeline periods differ from the capture", fobs[f].name, bad);
+
+    // Edge k of the replay against the fob's edge k, both from the first edge
+    double worst = 0, sq = 0, last = 0;
+    int64_t t = -(int64_t)merged * WAVE_TICKS_PER_CYCLE;
+    for (uint16_t k = 1; k < tl.runs; k++) {
+        t += tl.arr[k - 1] + 1;
+        double err = (double)t / WAVE_TICKS_PER_CYCLE - (double)(e->ideal[k] - e->ideal[0]);
+        if (fabs(err) > worst) worst = fabs(err);
+        sq += err * err;
+        last = err;
+    }
+    double rms = sqrt(sq / (tl.runs - 1));
+
+    // The grid and the jitter at both ends of a span; nothing accumulates
+    double bound = 2.0 * fobs[f].jitter + GRID;
+    CHECKF(worst <= bound, "%s: replay edge off by %.1f cycles, bound %.1f", fobs[f].name, worst, bound);
+    printf("rawcap: %-13s replay edges vs the fob: %4.1f us max, %4.1f us rms, %4.1f us at the last edge\n",
+           fobs[f].name, worst * US_PER_CYCLE, rms * US_PER_CYCLE, last * US_PER_CYCLE);
+}
+
+int main(void) {
+    static RawCapture rc;
+    static Edges e;
+
+    Test_Seed(0xD3A2646Cu);
+    for (int f = 0; f < FOB_KINDS; f++) {
+        Synthesize(f, &e);
+        Check_Round_Trip(f, &e, &rc);
+        Check_Replay(f, &e, &rc);
+        if (f == FOB_JITTER) {
+            uint16_t len;
+            const uint8_t *blob = Rawcap_Blob(&rc, &len);
+            Check_Truncated(blob, len);
+        }
+    }
+    Check_Endings();
+    Check_Malformed();
+    TEST_END();
+}
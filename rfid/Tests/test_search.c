@@ -0,0 +1,212 @@
+/**
+  ******************************************************************************
+  * @file    test_search.c
+  * @brief   Incremental search against a brute-force matcher, and the
+  * per-keystroke benchmark at 2,000 entries.
+  * Random sessions of keystrokes and backspaces must give the same hit count
+  * and score for every entry as rescanning all names from scratch, also past
+  * the keystroke stamp wrap and with a full index. The benchmark types and
+  * corrects names from the set: no keystroke may read a name, and the worst
+  * one must stay within SEARCH_KEY_BUDGET_US.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "search.h"
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#define ENTRIES   2000
+#define NAME_MAX  10
+
+#define NAMED     (SEARCH_MAX_ENTRIES + 100) // Also some past the capacity
+
+static char names[NAMED][NAME_MAX + 1];
+static uint8_t empty[NAMED];
+static uint32_t reads; // Name accessor calls
+
+static const char* Name(uint16_t i) {
+    reads++;
+    return empty[i] ? NULL : names[i];
+}
+
+/* Names like the ones people give fobs: "Gate 12", "office3", "GARAGE" */
+static void Make_Names(void) {
+    static const char *words[] = { "gate", "Garage", "office", "Lab", "door", "BIKE", "shed",
+                                   "home", "car", "Gym", "work", "back", "front", "Pool" };
+    for (int i = 0; i < NAMED; i++) {
+        char *n = names[i];
+        int len = 0;
+        const char *w = words[Rand() % (sizeof(words) / sizeof(words[0]))];
+        while (*w && len < NAME_MAX) n[len++] = *w++;
+        if (len < NAME_MAX - 3 && Rand() % 2) n[len++] = ' ';
+        for (int d = Rand() % 4; d > 0 && len < NAME_MAX; d--) n[len++] = (char)('0' + Rand() % 10);
+        n[len] = '\0';
+        empty[i] = (Rand() % 16) == 0; // Deleted slots
+    }
+}
+
+// --- REFERENCE MATCHER ---
+
+static char Lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static uint8_t Brute_Score(const char *n, const char *q) {
+    size_t nl, ql = strlen(q);
+    if (n == NULL) return SEARCH_NONE;
+    nl = strlen(n);
+    for (size_t at = 0; at == 0 || at < nl; at++) {
+        size_t k = 0;
+        while (k < ql && at + k < nl && Lower(n[at + k]) == q[k]) k++;
+        if (k == ql) return at ? SEARCH_SUBSTRING : SEARCH_PREFIX;
+    }
+    const char *p = n;
+    for (size_t k = 0; k < ql; k++) {
+        while (*p && Lower(*p) != q[k]) p++;
+        if (!*p) return SEARCH_NONE;
+        p++;
+    }
+    return SEARCH_FUZZY;
+}
+
+static void Check_Against_Brute(const char *what) {
+    const char *q = Search_Query();
+    uint16_t count = 0;
+    int wrong = 0;
+
+    for (uint16_t i = 0; i < ENTRIES; i++) {
+        uint8_t want = Brute_Score(empty[i] ? NULL : names[i], q);
+        count += want != SEARCH_NONE;
+        if (Search_Score(i) != want && wrong++ == 0) {
+            printf("  '%s' vs \"%s\": score %u, want %u\n", names[i], q, Search_Score(i), want);
+        }
+    }
+    CHECKF(wrong == 0, "%s \"%s\": %d entries scored wrong", what, q, wrong);
+    CHECKF(Search_Count() == count, "%s \"%s\": count %u, want %u", what, q, Search_Count(), count);
+}
+
+static void Check_Sessions(void) {
+    static const char keys[] = "gaRoe 1b2ckfh";
+
+    Search_Begin(Name, ENTRIES);
+    Check_Against_Brute("begin");
+    for (int step = 0; step < 600; step++) {
+        uint16_t before = Search_Count();
+        if (strlen(Search_Query()) > 0 && Rand() % 3 == 0) {
+            Search_Pop();
+            Check_Against_Brute("pop");
+            continue;
+        }
+        reads = 0;
+        if (!Search_Push(keys[Rand() % (sizeof(keys) - 1)])) {
+            CHECK(strlen(Search_Query()) == SEARCH_MAX_QUERY);
+            continue;
+        }
+        CHECKF(reads == 0, "push read %u names (%u candidates before)", (unsigned)reads, before);
+        Check_Against_Brute("push");
+    }
+
+    // Names past the capacity are never matched
+    reads = 0;
+    Search_Begin(Name, NAMED);
+    CHECKF(reads <= 2 * SEARCH_MAX_ENTRIES, "begin read %u names", (unsigned)reads);
+    CHECK(Search_Score(SEARCH_MAX_ENTRIES + 10) == SEARCH_NONE);
+}
+
+/* Over 65,535 keystrokes in one session: the stamps wrap and are settled */
+static void Check_Wrap(void) {
+    static const char keys[] = "gaeo1";
+
+    Search_Begin(Name, ENTRIES);
+    Search_Push('g');
+    for (uint32_t k = 0; k < 70000; k++) {
+        if (strlen(Search_Query()) >= 4 || (strlen(Search_Query()) > 1 && Rand() % 2)) Search_Pop();
+        else Search_Push(keys[Rand() % (sizeof(keys) - 1)]);
+    }
+    Check_Against_Brute("wrapped");
+    Search_Pop();
+    Check_Against_Brute("wrapped pop");
+}
+
+/* 15 distinct characters per name: the index fills before the entries do */
+static const char* Long_Name(uint16_t i) {
+    return (i % 2) ? "ABCDEFGHIJKLMNO" : "abcdefghijklmno";
+}
+
+static void Check_Full_Index(void) {
+    uint16_t fit = SEARCH_MAX_POSTINGS / 15;
+
+    Search_Begin(Long_Name, SEARCH_MAX_ENTRIES);
+    CHECK(Search_Count() == fit);
+    Search_Push('c');
+    Search_Push('D');
+    CHECK(Search_Count() == fit);
+    CHECK(Search_Score(0) == SEARCH_SUBSTRING && Search_Score(fit - 1) == SEARCH_SUBSTRING);
+    CHECK(Search_Score(fit) == SEARCH_NONE);
+    Search_Push('o');
+    CHECK(Search_Score(1) == SEARCH_FUZZY);
+}
+
+// --- BENCHMARK ---
+
+static double Now_Us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void Benchmark(void) {
+    const int sessions = 2000;
+    double total_us = 0, worst_us = 0;
+    uint32_t keys = 0, total_reads = 0;
+    char worst_query[SEARCH_MAX_QUERY + 2] = "";
+
+    for (int s = 0; s < sessions; s++) {
+        const char *target = names[Rand() % ENTRIES];
+        Search_Begin(Name, ENTRIES);
+        for (const char *c = target; *c; c++) {
+            // Now and then a typo, corrected: the keystroke after it reuses levels
+            char key = (Rand() % 8) ? *c : 'x';
+            for (int typo = key != *c; typo >= 0; typo--) {
+                // Best of three of the same keystroke: the host's own interruptions excluded
+                double dt = 1e9;
+                reads = 0;
+                for (int run = 0; run < 3; run++) {
+                    if (run) Search_Pop();
+                    double t0 = Now_Us();
+                    Search_Push(typo ? key : *c);
+                    double t = Now_Us() - t0;
+                    if (t < dt) dt = t;
+                }
+                total_us += dt;
+                total_reads += reads;
+                keys++;
+                if (dt > worst_us) {
+                    worst_us = dt;
+                    strcpy(worst_query, Search_Query());
+                }
+                if (typo) Search_Pop();
+            }
+        }
+    }
+    printf("search: %u entries, %u keystrokes: %.2f us mean, %.2f us worst (\"%s\", host)\n",
+           ENTRIES, (unsigned)keys, total_us / keys, worst_us, worst_query);
+    printf("search: index %u bytes for %u entries\n",
+           (unsigned)(sizeof(uint16_t) * 97 + 4 * SEARCH_MAX_POSTINGS + 8 * SEARCH_MAX_ENTRIES),
+           (unsigned)SEARCH_MAX_ENTRIES);
+    CHECKF(total_reads == 0, "%u names read while typing", (unsigned)total_reads);
+    CHECKF(worst_us <= SEARCH_KEY_BUDGET_US, "worst keystroke %.1f us, budget %u us",
+           worst_us, SEARCH_KEY_BUDGET_US);
+}
+
+int main(void) {
+    Test_Seed(0x2545F491u);
+    Make_Names();
+    Check_Sessions();
+    Check_Wrap();
+    Check_Full_Index();
+    Benchmark();
+    TEST_END();
+}
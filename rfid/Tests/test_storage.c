@@ -0,0 +1,449 @@
+/**
+  ******************************************************************************
+  * @file    test_storage.c
+  * @brief   Power-loss injection for the storage log.
+  * Flash is a shared mapping at the real sector addresses with NOR semantics
+  * (programming only clears bits). Every boot runs in a forked child, so RAM
+  * starts from reset values while flash carries over, like a power cycle.
+  *
+  * A workload of single-item changes (signal, raw payload, delete, rename,
+  * calibration, tuning) runs one step at a time, each ending in
+  * Storage_Flush(). For the swept steps, power is cut before every flash word
+  * and every erase the step issues, starting from the image the previous step
+  * left: the cut word is half-programmed and a cut erase leaves the sector
+  * half-erased. The next boot must recover exactly the previous committed
+  * state, then redo the step and survive another reboot with the new state.
+  * Steps are swept while the log is young and whenever one compacts, so the
+  * cuts cover torn records, a missing record LOG_COMMIT, half-written
+  * compaction sectors, interrupted erases and a generation+1 header without
+  * its commit word.
+  *
+  * Upgrades: a baseline image (the fixed signal array and the calibration
+  * record in sector 7, no log) and a log of type-1 records must mount with
+  * every fob converted to a 32-bit payload and the calibration kept, with
+  * power cut at every operation of the first commit.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "storage.h"
+#include "payload.h"
+#include "touch.h"
+#include "events.h"
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define LOG_BASE        STORAGE_SECTOR_A_ADDR
+#define FLASH_BYTES     (2 * STORAGE_SECTOR_SIZE)
+#define RAW_BYTES       960   // Raw payloads fill the log quickly
+#define SWEEP_FIRST     24    // Steps swept while the log is young
+#define MAX_STEPS       6000
+#define COMPACTIONS     4     // Stop once this many have been swept
+
+// Where power went (child exit code = CUT_EXIT + cut kind)
+enum { CUT_RECORD, CUT_RECORD_COMMIT, CUT_COMPACT, CUT_HEADER_COMMIT, CUT_ERASE, CUT_KINDS };
+#define CUT_EXIT 40
+
+static const char *cut_names[CUT_KINDS] = {
+    "torn record", "record without LOG_COMMIT", "half-written compaction sector",
+    "header gen+1 without commit", "interrupted erase"
+};
+
+// --- RAM STATE SNAPSHOT (what the log must bring back) ---
+typedef struct {
+    uint8_t active[MAX_SLOTS];
+    char name[MAX_SLOTS][NAME_LEN + 1];
+    uint16_t len[MAX_SLOTS];
+    uint8_t blob[MAX_SLOTS][PAYLOAD_SMALL_MAX + RAW_BYTES];
+    uint8_t calibrated;
+    TouchCalib cal;
+    uint16_t tune;
+} Snapshot;
+
+// Shared with the children
+typedef struct {
+    Snapshot boot;       // State found by the last boot
+    Snapshot done;       // State after the last completed step
+    uint32_t ops;        // Flash words and erases issued by the last step
+    uint8_t compacted;   // Last step wrote a sector header
+} Shared;
+
+static Shared *sh;
+static uint8_t *flash;
+static long budget = -1; // Flash operations left before the cut, -1 = no cut
+
+// --- STUBS ---
+
+Signal signal_db[MAX_SLOTS];
+static TouchCalib calib;
+static uint8_t calibrated;
+static uint16_t carrier_arr;
+
+void Touch_SetCalibration(const TouchCalib *cal) { calib = *cal; calibrated = 1; }
+const TouchCalib* Touch_GetCalibration(void) { return &calib; }
+void Touch_LoadDefaultCalibration(void) { memset(&calib, 0, sizeof(calib)); calibrated = 0; }
+uint8_t Touch_IsCalibrated(void) { return calibrated; }
+uint8_t RF_Frontend_SetCarrierArr(uint16_t arr) { carrier_arr = arr; return 1; }
+uint8_t Events_Post(EventType type, uint16_t arg) { return 1; }
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) { return HAL_OK; }
+HAL_StatusTypeDef HAL_FLASH_Lock(void) { return HAL_OK; }
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t pre, uint32_t sub) {}
+void HAL_NVIC_EnableIRQ(IRQn_Type irq) {}
+
+/* Header check as Storage_Init does it */
+static uint8_t Header_Gen(uint32_t base, uint32_t *gen) {
+    const uint32_t *h = (const uint32_t *)(uintptr_t)base;
+    *gen = h[1];
+    return h[0] == LOG_SECTOR_MAGIC && h[2] == LOG_COMMIT;
+}
+
+/* Writes into a sector that is not the mounted log belong to a compaction */
+static uint8_t Is_Mounted(uint32_t base) {
+    uint32_t gen, other_gen;
+    uint8_t valid = Header_Gen(base, &gen);
+    uint8_t other = Header_Gen(base ^ STORAGE_SECTOR_SIZE, &other_gen);
+    return valid && (!other || gen > other_gen);
+}
+
+static uint8_t Cut_Kind(uint32_t addr, uint32_t data) {
+    uint32_t base = addr & ~(uint32_t)(STORAGE_SECTOR_SIZE - 1);
+    if (data == LOG_COMMIT && addr == base + 8) return CUT_HEADER_COMMIT;
+    if (!Is_Mounted(base)) return CUT_COMPACT;
+    return (data == LOG_COMMIT) ? CUT_RECORD_COMMIT : CUT_RECORD;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t type, uint32_t addr, uint64_t data) {
+    uint32_t *w = (uint32_t *)(uintptr_t)addr;
+    if (budget == 0) {
+        uint8_t kind = Cut_Kind(addr, (uint32_t)data);
+        *w &= (uint32_t)data | 0xFFFF0000u; // Power fails halfway through the word
+        _exit(CUT_EXIT + kind);
+    }
+    if (budget > 0) budget--;
+    sh->ops++;
+    if (data == LOG_SECTOR_MAGIC && (addr & (STORAGE_SECTOR_SIZE - 1)) == 0) sh->compacted = 1;
+    *w &= (uint32_t)data;
+    HAL_FLASH_EndOfOperationCallback(addr);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef *erase) {
+    uint8_t *base = flash + (erase->Sector == FLASH_SECTOR_6 ? 0 : STORAGE_SECTOR_SIZE);
+    if (budget == 0) {
+        memset(base, 0xFF, STORAGE_SECTOR_SIZE / 2);
+        _exit(CUT_EXIT + CUT_ERASE);
+    }
+    if (budget > 0) budget--;
+    sh->ops++;
+    memset(base, 0xFF, STORAGE_SECTOR_SIZE);
+    HAL_FLASH_EndOfOperationCallback(0xFFFFFFFFu);
+    return HAL_OK;
+}
+
+// --- WORKLOAD ---
+
+static void Take(Snapshot *s) {
+    memset(s, 0, sizeof(*s));
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        if (!signal_db[i].is_active) continue;
+        s->active[i] = 1;
+        memcpy(s->name[i], signal_db[i].name, NAME_LEN + 1);
+        if (signal_db[i].payload) {
+            s->len[i] = signal_db[i].payload_len;
+            memcpy(s->blob[i], signal_db[i].payload, s->len[i]);
+        }
+    }
+    s->calibrated = calibrated;
+    if (calibrated) s->cal = calib;
+    s->tune = carrier_arr;
+}
+
+static int Diff(const Snapshot *got, const Snapshot *want, char *why, size_t cap) {
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        if (got->active[i] != want->active[i]) {
+            return snprintf(why, cap, "slot %d active %u, want %u", i, got->active[i], want->active[i]);
+        }
+        if (!want->active[i]) continue;
+        if (strcmp(got->name[i], want->name[i])) {
+            return snprintf(why, cap, "slot %d named '%s', want '%s'", i, got->name[i], want->name[i]);
+        }
+        if (got->len[i] != want->len[i] || memcmp(got->blob[i], want->blob[i], want->len[i])) {
+            return snprintf(why, cap, "slot %d payload differs (%u bytes, want %u)", i, got->len[i], want->len[i]);
+        }
+    }
+    if (got->calibrated != want->calibrated || memcmp(&got->cal, &want->cal, sizeof(TouchCalib))) {
+        return snprintf(why, cap, "calibration differs");
+    }
+    if (got->tune != want->tune) return snprintf(why, cap, "tuning %u, want %u", got->tune, want->tune);
+    return 0;
+}
+
+static void Put_Signal(int slot, uint32_t id, uint16_t raw_len) {
+    static uint8_t raw[RAW_BYTES];
+    uint8_t blob[PAYLOAD_SMALL_MAX + RAW_BYTES];
+    LfFrame f;
+
+    memset(&f, 0, sizeof(f));
+    f.protocol = 1;
+    f.bit_len = 32;
+    for (int b = 0; b < 4; b++) f.data[b] = (uint8_t)(id >> (24 - 8 * b));
+    for (uint16_t i = 0; i < raw_len; i++) raw[i] = (uint8_t)(id * 31u + i);
+
+    snprintf(signal_db[slot].name, NAME_LEN + 1, "s%u", (unsigned)id);
+    signal_db[slot].is_active = 1;
+    uint16_t n = Payload_Build(blob, sizeof(blob), &f, raw_len ? raw : NULL, raw_len);
+    Storage_SetPayload(slot, blob, n);
+}
+
+/* Step k: one item changes, to a value that only depends on k */
+static void Apply(int k) {
+    int slot = (k * 7) % MAX_SLOTS;
+
+    switch (k % 8) {
+        case 0: case 1: case 2:
+            Put_Signal(slot, 0x1000u + k, 0);
+            break;
+        case 3:
+            Put_Signal(k % 2, 0x2000u + k, RAW_BYTES - k % 64);
+            break;
+        case 4:
+            signal_db[(k * 5) % MAX_SLOTS].is_active = 0;
+            Storage_UpdateSignal((k * 5) % MAX_SLOTS);
+            break;
+        case 5:
+            snprintf(signal_db[slot].name, NAME_LEN + 1, "r%d", k);
+            Storage_UpdateSignal(slot);
+            break;
+        case 6: {
+            TouchCalib cal = { 17 + k, -3, 100 * k, 2, -20 + k, 7 };
+            Touch_SetCalibration(&cal);
+            Storage_SaveCalibration();
+            break;
+        }
+        default:
+            carrier_arr = (uint16_t)(300 + k % 37);
+            Storage_SaveTuning(carrier_arr);
+            break;
+    }
+    Storage_Flush();
+}
+
+// --- BOOTS (each in its own process) ---
+
+typedef enum { BOOT_ONLY, BOOT_STEP, BOOT_FLUSH } BootMode;
+
+/* Power-on: mount, record the state, optionally run step k (or only commit
+   what the mount left dirty) with 'cut' ops allowed */
+static int Boot(BootMode mode, int k, long cut) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        Storage_Init();
+        Take(&sh->boot);
+        if (mode != BOOT_ONLY) {
+            sh->ops = 0;
+            sh->compacted = 0;
+            budget = cut;
+            if (mode == BOOT_STEP) Apply(k);
+            else Storage_Flush();
+            Take(&sh->done);
+        }
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// --- UPGRADES ---
+
+// Baseline layout: the fixed array at the start of sector 7...
+typedef struct {
+    char name[NAME_LEN + 1];
+    uint8_t is_active;
+    uint32_t protocol_data;
+} LegacySignal;
+
+// ...and the calibration record after it
+typedef struct {
+    uint32_t magic;
+    TouchCalib cal;
+    uint32_t checksum;
+} LegacyCalib;
+
+static const TouchCalib legacy_cal = { 4100, -12, -350000, 9, 3900, -210000 };
+
+static uint32_t Legacy_Data(int slot) {
+    return 0xC0DE0000u + (uint32_t)slot * 0x01010101u;
+}
+
+/* Bitwise CRC-32, independent of the table in storage.c */
+static uint32_t Crc32(uint32_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+/* What the import must produce: slots 0, 1, 3, 4, 6... with a 32-bit payload */
+static void Legacy_Want(Snapshot *want, uint8_t calibrated) {
+    memset(want, 0, sizeof(*want));
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        if (i % 3 == 2) continue;
+        want->active[i] = 1;
+        snprintf(want->name[i], NAME_LEN + 1, "OLD FOB %d", i);
+        want->len[i] = Payload_FromLegacy(want->blob[i], Legacy_Data(i));
+    }
+    want->calibrated = calibrated;
+    if (calibrated) want->cal = legacy_cal;
+}
+
+static void Put_Legacy_Signal(LegacySignal *s, int slot) {
+    memset(s, 0, sizeof(*s));
+    if (slot % 3 == 2) return; // Deleted: the baseline saved it zeroed
+    snprintf(s->name, NAME_LEN + 1, "OLD FOB %d", slot);
+    s->is_active = 1;
+    s->protocol_data = Legacy_Data(slot);
+}
+
+/* Sector 7 as the baseline firmware left it; sector 6 never used */
+static void Put_Legacy_Image(void) {
+    LegacySignal *old = (LegacySignal *)(uintptr_t)FLASH_STORAGE_ADDR;
+    LegacyCalib *rec = (LegacyCalib *)(uintptr_t)FLASH_CALIB_ADDR;
+    const uint32_t *words = (const uint32_t *)&legacy_cal;
+    uint32_t sum = CALIB_MAGIC;
+
+    memset(flash, 0xFF, FLASH_BYTES);
+    for (int i = 0; i < MAX_SLOTS; i++) Put_Legacy_Signal(&old[i], i);
+    for (uint32_t i = 0; i < sizeof(TouchCalib) / 4; i++) sum = (sum << 1 | sum >> 31) + words[i];
+    rec->magic = CALIB_MAGIC;
+    rec->cal = legacy_cal;
+    rec->checksum = sum;
+}
+
+/* A log in sector 6 written before payloads: one type-1 record per slot */
+static void Put_V1_Log(void) {
+    uint32_t *w = (uint32_t *)(uintptr_t)LOG_BASE;
+
+    memset(flash, 0xFF, FLASH_BYTES);
+    *w++ = LOG_SECTOR_MAGIC;
+    *w++ = 1;
+    *w++ = LOG_COMMIT;
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        LegacySignal s;
+        Put_Legacy_Signal(&s, i);
+        if (!s.is_active) continue;
+        uint32_t head = 1u | (uint32_t)i << 8 | (uint32_t)sizeof(s) << 16;
+        *w++ = head;
+        *w++ = Crc32(Crc32(0, &head, 4), &s, sizeof(s));
+        memcpy(w, &s, sizeof(s));
+        w += (sizeof(s) + 3) / 4;
+        *w++ = LOG_COMMIT;
+    }
+}
+
+/* Mounts the old data, then commits it with power cut at every operation:
+   each reboot must still find every fob (from the old layout or the log) */
+static void Check_Upgrade(const char *what, void (*put)(void), uint8_t calibrated) {
+    static uint8_t image[FLASH_BYTES];
+    Snapshot want;
+    char why[128];
+
+    Legacy_Want(&want, calibrated);
+    put();
+    memcpy(image, flash, FLASH_BYTES);
+    CHECK(Boot(BOOT_FLUSH, 0, -1) == 0);
+    CHECKF(!Diff(&sh->boot, &want, why, sizeof(why)), "%s, first boot: %s", what, why);
+    CHECKF(!Diff(&sh->done, &want, why, sizeof(why)), "%s, after the commit: %s", what, why);
+    uint32_t ops = sh->ops;
+    CHECKF(ops > 0, "%s: nothing committed, the imported slots are not dirty", what);
+
+    for (uint32_t n = 0; n < ops; n++) {
+        memcpy(flash, image, FLASH_BYTES);
+        int code = Boot(BOOT_FLUSH, 0, (long)n);
+        CHECKF(code >= CUT_EXIT && code < CUT_EXIT + CUT_KINDS, "%s cut %u: exit %d", what, n, code);
+        CHECK(Boot(BOOT_FLUSH, 0, -1) == 0);
+        CHECKF(!Diff(&sh->boot, &want, why, sizeof(why)), "%s, cut at op %u/%u: %s", what, n, ops, why);
+        CHECK(Boot(BOOT_ONLY, 0, -1) == 0);
+        CHECKF(!Diff(&sh->boot, &want, why, sizeof(why)), "%s, reboot after cut %u: %s", what, n, why);
+    }
+
+    // Committed: the log alone carries the fobs, and a step on top of it survives
+    memcpy(flash, image, FLASH_BYTES);
+    CHECK(Boot(BOOT_FLUSH, 0, -1) == 0);
+    CHECKF(Is_Mounted(LOG_BASE), "%s: the first log is not in sector 6", what);
+    memset(flash + STORAGE_SECTOR_SIZE, 0xFF, STORAGE_SECTOR_SIZE);
+    CHECK(Boot(BOOT_ONLY, 0, -1) == 0);
+    CHECKF(!Diff(&sh->boot, &want, why, sizeof(why)), "%s, from the log alone: %s", what, why);
+    CHECK(Boot(BOOT_STEP, 1, -1) == 0);
+    Snapshot next = sh->done;
+    CHECK(Boot(BOOT_ONLY, 0, -1) == 0);
+    CHECKF(!Diff(&sh->boot, &next, why, sizeof(why)), "%s, first step after the upgrade: %s", what, why);
+    printf("storage: %s: %d fobs imported, %u commit ops swept\n", what,
+           MAX_SLOTS - MAX_SLOTS / 3, (unsigned)ops);
+}
+
+int main(void) {
+    static uint8_t before[FLASH_BYTES], after[FLASH_BYTES];
+    static Snapshot prev, next;
+    unsigned cuts[CUT_KINDS] = { 0 };
+    int compactions = 0, swept = 0;
+    char why[128];
+
+    sh = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    flash = mmap((void *)(uintptr_t)LOG_BASE, FLASH_BYTES, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (sh == MAP_FAILED || flash != (uint8_t *)(uintptr_t)LOG_BASE) {
+        perror("mmap");
+        return 1;
+    }
+    Check_Upgrade("baseline layout", Put_Legacy_Image, 1);
+    Check_Upgrade("type-1 log", Put_V1_Log, 0);
+
+    memset(flash, 0xFF, FLASH_BYTES); // Factory-fresh part, no log yet
+
+    for (int k = 0; k < MAX_STEPS && compactions < COMPACTIONS; k++) {
+        memcpy(before, flash, FLASH_BYTES);
+        CHECK(Boot(BOOT_STEP, k, -1) == 0);
+        CHECKF(!Diff(&sh->boot, &prev, why, sizeof(why)), "step %d, clean boot: %s", k, why);
+        next = sh->done;
+        uint32_t ops = sh->ops;
+        uint8_t compacted = sh->compacted;
+        memcpy(after, flash, FLASH_BYTES);
+
+        if (k < SWEEP_FIRST || compacted) {
+            swept++;
+            compactions += compacted;
+            for (uint32_t n = 0; n < ops; n++) {
+                memcpy(flash, before, FLASH_BYTES);
+                int code = Boot(BOOT_STEP, k, (long)n);
+                CHECKF(code >= CUT_EXIT && code < CUT_EXIT + CUT_KINDS, "step %d cut %u: exit %d", k, n, code);
+                if (code >= CUT_EXIT && code < CUT_EXIT + CUT_KINDS) cuts[code - CUT_EXIT]++;
+
+                // Back from the cut: the last committed state, then the step again
+                CHECK(Boot(BOOT_STEP, k, -1) == 0);
+                CHECKF(!Diff(&sh->boot, &prev, why, sizeof(why)), "step %d cut at op %u/%u (%s): %s",
+                       k, n, ops, cut_names[code - CUT_EXIT], why);
+                CHECKF(!Diff(&sh->done, &next, why, sizeof(why)), "step %d redo after cut %u: %s", k, n, why);
+                CHECK(Boot(BOOT_ONLY, k, -1) == 0);
+                CHECKF(!Diff(&sh->boot, &next, why, sizeof(why)), "step %d reboot after redo (cut %u): %s",
+                       k, n, why);
+            }
+            memcpy(flash, after, FLASH_BYTES);
+        }
+        prev = next;
+    }
+
+    printf("storage: %d steps swept, %d with a compaction\n", swept, compactions);
+    for (int i = 0; i < CUT_KINDS; i++) {
+        printf("storage: %6u cuts: %s\n", cuts[i], cut_names[i]);
+        CHECKF(cuts[i] > 0, "no cut landed on a %s", cut_names[i]);
+    }
+    CHECK(compactions == COMPACTIONS);
+    TEST_END();
+}
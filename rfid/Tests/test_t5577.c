@@ -0,0 +1,204 @@
+/**
+  ******************************************************************************
+  * @file    test_t5577.c
+  * @brief   T5577 commands and timelines against the ATA5577 datasheet.
+  * Downlink timing must sit inside the datasheet windows, and a tag-side
+  * model that measures the field-on time between gaps must read every
+  * timeline back as the command bits. Write and read commands must follow
+  * the opcode / password / lock / data / address layout bit for bit, and
+  * the card images must carry the block 0 words known to clone each
+  * protocol and the protocol's own frame.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "t5577.h"
+#include "lf_protocols.h"
+#include <string.h>
+
+static uint32_t Get_Word(const uint8_t *bits, uint8_t width) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < width; i++) v = (v << 1) | bits[i];
+    return v;
+}
+
+// --- DOWNLINK TIMING ---
+
+static void Check_Windows(void) {
+    CHECK(T5577_START_GAP >= 8 && T5577_START_GAP <= 50);
+    CHECK(T5577_WRITE_GAP >= 8 && T5577_WRITE_GAP <= 30);
+    CHECK(T5577_DATA_0 >= 16 && T5577_DATA_0 <= 31);
+    CHECK(T5577_DATA_1 >= 48 && T5577_DATA_1 <= 63);
+    CHECK(T5577_CMD_MAX == 2 + 32 + 1 + 32 + 3);
+}
+
+/* Tag side: gaps must be in window, field-on time between them gives the bit */
+static int Demodulate(const uint16_t *cycles, uint16_t n, uint8_t *bits) {
+    int nbits = 0;
+
+    if (n < 2 || n % 2 || cycles[0] < 8 || cycles[0] > 50) return -1;
+    for (uint16_t i = 1; i + 1 < n; i += 2) {
+        uint16_t on = cycles[i], gap = cycles[i + 1];
+        if (gap < 8 || gap > 30) return -1;
+        if (on >= 16 && on <= 31) bits[nbits++] = 0;
+        else if (on >= 48 && on <= 63) bits[nbits++] = 1;
+        else return -1;
+    }
+    // The tag needs the field back for longer than a 1 to end the command
+    return cycles[n - 1] > 63 ? nbits : -1;
+}
+
+static void Check_Timeline(void) {
+    uint8_t bits[T5577_CMD_MAX], back[T5577_CMD_MAX];
+    uint16_t cycles[T5577_TIMELINE_MAX];
+
+    for (int trial = 0; trial < 200; trial++) {
+        uint8_t nbits = (uint8_t)(1 + Rand() % T5577_CMD_MAX);
+        for (uint8_t i = 0; i < nbits; i++) bits[i] = Rand() & 1;
+
+        uint16_t n = T5577_Timeline(bits, nbits, cycles, T5577_TIMELINE_MAX);
+        CHECKF(n == 2 + 2 * nbits, "%u bits: %u entries", nbits, n);
+        CHECKF(cycles[0] == T5577_START_GAP && cycles[n - 1] == T5577_TAIL, "%u bits: ends %u/%u",
+               nbits, cycles[0], cycles[n - 1]);
+        int got = Demodulate(cycles, n, back);
+        CHECKF(got == nbits && memcmp(bits, back, nbits) == 0, "%u bits: tag read %d", nbits, got);
+    }
+
+    // Too small a buffer is refused, not overrun
+    bits[0] = 1;
+    cycles[2] = 0xBEEF;
+    CHECK(T5577_Timeline(bits, 1, cycles, 3) == 0 && cycles[2] == 0xBEEF);
+    CHECK(T5577_Timeline(bits, 1, cycles, 4) == 4);
+}
+
+// --- COMMAND LAYOUT ---
+
+static void Check_Write(void) {
+    uint8_t bits[T5577_CMD_MAX + 1];
+    uint16_t cycles[T5577_TIMELINE_MAX];
+    const uint32_t password = 0x51243648;
+    const uint32_t data = 0xDEADBEEF;
+
+    for (uint8_t block = 0; block < T5577_MAX_BLOCKS; block++) {
+        // Opcode 1, page 0, lock 0, data MSB first, 3-bit address
+        uint8_t n = T5577_WriteCmd(bits, block, data, NULL);
+        CHECKF(n == 38, "write block %u: %u bits", block, n);
+        CHECK(bits[0] == 1 && bits[1] == 0);
+        CHECK(bits[2] == 0);
+        CHECK(Get_Word(&bits[3], 32) == data);
+        CHECK(Get_Word(&bits[35], 3) == block);
+
+        // Password mode: the password goes between the opcode and the lock bit
+        n = T5577_WriteCmd(bits, block, data, &password);
+        CHECKF(n == T5577_CMD_MAX, "password write block %u: %u bits", block, n);
+        CHECK(bits[0] == 1 && bits[1] == 0);
+        CHECK(Get_Word(&bits[2], 32) == password);
+        CHECK(bits[34] == 0);
+        CHECK(Get_Word(&bits[35], 32) == data);
+        CHECK(Get_Word(&bits[67], 3) == block);
+        CHECK(T5577_Timeline(bits, n, cycles, T5577_TIMELINE_MAX) == T5577_TIMELINE_MAX);
+    }
+}
+
+static void Check_Read(void) {
+    uint8_t bits[T5577_CMD_MAX];
+    const uint32_t password = 0x0BADF00D;
+
+    for (uint8_t block = 0; block < T5577_MAX_BLOCKS; block++) {
+        uint8_t n = T5577_ReadCmd(bits, block, NULL);
+        CHECKF(n == 6, "read block %u: %u bits", block, n);
+        CHECK(bits[0] == 1 && bits[1] == 0 && bits[2] == 0);
+        CHECK(Get_Word(&bits[3], 3) == block);
+
+        n = T5577_ReadCmd(bits, block, &password);
+        CHECKF(n == 38, "password read block %u: %u bits", block, n);
+        CHECK(Get_Word(&bits[2], 32) == password);
+        CHECK(bits[34] == 0);
+        CHECK(Get_Word(&bits[35], 3) == block);
+    }
+}
+
+// --- CARD IMAGES ---
+
+static LfFrame Id_Bits(uint64_t v, uint8_t n) {
+    LfFrame f = { 0 };
+    while (n--) LF_Frame_PutBit(&f, (v >> n) & 1u);
+    return f;
+}
+
+/* H10301: even parity over the top 12 bits, odd over the low 12 */
+static LfFrame H10301(uint8_t facility, uint16_t card) {
+    uint64_t v = ((uint64_t)facility << 17) | ((uint64_t)card << 1);
+    uint8_t even = 0, odd = 1;
+    for (uint8_t i = 1; i <= 12; i++) {
+        odd ^= (v >> i) & 1u;
+        even ^= (v >> (i + 12)) & 1u;
+    }
+    return Id_Bits(v | (uint64_t)even << 25 | odd, 26);
+}
+
+/* Block 0 must be the word clone tools use; the data blocks the raw frame */
+static void Check_Image(uint8_t proto, const LfFrame *id, uint32_t config, uint8_t want_blocks) {
+    const LfProtocol *p = LF_Protocol_Find(proto);
+    uint32_t blocks[T5577_MAX_BLOCKS];
+    uint8_t frame[LF_MAX_FRAME_BITS], back[LF_MAX_FRAME_BITS];
+    LfFrame read = { 0 };
+
+    uint8_t n = T5577_Blocks(p, id, blocks);
+    CHECKF(n == want_blocks, "%s: %u blocks", p->name, n);
+    if (n != want_blocks) return;
+    CHECKF(blocks[0] == config, "%s: config %08X, want %08X", p->name, (unsigned)blocks[0], (unsigned)config);
+
+    uint8_t len = p->encode(id, frame);
+    for (uint8_t i = 0; i < len; i++) back[i] = (blocks[1 + i / 32] >> (31 - i % 32)) & 1u;
+    CHECKF(memcmp(frame, back, len) == 0, "%s: data blocks differ from the frame", p->name);
+    CHECKF(p->validate(back, &read) && read.bit_len == id->bit_len &&
+           memcmp(read.data, id->data, sizeof(read.data)) == 0, "%s: image does not validate", p->name);
+}
+
+static void Check_Config(void) {
+    LfFrame em = Id_Bits(0x1234567890ULL, 40);
+    LfFrame hid = H10301(0x55, 1234);
+    LfProtocol p = *LF_Protocol_Find(LF_PROTO_EM4100);
+
+    Check_Image(LF_PROTO_EM4100, &em, 0x00148040, 3);  // Manchester RF/64, 2 data blocks
+    Check_Image(LF_PROTO_HID, &hid, 0x00107060, 4);    // FSK2a RF/50, 3 data blocks
+
+    // PSK1: subcarrier code 0 / 1 / 2 for RF/2 / RF/4 / RF/8
+    p.modulation = LF_MOD_PSK1;
+    p.bit_cycles = 32;
+    p.sub_a = 2;
+    CHECK(T5577_Config(&p, 2) == 0x00081040);
+    p.sub_a = 4;
+    CHECK(T5577_Config(&p, 2) == 0x00081440);
+    p.sub_a = 8;
+    CHECK(T5577_Config(&p, 2) == 0x00081840);
+    p.sub_a = 16;
+    CHECK(T5577_Config(&p, 2) == 0);
+
+    // Every rate code, then what the tag cannot do
+    static const uint16_t rates[] = { 8, 16, 32, 40, 50, 64, 100, 128 };
+    p = *LF_Protocol_Find(LF_PROTO_EM4100);
+    for (uint32_t code = 0; code < sizeof(rates) / sizeof(rates[0]); code++) {
+        p.bit_cycles = rates[code];
+        CHECKF(T5577_Config(&p, 1) == (0x00008020 | code << 18), "RF/%u", rates[code]);
+    }
+    p.bit_cycles = 48;
+    CHECK(T5577_Config(&p, 1) == 0);
+    p.bit_cycles = 64;
+    CHECK(T5577_Config(&p, 0) == 0);
+    CHECK(T5577_Config(&p, T5577_MAX_BLOCKS) == 0);
+    p = *LF_Protocol_Find(LF_PROTO_HID);
+    p.sub_b = 5; // FSK2a is fc/8 - fc/10 only
+    CHECK(T5577_Config(&p, 3) == 0);
+}
+
+int main(void) {
+    Test_Seed(0x85EBCA6Bu);
+    Check_Windows();
+    Check_Timeline();
+    Check_Write();
+    Check_Read();
+    Check_Config();
+    TEST_END();
+}
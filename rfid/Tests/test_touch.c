@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    test_touch.c
+  * @brief   Host test of the three-point affine calibration solver.
+  * Builds panels from known screen->raw maps (axis swap, mirror, rotation,
+  * skew), solves from the calibration targets, then checks the matrix
+  * against the analytic inverse and round-trips screen points through
+  * Touch_GetPixels() with the raw readings served by a stub XPT2046.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "touch.h"
+#include "spi.h"
+#include "fonts.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Same targets as the calibration page
+static const uint16_t targets[TOUCH_CALIB_POINTS][2] = {
+    {24, 48}, {216, 160}, {120, 296}
+};
+
+// --- STUBS ---
+
+SPI_HandleTypeDef hspi2;
+FontDef Font_7x10;
+static uint16_t panel_x, panel_y; // Raw reading the stub controller returns
+static uint8_t panel_down;
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin) {
+    return panel_down ? GPIO_PIN_RESET : GPIO_PIN_SET;
+}
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {}
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *h, const uint8_t *tx, uint8_t *rx,
+                                          uint16_t n, uint32_t timeout) {
+    uint16_t v = (uint16_t)(((tx[0] == 0x90) ? panel_x : panel_y) << 3);
+    rx[0] = 0;
+    rx[1] = v >> 8;
+    rx[2] = v & 0xFF;
+    return HAL_OK;
+}
+void LCD_FillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {}
+void LCD_WriteString(const char *str, uint16_t x, uint16_t y, FontDef font, uint16_t color,
+                     uint16_t bgcolor) {}
+
+// --- PANEL MODEL ---
+
+/* raw = m * (sx, sy, 1) */
+typedef struct {
+    const char *name;
+    double m[2][3];
+} Panel;
+
+static void To_Raw(const Panel *p, double sx, double sy, double *rx, double *ry) {
+    *rx = p->m[0][0] * sx + p->m[0][1] * sy + p->m[0][2];
+    *ry = p->m[1][0] * sx + p->m[1][1] * sy + p->m[1][2];
+}
+
+/* Rotates and shears the raw side of a panel map around the panel center */
+static Panel Distort(const char *name, const Panel *base, double deg, double shear) {
+    double c = cos(deg * M_PI / 180), s = sin(deg * M_PI / 180);
+    double r[2][2] = { { c - s * shear, -s }, { s + c * shear, c } };
+    double cx, cy;
+    Panel p = { name, { { 0 } } };
+
+    To_Raw(base, 120, 160, &cx, &cy);
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            p.m[i][j] = r[i][0] * base->m[0][j] + r[i][1] * base->m[1][j];
+        }
+        // Keep the panel center where it was
+        p.m[i][2] = (i ? cy : cx) - p.m[i][0] * 120 - p.m[i][1] * 160;
+    }
+    return p;
+}
+
+static void Check_Panel(const Panel *p) {
+    uint16_t raw[TOUCH_CALIB_POINTS][2];
+    TouchCalib cal;
+
+    for (int i = 0; i < TOUCH_CALIB_POINTS; i++) {
+        double rx, ry;
+        To_Raw(p, targets[i][0], targets[i][1], &rx, &ry);
+        raw[i][0] = (uint16_t)lround(rx);
+        raw[i][1] = (uint16_t)lround(ry);
+    }
+    CHECKF(Touch_SolveCalibration(targets, raw, &cal), "%s", p->name);
+
+    // The gains are the inverse of the panel map, in Q16
+    double det = p->m[0][0] * p->m[1][1] - p->m[0][1] * p->m[1][0];
+    double inv[2][2] = { {  p->m[1][1] / det, -p->m[0][1] / det },
+                         { -p->m[1][0] / det,  p->m[0][0] / det } };
+    int32_t got[2][2] = { { cal.a, cal.b }, { cal.d, cal.e } };
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            double want = inv[i][j] * (1 << TOUCH_CALIB_SHIFT);
+            // Targets are measured to the nearest raw count
+            CHECKF(fabs(got[i][j] - want) <= 2 + fabs(want) * 0.003, "%s k[%d][%d] %d want %.1f",
+                   p->name, i, j, (int)got[i][j], want);
+        }
+    }
+
+    // Round trip over the panel through the same path as a real touch
+    Touch_SetCalibration(&cal);
+    panel_down = 1;
+    int worst = 0;
+    for (int sy = 4; sy < 320; sy += 13) {
+        for (int sx = 4; sx < 240; sx += 11) {
+            double rx, ry;
+            uint16_t x, y;
+            To_Raw(p, sx, sy, &rx, &ry);
+            panel_x = (uint16_t)lround(rx);
+            panel_y = (uint16_t)lround(ry);
+            if (!Touch_GetPixels(&x, &y)) continue; // Edge filter
+            int e = abs(x - sx) > abs(y - sy) ? abs(x - sx) : abs(y - sy);
+            if (e > worst) worst = e;
+        }
+    }
+    CHECKF(worst <= 1, "%s round trip off by %d px", p->name, worst);
+}
+
+// --- DEGENERATE POINTS ---
+
+static void Check_Rejects(void) {
+    TouchCalib cal;
+
+    // Collinear raw readings (double tap on one line)
+    const uint16_t line[3][2] = { {500, 500}, {1500, 1500}, {3000, 3000} };
+    CHECK(!Touch_SolveCalibration(targets, line, &cal));
+
+    // The same reading three times
+    const uint16_t same[3][2] = { {2000, 2000}, {2000, 2000}, {2000, 2000} };
+    CHECK(!Touch_SolveCalibration(targets, same, &cal));
+
+    // A tiny raw span for the whole screen: gains past int16 (SMLAD operands)
+    const uint16_t tiny[3][2] = { {2000, 2000}, {2001, 2000}, {2000, 2001} };
+    CHECK(!Touch_SolveCalibration(targets, tiny, &cal));
+
+    // Gains are Q16, so |gain| must stay below 0.5 px per raw count
+    const uint16_t near[3][2] = { {24, 48}, {216, 48}, {24, 112} };
+    const uint16_t span_383[3][2] = { {1000, 1000}, {1383, 1000}, {1000, 1383} };
+    CHECK(!Touch_SolveCalibration(near, span_383, &cal)); // 192 / 383 px per count
+    const uint16_t span_385[3][2] = { {1000, 1000}, {1385, 1000}, {1000, 1385} };
+    CHECK(Touch_SolveCalibration(near, span_385, &cal));  // 192 / 385
+}
+
+int main(void) {
+    // Factory wiring: raw X along screen Y, raw Y inverted along screen X
+    const Panel stock = { "stock", { { 0, 3500.0 / 320, 200 }, { -3500.0 / 240, 0, 3800 } } };
+    const Panel mirrored = { "mirrored", { { 0, 3500.0 / 320, 200 }, { 3500.0 / 240, 0, 300 } } };
+    const Panel straight = { "straight", { { 3400.0 / 240, 0, 350 }, { 0, 3300.0 / 320, 400 } } };
+
+    Check_Panel(&stock);
+    Check_Panel(&mirrored);
+    Check_Panel(&straight);
+    Panel rot = Distort("rotated 4 deg", &stock, 4, 0);
+    Check_Panel(&rot);
+    Panel skew = Distort("skewed 0.06", &stock, 0, 0.06);
+    Check_Panel(&skew);
+    Panel both = Distort("rotated -7 deg, skewed -0.1", &straight, -7, -0.1);
+    Check_Panel(&both);
+    Check_Rejects();
+    TEST_END();
+}
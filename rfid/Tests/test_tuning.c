@@ -0,0 +1,198 @@
+/**
+  ******************************************************************************
+  * @file    test_tuning.c
+  * @brief   Antenna sweep and peak fit against a modeled RLC response.
+  * The coil is a driven resonator (random resonance, Q 15..90); the ADC samples it at
+  * the sweep's quadrature points. A full sweep through Tune_Feed() must land
+  * within 1.5 timer counts of the true peak without noise, and keep 99% of
+  * the best setting's amplitude with it. The sub-step vertex is checked on exact
+  * parabolas, and flat, weak or missing responses must give no result.
+  ******************************************************************************
+  */
+
+#include "test.h"
+#include "tuning.h"
+#include "rf_frontend.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define TRIALS     200
+#define BIAS       2048  // ADC mid-scale
+#define PEAK_AMPL  400   // ADC codes at resonance
+#define FIRST_ARR  (RF_CARRIER_ARR - TUNE_ARR_SPAN)
+#define LAST_ARR   (RF_CARRIER_ARR + TUNE_ARR_SPAN)
+
+static double Uniform(double lo, double hi) {
+    return lo + (hi - lo) * (Rand() % 100000) / 100000.0;
+}
+
+// --- COIL MODEL ---
+
+typedef struct {
+    double f0, q;
+    double ampl;   // At resonance
+    int noise;     // +- ADC codes on each level
+} Coil;
+
+/* Driven resonator: amplitude and phase lag at carrier period 'arr' */
+static double Response(const Coil *c, double arr, double *lag) {
+    double x = (RF_TIMER_CLK / (arr + 1)) / c->f0;
+    double re = 1 - x * x, im = x / c->q;
+    if (lag) *lag = atan2(im, re);
+    return c->ampl / (c->q * sqrt(re * re + im * im));
+}
+
+/* Carrier period of the highest amplitude, to 1/100 count */
+static double True_Peak(const Coil *c) {
+    double best = FIRST_ARR, best_a = 0;
+    for (double arr = FIRST_ARR; arr <= LAST_ARR; arr += 0.01) {
+        double a = Response(c, arr, NULL);
+        if (a > best_a) {
+            best_a = a;
+            best = arr;
+        }
+    }
+    return best;
+}
+
+/* Amplitude at the best whole timer count: the most any setting can give */
+static double Best_Setting(const Coil *c) {
+    double best_a = 0;
+    for (uint16_t arr = FIRST_ARR; arr <= LAST_ARR; arr++) {
+        double a = Response(c, arr, NULL);
+        if (a > best_a) best_a = a;
+    }
+    return best_a;
+}
+
+/* Runs a whole sweep the way main.c drives it: 1 ms loop passes */
+static uint16_t Sweep(const Coil *c, uint32_t *elapsed_ms) {
+    TuneSweep s;
+    uint32_t now = 1000;
+    uint16_t arr = 0, phase = 0;
+    int16_t level = BIAS;
+    uint8_t order_ok = 1, expect = 0;
+
+    Tune_Begin(&s, RF_CARRIER_ARR, now);
+    for (;;) {
+        TuneAction a = Tune_Feed(&s, ++now, level);
+        if (a == TUNE_ACT_APPLY) {
+            // Each step is measured at four points, in order
+            order_ok &= Tune_Arr(&s) == FIRST_ARR + (expect / 4) * TUNE_ARR_STEP;
+            order_ok &= Tune_Phase(&s) >= 1 && Tune_Phase(&s) <= Tune_Arr(&s);
+            expect++;
+            arr = Tune_Arr(&s);
+            phase = Tune_Phase(&s);
+        } else if (a == TUNE_ACT_RESTART) {
+            double lag, ampl = Response(c, arr, &lag);
+            double at = 2 * M_PI * phase / (arr + 1);
+            int noise = c->noise ? (int)(Rand() % (2 * c->noise + 1)) - c->noise : 0;
+            level = (int16_t)lrint(BIAS + ampl * cos(at - lag) + noise);
+        } else if (a == TUNE_ACT_DONE) {
+            break;
+        }
+    }
+    CHECKF(order_ok && expect == 4 * TUNE_POINTS, "sweep order broken after %u settings", expect);
+    CHECK(Tune_IsDone(&s));
+    if (elapsed_ms) *elapsed_ms = now - 1000;
+    return Tune_Result(&s);
+}
+
+static Coil Random_Coil(double q, int noise) {
+    Coil c = { 0, q, PEAK_AMPL, noise };
+    // Resonance somewhere inside the sweep, off the edge steps
+    c.f0 = RF_TIMER_CLK / (Uniform(FIRST_ARR + 4, LAST_ARR - 4) + 1);
+    return c;
+}
+
+// --- CHECKS ---
+
+static void Check_Resonators(void) {
+    // Under Q ~12 the response is too flat across the sweep to be a peak
+    static const double qs[] = { 15, 25, 40, 90 };
+    uint32_t elapsed = 0;
+
+    for (unsigned k = 0; k < sizeof(qs) / sizeof(qs[0]); k++) {
+        double worst_err = 0, worst_loss = 0;
+        for (int trial = 0; trial < TRIALS; trial++) {
+            Coil c = Random_Coil(qs[k], 0);
+            double truth = True_Peak(&c);
+            uint16_t got = Sweep(&c, &elapsed);
+            double err = fabs(got - truth);
+            CHECKF(got && err <= 1.5, "Q %.0f, peak %.2f: got %u", c.q, truth, got);
+            if (err > worst_err) worst_err = err;
+
+            // Noise: the fit may move, but the chosen setting keeps the amplitude
+            c.noise = 3;
+            got = Sweep(&c, NULL);
+            double loss = got ? 1 - Response(&c, got, NULL) / Best_Setting(&c) : 1;
+            CHECKF(loss < 0.01, "Q %.0f noisy, peak %.2f: got %u, %.1f%% down", c.q, truth, got, loss * 100);
+            if (loss > worst_loss) worst_loss = loss;
+        }
+        printf("tuning: Q %-3.0f worst %.2f counts exact, %.2f%% amplitude lost with noise\n",
+               qs[k], worst_err, worst_loss * 100);
+    }
+    printf("tuning: sweep takes %u ms\n", (unsigned)elapsed);
+}
+
+/* Exact parabola sampled at the steps: the vertex lands within rounding */
+static void Check_Vertex(void) {
+    uint32_t power[TUNE_POINTS];
+
+    for (uint8_t step = 1; step <= 3; step++) {
+        for (int off16 = -15; off16 <= 15; off16++) {
+            double vertex = 10 + off16 / 16.0; // In steps
+            for (uint8_t i = 0; i < TUNE_POINTS; i++) {
+                double d = i - vertex;
+                power[i] = (uint32_t)lrint(4e6 - 5e3 * d * d);
+            }
+            double want = FIRST_ARR + vertex * step;
+            uint16_t got = Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, step);
+            CHECKF(fabs(got - want) <= 0.5 + step / 256.0, "step %u, vertex %.3f: got %u",
+                   step, want, got);
+        }
+    }
+
+    // Peak on the edge: no neighbour to fit, the edge step itself
+    for (uint8_t i = 0; i < TUNE_POINTS; i++) power[i] = 1000000u - 20000u * i;
+    CHECK(Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2) == FIRST_ARR);
+    for (uint8_t i = 0; i < TUNE_POINTS; i++) power[i] = 400000u + 20000u * i;
+    CHECK(Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2) == FIRST_ARR + 2 * (TUNE_POINTS - 1));
+
+    // Flat top: the highest step, no sub-step shift past its neighbours
+    for (uint8_t i = 0; i < TUNE_POINTS; i++) power[i] = 200000;
+    power[9] = power[10] = power[11] = 1000000;
+    uint16_t got = Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2);
+    CHECKF(got >= FIRST_ARR + 18 && got <= FIRST_ARR + 22, "flat top: got %u", got);
+}
+
+static void Check_No_Peak(void) {
+    uint32_t power[TUNE_POINTS];
+
+    // Strong but flat: nothing to tune to
+    for (uint8_t i = 0; i < TUNE_POINTS; i++) power[i] = 1000000u + (Rand() % 20000);
+    CHECK(Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2) == 0);
+
+    // A clear peak, below the no-antenna threshold
+    for (uint8_t i = 0; i < TUNE_POINTS; i++) power[i] = (i == 16) ? 4u * TUNE_MIN_AMPL * TUNE_MIN_AMPL - 1 : 10;
+    CHECK(Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2) == 0);
+    power[16]++;
+    CHECK(Tune_FitPeak(power, TUNE_POINTS, FIRST_ARR, 2) == FIRST_ARR + 32);
+
+    // Swept end to end: no coil, a coil too weak to read, a coil damped flat
+    Coil none = { RF_CARRIER_HZ, 10, 0, 3 };
+    CHECK(Sweep(&none, NULL) == 0);
+    Coil weak = { RF_CARRIER_HZ, 10, TUNE_MIN_AMPL / 2, 2 };
+    CHECK(Sweep(&weak, NULL) == 0);
+    Coil damped = { RF_CARRIER_HZ, 0.3, PEAK_AMPL, 3 };
+    uint16_t got = Sweep(&damped, NULL);
+    CHECKF(got == 0, "Q 0.3: got %u", got);
+}
+
+int main(void) {
+    Test_Seed(0xC2B2AE35u);
+    Check_Vertex();
+    Check_No_Peak();
+    Check_Resonators();
+    TEST_END();
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Static worst-case stack estimate from the compiler's -fstack-usage output.
+
+Run by the post-build step from the build directory:
+
+    python3 ../Tools/stack_usage.py .
+
+Frames come from the .su files next to the objects, call edges from the
+disassembly listing (rfid.list, bl/b.w to another function). The deepest
+chain is searched from main and from every interrupt handler; since no
+interrupt preempts another (NVIC priority group 0), the budget is the main
+chain plus the deepest handler chain plus one exception frame.
+
+Static functions of the same name in several files share one entry (the
+largest frame). Library code built without -fstack-usage counts as 0 bytes
+and is listed. Function-pointer calls are resolved with INDIRECT below;
+any other one is reported as unresolved.
+
+The figures go into the build log and into the .stack_budget section that
+the linker script reserves (three zero words), patched in the ELF of the
+same build, so the diagnostics page always compares against the estimate of
+the image it runs. The ELF is only rewritten when the figures change.
+"""
+
+import glob
+import os
+import re
+import struct
+import sys
+
+# Exception entry with the FPU context (lazy stacking reserves it): 26 words
+EXCEPTION_FRAME = 104
+
+# Function-pointer calls: (caller, candidate callees), both regexes
+INDIRECT = [
+    (r'^Dsp_Run$',                 r'^Dsp_(DcBlock|Decimate|Slice)$'),
+    (r'^Check_Frame$',             r'^(Validate_\w+|Probe_Validate)$'),
+    (r'^(T5577_Blocks|Expand)$',   r'^Encode_\w+$'),
+    (r'^Row_Paint_Band$',          r'^List_Label$'),
+    (r'^(Index_Entry|Search_\w+)$', r'^Search_Name$'),
+]
+
+FUNC_RE = re.compile(r'^([0-9a-f]{8}) <([^>+]+)>:$')
+CALL_RE = re.compile(r'^\s*[0-9a-f]+:\s.*\t(bl|b\.w|b\.n|b)\t[0-9a-f]+ <([^>+]+)>$')
+ICALL_RE = re.compile(r'^\s*[0-9a-f]+:\s.*\tblx\tr\d+')
+
+
+def read_frames(build_dir):
+    frames = {}
+    for path in glob.glob(os.path.join(build_dir, '**', '*.su'), recursive=True):
+        with open(path) as f:
+            for line in f:
+                # ../Core/Src/ui.c:271:6:UI_Refresh<TAB>144<TAB>static
+                where, size, kind = line.rstrip('\n').split('\t')
+                name = where.rsplit(':', 1)[1]
+                frames[name] = max(frames.get(name, 0), int(size))
+    return frames
+
+
+def read_calls(listing):
+    calls, indirect, func = {}, set(), None
+    with open(listing, errors='replace') as f:
+        for line in f:
+            m = FUNC_RE.match(line)
+            if m:
+                func = m.group(2)
+                # Long-call veneers just jump to their target
+                v = re.match(r'^__(\w+)_veneer$', func)
+                calls.setdefault(func, set())
+                if v:
+                    calls[func].add(v.group(1))
+                continue
+            if func is None:
+                continue
+            m = CALL_RE.match(line)
+            if m and m.group(2) != func:
+                calls[func].add(m.group(2))
+            elif ICALL_RE.match(line):
+                indirect.add(func)
+    return calls, indirect
+
+
+def resolve_indirect(calls, indirect):
+    unresolved = set()
+    for caller in indirect:
+        targets = set()
+        for caller_re, callee_re in INDIRECT:
+            if re.match(caller_re, caller):
+                targets |= {f for f in calls if re.match(callee_re, f)}
+        if targets:
+            calls[caller] |= targets
+        else:
+            unresolved.add(caller)
+    return unresolved
+
+
+def deepest(root, frames, calls, memo, stack, recursive):
+    """(bytes, chain) of the deepest path from 'root'; cycles are cut."""
+    if root in memo:
+        return memo[root]
+    if root in stack:
+        recursive.add(root)
+        return 0, []
+    stack.add(root)
+    best = (0, [])
+    for callee in sorted(calls.get(root, ())):
+        cand = deepest(callee, frames, calls, memo, stack, recursive)
+        if cand[0] > best[0]:
+            best = cand
+    stack.discard(root)
+    memo[root] = (frames.get(root, 0) + best[0], [root] + best[1])
+    return memo[root]
+
+
+def patch_elf(path, values):
+    """Writes 'values' (uint32 each) into .stack_budget; True if they changed."""
+    with open(path, 'r+b') as f:
+        elf = bytearray(f.read())
+        if elf[:6] != b'\x7fELF\x01\x01':
+            sys.exit('stack_usage: %s is not a 32-bit little-endian ELF' % path)
+        shoff, = struct.unpack_from('<I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2E)
+        # Section header: name, type, flags, addr, offset, size, ...
+        header = lambda i: struct.unpack_from('<6I', elf, shoff + i * shentsize)
+        names = header(shstrndx)[4]
+        for i in range(shnum):
+            name, _, _, _, offset, size = header(i)
+            end = elf.index(b'\0', names + name)
+            if elf[names + name:end] != b'.stack_budget':
+                continue
+            data = struct.pack('<%uI' % len(values), *values)
+            if size != len(data):
+                sys.exit('stack_usage: .stack_budget is %u bytes, want %u' % (size, len(data)))
+            if elf[offset:offset + size] == data:
+                return False
+            f.seek(offset)
+            f.write(data)
+            return True
+    sys.exit('stack_usage: no .stack_budget section in %s (linker script)' % path)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit('usage: stack_usage.py BUILD_DIR')
+    build_dir = sys.argv[1]
+    # objdump listing of the artifact (objects.list is the linker's input list)
+    elfs = [e for e in glob.glob(os.path.join(build_dir, '*.elf'))
+            if os.path.exists(os.path.splitext(e)[0] + '.list')]
+    if not elfs:
+        sys.exit('stack_usage: no .elf listing in %s' % build_dir)
+
+    frames = read_frames(build_dir)
+    calls, indirect = read_calls(os.path.splitext(elfs[0])[0] + '.list')
+    unresolved = resolve_indirect(calls, indirect)
+
+    memo, recursive = {}, set()
+    main_size, main_chain = deepest('main', frames, calls, memo, set(), recursive)
+    handlers = [f for f in calls if re.match(r'^\w+_(IRQ)?Handler$', f) and f != 'Reset_Handler']
+    isr_size, isr_chain = 0, []
+    for h in handlers:
+        size, chain = deepest(h, frames, calls, memo, set(), recursive)
+        if size > isr_size:
+            isr_size, isr_chain = size, chain
+    isr_size += EXCEPTION_FRAME
+    total = main_size + isr_size
+
+    print('stack: main %u B: %s' % (main_size, ' > '.join(main_chain)))
+    print('stack: isr  %u B: %s (+%u frame)' % (isr_size, ' > '.join(isr_chain), EXCEPTION_FRAME))
+    print('stack: worst case %u B' % total)
+    no_frame = sorted(f for f in set(main_chain + isr_chain) if f not in frames)
+    if no_frame:
+        print('stack: no .su frame (counted as 0): ' + ', '.join(no_frame))
+    unresolved &= set(frames) # Library internals have no .su anyway
+    if unresolved:
+        print('stack: warning: unresolved function-pointer calls in ' + ', '.join(sorted(unresolved)))
+    if recursive:
+        print('stack: warning: recursion through ' + ', '.join(sorted(recursive)))
+    if patch_elf(elfs[0], (main_size, isr_size, total)):
+        print('stack: estimate written into %s' % elfs[0])
+
+
+if __name__ == '__main__':
+    main()